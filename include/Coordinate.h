@@ -6,18 +6,79 @@
 #define CHEESE_COORDINATE_H
 
 #include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace cheese {
-    extern std::vector<std::string> filenames;
+    struct Coordinate;
 
-    std::size_t getFileIndex(const std::string &filename);
-
-    struct Coordinate {
+    // A location once it has been decoded, this is only ever computed when a location gets printed
+    struct DecodedCoordinate {
+        std::size_t file_index;
         std::uint32_t line_number;
         std::uint32_t column_number;
+    };
+
+    // A single lexed buffer, occupying the offsets [base, base + contents.size()]
+    // The extra offset at the end is where the EoF token for the buffer lives
+    struct SourceRange {
         std::size_t file_index;
+        std::uint32_t base;
+        std::string contents;
+        std::vector<std::uint32_t> line_starts; // Built on the first decode into this range
+        bool released = false;
+
+        void compute_line_starts();
+    };
+
+    // Hands out a contiguous range of offsets for every buffer that gets lexed, so that a location can be a single
+    // 32 bit offset, which is then decoded back into a file/line/column pair whenever it is needed
+    // Every buffer ever added shares those 4 GiB of offsets, anything that keeps lexing for a long time (i.e. the build
+    // server) has to release the buffers it no longer needs, or reset the whole manager between generations
+    class SourceManager {
+        std::vector<std::string> filenames;
+        std::unordered_map<std::string, std::size_t> file_indices;
+        std::vector<SourceRange> ranges;
+        std::uint32_t next_base = 1; // Offset 0 is reserved for locations that don't point into any source
+    public:
+        std::size_t get_file_index(const std::string &filename);
+
+        const std::string &get_filename(std::size_t file_index) const;
+
+        // Registers a buffer under a file name, returning the offset of its first byte
+        std::uint32_t add_source(const std::string &filename, std::string_view contents);
+
+        // Drops the contents of the buffer containing an offset, locations into it still decode to its file but lose
+        // their line and column, the offsets themselves are only handed out again if it was the last buffer added
+        void release_source(std::uint32_t offset);
+
+        // Drops every buffer and starts handing out offsets from the beginning again, any location created before this
+        // is meaningless afterwards, file indices are kept
+        void reset();
+
+        // How many offsets have been handed out so far
+        [[nodiscard]] std::uint32_t used_offsets() const;
+
+        DecodedCoordinate decode(Coordinate location);
+
+        // Gets the full line of source a location points into, without the line terminator
+        std::optional<std::string_view> get_line(Coordinate location);
+
+    private:
+        SourceRange *find_range(std::uint32_t offset);
+    };
+
+    extern SourceManager source_manager;
+
+    std::size_t getFileIndex(const std::string &filename);
+
+    struct Coordinate {
+        std::uint32_t offset;
+
+        [[nodiscard]] DecodedCoordinate decode() const;
 
         std::string toString() const;
 
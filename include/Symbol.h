@@ -0,0 +1,58 @@
+#ifndef CHEESE_SYMBOL_H
+#define CHEESE_SYMBOL_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <ostream>
+
+namespace cheese {
+    // An interned string, identifiers get interned once by the lexer, and from then on comparing, ordering and hashing
+    // them is done on the id rather than the characters
+    // Symbols convert implicitly from and to strings so that they can be dropped in wherever a name was being used
+    struct Symbol {
+        std::uint32_t id = 0; // 0 is always the empty string
+
+        Symbol() = default;
+
+        Symbol(std::string_view text);
+
+        Symbol(const std::string &text) : Symbol(std::string_view{text}) {}
+
+        Symbol(const char *text) : Symbol(std::string_view{text}) {}
+
+        [[nodiscard]] const std::string &str() const;
+
+        operator const std::string &() const {
+            return str();
+        }
+
+        [[nodiscard]] bool empty() const {
+            return id == 0;
+        }
+
+        bool operator==(const Symbol &other) const = default;
+
+        auto operator<=>(const Symbol &other) const = default;
+    };
+
+    std::string operator+(const std::string &lhs, const Symbol &rhs);
+
+    std::string operator+(const Symbol &lhs, const std::string &rhs);
+
+    std::string operator+(const char *lhs, const Symbol &rhs);
+
+    std::string operator+(const Symbol &lhs, const char *rhs);
+
+    std::ostream &operator<<(std::ostream &os, const Symbol &symbol);
+}
+
+template<>
+struct std::hash<cheese::Symbol> {
+    std::size_t operator()(const cheese::Symbol &symbol) const noexcept {
+        return symbol.id;
+    }
+};
+
+#endif //CHEESE_SYMBOL_H
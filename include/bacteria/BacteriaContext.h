@@ -24,6 +24,9 @@ namespace cheese::bacteria {
         std::unordered_map<std::string, FunctionInfo> functions;
         std::unordered_map<std::string, VariableInfo> global_variables;
         std::size_t next_string_constant_name{0};
+        // LLVM uniques constants, so identical aggregates map to the same global
+        std::unordered_map<llvm::Constant *, llvm::GlobalVariable *> aggregate_constants;
+        std::size_t next_aggregate_constant_name{0};
         nodes::BacteriaProgram *program;
 
         void mark_references() override;
@@ -34,6 +37,8 @@ namespace cheese::bacteria {
 
         llvm::Value *get_string_constant(std::string constant); // This returns a ptr u8
 
+        llvm::GlobalVariable *get_aggregate_constant(llvm::Constant *constant, llvm::Align alignment);
+
     };
 }
 #endif //CHEESE_BACTERIACONTEXT_H
@@ -8,10 +8,15 @@
 #include "lexer/lexer.h"
 #include "../../external/json.hpp"
 #include "math/BigInteger.h"
+#include "Symbol.h"
+#include "util/TreeWriter.h"
 #include "BacteriaType.h"
 #include <memory>
+#include <ostream>
+#include <functional>
 #include <utility>
 #include <llvm/IR/Value.h>
+#include <llvm/Support/Alignment.h>
 
 namespace cheese::bacteria {
 
@@ -38,12 +43,19 @@ namespace cheese::bacteria {
             return get_textual_representation(0);
         }
 
-        virtual std::string get_textual_representation(int depth) = 0;
+        std::string get_textual_representation(int depth);
+
+        // Writes the textual form straight to the stream, nested nodes write into the same stream rather than
+        // building up their own strings
+        virtual void write_textual_representation(std::ostream &os, int depth) = 0;
 
         [[nodiscard]] virtual nlohmann::json as_json() const = 0;
 
         [[nodiscard]] virtual bool compare_json(const nlohmann::json &json) const = 0;
 
+        // Streams the same json form as as_json into the writer, without building the whole document in memory
+        virtual void write_json(util::TreeWriter &writer) const = 0;
+
         virtual void lower_top_level(BacteriaContext *ctx);
 
         virtual void gen_protos(BacteriaContext *ctx);
@@ -54,12 +66,26 @@ namespace cheese::bacteria {
 
         virtual llvm::Value *lower_address(ScopeContext &ctx);
 
+        // The alignment the address from lower_address is known to have, which is less than the natural alignment of
+        // the type for anything inside of a packed or explicitly laid out object, so every access through it uses this
+        virtual llvm::Align get_address_alignment(ScopeContext &ctx);
+
         virtual llvm::Value *lower_write(ScopeContext &ctx, WriteContext &writeContext);
 
+        // Works out the type of this node as an expression, lowering should go through get_cached_expr_type instead
         virtual TypePtr get_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program);
+
+        // The type of a node never changes once it has been curdled, so it is only worked out the first time it is
+        // asked for, rather than rewalking the whole subtree every time a parent needs it
+        TypePtr get_cached_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program);
+
+        TypePtr cached_expr_type = nullptr;
+
+        // Calls the visitor on each direct child of this node, the visitor is free to replace the child it is given
+        virtual void visit_children(const std::function<void(std::unique_ptr<BacteriaNode> &)> &visitor) {}
     };
 
-    void add_indentation(std::stringstream &ss, int indentation);
+    void add_indentation(std::ostream &os, int indentation);
 
     typedef std::unique_ptr<BacteriaNode> BacteriaPtr;
     typedef std::vector<BacteriaPtr> BacteriaList;
@@ -75,7 +101,7 @@ namespace cheese::bacteria {
 
     bool implicit_compare_value(const std::string &value);
 
-    bool compare_helper(const nlohmann::json &object, std::string name, bool value);
+    bool compare_helper(const nlohmann::json &object, const std::string &name, bool value);
 
     bool implicit_compare_value(bool value);
 
@@ -151,6 +177,29 @@ namespace cheese::bacteria {
     }
 
 
+    void stream_json(util::TreeWriter &writer, const std::string &name, const BacteriaPtr &value);
+
+    void stream_json(util::TreeWriter &writer, const std::string &name, const BacteriaList &value);
+
+    void stream_json(util::TreeWriter &writer, const std::string &name, const BacteriaDict &value);
+
+    void stream_json(util::TreeWriter &writer, const std::string &name, const math::BigInteger &value);
+
+    void stream_json(util::TreeWriter &writer, const std::string &name, const Symbol &value);
+
+    template<typename T>
+    void stream_json(util::TreeWriter &writer, const std::string &name, const T &value) {
+        if (implicit_compare_value(value)) return;
+        writer.key(name);
+        writer.value(value);
+    }
+
+    template<typename J>
+    void stream_json(util::TreeWriter &writer, const std::string &name, const std::optional<J> &value) {
+        if (implicit_compare_value(value)) return;
+        stream_json(writer, name, value.value());
+    }
+
     template<typename T, typename ...Ts>
     void implicit_compare_check(bool &success, T &arg, Ts &... args) {
         if (!implicit_compare_value(arg)) {
@@ -224,6 +273,34 @@ namespace cheese::bacteria {
         return result;
     }
 
+    template<size_t idx>
+    void stream_json_helper(util::TreeWriter &writer, const std::vector<std::string> &arg_names) {
+    }
+
+    template<size_t idx, typename T, typename... Ts>
+    void stream_json_helper(util::TreeWriter &writer, const std::vector<std::string> &arg_names, const T &arg,
+                            const Ts &... args) {
+        if (idx >= arg_names.size()) return;
+
+        stream_json(writer, arg_names[idx], arg);
+        stream_json_helper<idx + 1>(writer, arg_names, args...);
+    }
+
+    // The streaming counterpart to build_json, writing a node with the given type and members
+    template<typename ...Ts>
+    void stream_json_node(util::TreeWriter &writer, const std::string &type, const std::vector<std::string> &arg_names,
+                          const Ts &... args) {
+        bool all_implicit = true;
+        implicit_compare_check(all_implicit, args...);
+        if (all_implicit) {
+            writer.value(type);
+            return;
+        }
+        writer.begin_node(type);
+        stream_json_helper<0>(writer, arg_names, args...);
+        writer.end_object();
+    }
+
     struct FunctionArgument {
         TypePtr type;
         std::string name;
@@ -239,6 +316,8 @@ namespace cheese::bacteria {
 
     bool implicit_compare_value(const std::vector<FunctionArgument> &value);
 
+    void stream_json(util::TreeWriter &writer, const std::string &name, const std::vector<FunctionArgument> &value);
+
     template<>
     void cheese::bacteria::build_json<TypeList>(nlohmann::json &object, std::string name,
                                                 const TypeList &value);
@@ -249,6 +328,8 @@ namespace cheese::bacteria {
 
     bool implicit_compare_value(const TypeList &value);
 
+    void stream_json(util::TreeWriter &writer, const std::string &name, const TypeList &value);
+
 
 }
 
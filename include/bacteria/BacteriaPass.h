@@ -0,0 +1,79 @@
+#ifndef CHEESE_BACTERIAPASS_H
+#define CHEESE_BACTERIAPASS_H
+
+#include <memory>
+#include <vector>
+#include "bacteria/nodes/receiver_nodes.h"
+
+namespace cheese::bacteria {
+    // A transformation over a whole bacteria program, run between curdling and lowering
+    // These exist to shrink the IR before LLVM ever sees it, which is far cheaper than having LLVM clean it up
+    struct BacteriaPass {
+        virtual ~BacteriaPass() = default;
+
+        [[nodiscard]] virtual const char *name() const = 0;
+
+        // Returns whether the program was changed
+        virtual bool run(nodes::BacteriaProgram *program) = 0;
+    };
+
+    // Folds binary operations and casts on literals into a single literal
+    struct ConstantFoldingPass : BacteriaPass {
+        [[nodiscard]] const char *name() const override {
+            return "constant-folding";
+        }
+
+        bool run(nodes::BacteriaProgram *program) override;
+    };
+
+    // Replaces ifs, whiles, counted loops and switches on a literal by whichever branch is actually taken
+    struct DeadBranchEliminationPass : BacteriaPass {
+        [[nodiscard]] const char *name() const override {
+            return "dead-branch-elimination";
+        }
+
+        bool run(nodes::BacteriaProgram *program) override;
+    };
+
+    // Removes every nop from blocks and function bodies
+    struct NopStrippingPass : BacteriaPass {
+        [[nodiscard]] const char *name() const override {
+            return "nop-stripping";
+        }
+
+        bool run(nodes::BacteriaProgram *program) override;
+    };
+
+    // Removes functions that can't be reached from any external (exported or entry) function
+    struct UnreachableFunctionRemovalPass : BacteriaPass {
+        [[nodiscard]] const char *name() const override {
+            return "unreachable-function-removal";
+        }
+
+        bool run(nodes::BacteriaProgram *program) override;
+    };
+
+    // Works out how much of the memory visible to its callers every function can touch, so that lowering can mark
+    // functions as readnone/readonly, this never changes the program itself
+    struct FunctionAttributeInferencePass : BacteriaPass {
+        [[nodiscard]] const char *name() const override {
+            return "function-attribute-inference";
+        }
+
+        bool run(nodes::BacteriaProgram *program) override;
+    };
+
+    struct BacteriaPassManager {
+        std::vector<std::unique_ptr<BacteriaPass>> passes;
+
+        void add(std::unique_ptr<BacteriaPass> pass);
+
+        // Runs every pass in order, returning whether any of them changed the program
+        bool run(nodes::BacteriaProgram *program);
+    };
+
+    // Runs the standard set of passes over a program before it gets lowered
+    void run_default_passes(nodes::BacteriaProgram *program);
+}
+
+#endif //CHEESE_BACTERIAPASS_H
@@ -22,6 +22,12 @@ namespace cheese::bacteria {
 
         void receive(BacteriaPtr node);
 
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            for (auto &child: children) {
+                visitor(child);
+            }
+        }
+
         ~BacteriaReceiver() override = default;
 
     private:
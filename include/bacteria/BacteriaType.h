@@ -11,11 +11,18 @@
 #include <vector>
 #include <variant>
 #include <llvm/IR/Type.h>
+#include <llvm/Support/Alignment.h>
 
 namespace cheese::project {
     struct GlobalContext;
 }
 
+namespace llvm {
+    class StructType;
+    class FunctionType;
+    class Function;
+}
+
 namespace cheese::bacteria {
     namespace nodes {
         struct BacteriaProgram;
@@ -40,6 +47,7 @@ namespace cheese::bacteria {
             Pointer,
             Object,
             FunctionPointer, // subtype == return type, child_types == argument types
+            Vector, // subtype == lane type, array_dimensions == {lane count}
         } type = Type::Void;
         std::uint16_t integer_size = 0;
         BacteriaType *subtype = {};
@@ -49,6 +57,12 @@ namespace cheese::bacteria {
         // If this is empty, there is no name, otherwise there is
         // Named structure types will be emitted as text to the top of bacteria file
 
+        // Layout controls for objects, child_types stays in declaration order no matter how the fields get laid out
+        bool packed = false;
+        bool reorder_fields = false; // Sorts the fields by alignment, so the least amount of padding is needed
+        std::uint64_t alignment = 0; // 0 means the natural alignment
+        std::vector<std::uint64_t> field_alignments = {}; // One per child, 0 meaning the natural alignment
+
         explicit BacteriaType(Type type = Type::Void, uint16_t integerSize = 0,
                               BacteriaType *subtype = {},
                               const std::vector<std::size_t> &arrayDimensions = {},
@@ -64,6 +78,15 @@ namespace cheese::bacteria {
 
         llvm::Type *get_llvm_type(cheese::project::GlobalContext *ctx);
 
+        // The index of a child of an object within the lowered structure, which differs from the child index once fields
+        // are reordered or padding has to be inserted to honor an alignment
+        unsigned get_field_index(cheese::project::GlobalContext *ctx, std::size_t child);
+
+        // The byte offset of a child of an object within the lowered structure
+        std::uint64_t get_field_offset(cheese::project::GlobalContext *ctx, std::size_t child);
+
+        llvm::Align get_llvm_alignment(cheese::project::GlobalContext *ctx);
+
         size_t get_llvm_size(cheese::project::GlobalContext *ctx);
 
         bool constant_ref; // If the function pointer is extern or not
@@ -77,14 +100,58 @@ namespace cheese::bacteria {
 
         bool should_implicit_reference();
 
+        // How a value of this type crosses a function boundary
+        enum class Passing {
+            Direct, // As a single LLVM value
+            Split, // As one value per field, for small objects made only of scalars
+            Indirect, // Through a pointer to a copy, sret when returned and byval when passed
+            Reference, // Through a plain pointer to a copy the caller made, sret when returned, how C passes arrays and big objects on some targets
+            Coerced, // As the values get_coerced_types gives back, which hold the bytes of the object the way the C ABI does
+        };
+
+        // Internal functions pick whatever is cheapest, external ones follow the C ABI of the target, see
+        // get_signature_passing for that, as it can depend on the rest of the signature
+        Passing get_passing(cheese::project::GlobalContext *ctx);
+
+        // The values an object passed with Passing::Coerced becomes, in order, each one covering the next bytes of it
+        std::vector<llvm::Type *> get_coerced_types(cheese::project::GlobalContext *ctx);
+
+        // The return type of a function that returns this object coerced
+        llvm::Type *get_coerced_type(cheese::project::GlobalContext *ctx);
+
         bacteria::BacteriaType *index_type(nodes::BacteriaProgram *program, std::size_t numIndices);
 
     private:
+        void lay_out_object(cheese::project::GlobalContext *ctx, llvm::StructType *struct_type);
+
         llvm::Type *cached_llvm_type{nullptr};
+        std::vector<unsigned> field_indices{};
+        llvm::Align object_alignment{};
     };
 
     typedef BacteriaType *TypePtr;
     typedef std::vector<TypePtr> TypeList;
     typedef std::map<std::string, TypePtr> TypeDict;
+
+    // How the result and each argument of a function cross its boundary, this looks at the whole signature at once, as
+    // under the x86-64 System V ABI an object only goes in registers if enough of them are left over
+    struct SignaturePassing {
+        BacteriaType::Passing result = BacteriaType::Passing::Direct; // Never Split, objects are returned whole
+        std::vector<BacteriaType::Passing> arguments;
+        bool supported = true; // False when the C ABI of the target isn't known and an object would have to cross it
+
+        static SignaturePassing get(cheese::project::GlobalContext *ctx, TypePtr result, const TypeList &arguments,
+                                    bool external);
+
+        // Whether the result is written through an sret pointer, which comes before every argument
+        bool returns_indirectly() const;
+
+        llvm::FunctionType *get_function_type(cheese::project::GlobalContext *ctx, TypePtr result,
+                                              const TypeList &arguments) const;
+
+        // The sret, byval and alignment attributes of everything that is passed through a pointer
+        void add_attributes(cheese::project::GlobalContext *ctx, llvm::Function *function, TypePtr result,
+                            const TypeList &arguments) const;
+    };
 }
 #endif //CHEESE_BACTERIATYPE_H
@@ -6,17 +6,26 @@
 #define CHEESE_FUNCTIONCONTEXT_H
 
 #include <unordered_map>
-#include <set>
+#include <unordered_set>
+#include <vector>
 #include <string>
 #include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/ValueHandle.h>
 #include "VariableInfo.h"
 #include "BacteriaContext.h"
+#include "Symbol.h"
 
 namespace cheese::bacteria {
     struct FunctionContext {
         TypePtr return_type;
-        std::unordered_map<std::string, VariableInfo *> all_variables;
-        std::set<std::string> all_block_names;
+        llvm::Value *return_slot{nullptr}; // Where the result goes for functions that return indirectly
+        BacteriaType::Passing return_passing{BacteriaType::Passing::Direct};
+        std::vector<VariableInfo *> all_variables;
+        std::unordered_set<std::string> all_variable_names;
+        std::unordered_set<std::string> all_block_names;
+        std::unordered_map<std::string, std::size_t> next_variable_suffix; // The next suffix to try for a given base name
+        std::unordered_map<std::string, std::size_t> next_block_suffix;
+        bool keep_names; // Value and block names are only generated in debug mode, they are pure overhead otherwise
         std::size_t next_temporary_variable{0};
         llvm::Function *function;
         llvm::BasicBlock *allocation_block;
@@ -24,6 +33,14 @@ namespace cheese::bacteria {
         llvm::Instruction *goto_entry_instruction;
         BacteriaContext *bacteria_context;
 
+        // SSA construction state for variables that live in registers, following Braun et al.'s
+        // "Simple and Efficient Construction of Static Single Assignment Form"
+        // A block is sealed once all of its predecessors are known, until then reads in it go through placeholder phis
+        std::unordered_set<Symbol> address_taken; // Names that have their address taken, these have to stay in memory
+        std::unordered_map<llvm::BasicBlock *, std::unordered_map<VariableInfo *, llvm::WeakTrackingVH>> current_definitions;
+        std::unordered_set<llvm::BasicBlock *> sealed_blocks;
+        std::unordered_map<llvm::BasicBlock *, std::vector<std::pair<VariableInfo *, llvm::PHINode *>>> incomplete_phis;
+
         VariableInfo *get_mutable_variable(std::string name, TypePtr type);
 
         VariableInfo *get_immutable_variable(std::string name, TypePtr type);
@@ -34,15 +51,41 @@ namespace cheese::bacteria {
 
         std::string dedupe_variable_name(std::string variableName);
 
+        VariableInfo *add_variable(bool constant, std::string name, TypePtr type);
+
         llvm::Value *allocate(const std::string &name, TypePtr type);
 
+        // Objects the C ABI passes coerced go through memory to be reinterpreted as their parts, and back again
+        std::vector<llvm::Value *> coerce_to_parts(llvm::IRBuilder<> &builder, TypePtr type, llvm::Value *value);
+
+        llvm::Value *coerce_from_parts(llvm::IRBuilder<> &builder, TypePtr type, const std::vector<llvm::Value *> &parts);
+
         FunctionContext(BacteriaContext *bacteriaContext, llvm::Function *function);
 
         std::string get_block_name(std::string wantedName);
 
         llvm::Value *get_variable_address(VariableInfo &info);
 
+        bool can_live_in_registers(const std::string &name, TypePtr type);
+
+        void write_variable(VariableInfo *info, llvm::BasicBlock *block, llvm::Value *value);
+
+        llvm::Value *read_variable(VariableInfo *info, llvm::BasicBlock *block);
+
+        void seal_block(llvm::BasicBlock *block);
+
+        void seal_all_blocks();
+
         virtual ~FunctionContext();
+
+    private:
+        llvm::Value *allocate_coerced(TypePtr type, llvm::StructType *parts_type);
+
+        llvm::Value *read_variable_recursive(VariableInfo *info, llvm::BasicBlock *block);
+
+        llvm::Value *add_phi_operands(VariableInfo *info, llvm::PHINode *phi);
+
+        llvm::Value *try_remove_trivial_phi(llvm::PHINode *phi);
     };
 }
 #endif //CHEESE_FUNCTIONCONTEXT_H
@@ -13,6 +13,7 @@ namespace cheese::bacteria {
         TypePtr returnType;
         std::string name;
         llvm::Function *prototype;
+        SignaturePassing passing;
     };
 }
 #endif //CHEESE_FUNCTIONINFO_H
@@ -6,16 +6,17 @@
 #define CHEESE_SCOPECONTEXT_H
 
 #include "FunctionContext.h"
+#include "Symbol.h"
 
 namespace cheese::bacteria {
     struct ScopeContext {
-        std::unordered_map<std::string, std::string> variable_renames; // This is used for getting a variable from the scope
+        std::unordered_map<Symbol, VariableInfo *> variable_renames; // This is used for getting a variable from the scope
         llvm::BasicBlock *current_block;
         llvm::IRBuilder<> scope_builder;
         ScopeContext *parent_scope;
         FunctionContext &function_context;
 
-        VariableInfo *get_info(std::string name);
+        VariableInfo *get_info(Symbol name);
 
         VariableInfo *get_mutable_variable(std::string name, TypePtr type);
 
@@ -30,7 +31,10 @@ namespace cheese::bacteria {
 
         ScopeContext(FunctionContext &function, llvm::BasicBlock *block, ScopeContext *parentScope = nullptr);
 
-        llvm::BasicBlock *create_block(std::string name);
+        // Blocks can be created detached so that they can be branched to before they are placed in the function
+        llvm::BasicBlock *create_block(std::string name, bool attach = true);
+
+        void attach_block(llvm::BasicBlock *block);
     };
 }
 
@@ -22,6 +22,9 @@ namespace cheese::bacteria {
         // because the value might still change
         llvm::Value *value = nullptr; // On an array this becomes the array decay value
         llvm::Value *ptr = nullptr;
+        // Set on mutable variables that live in registers, these have no storage at all,
+        // instead their value in each block is tracked by the function context
+        bool in_registers = false;
 
         llvm::Value *load_value(llvm::IRBuilder<> &builder, project::GlobalContext *ctx);
 
@@ -26,20 +26,18 @@ namespace cheese::bacteria::nodes {
         TypeList arguments;
         bacteria::TypePtr return_type;
 
-        std::string get_textual_representation(int depth) override {
-            std::stringstream ss{};
-            ss << "fn " << name << " ";
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "fn " << name << " ";
             for (int i = 0; i < arguments.size(); i++) {
                 auto &argument = arguments[i];
-                ss << argument->to_string();
+                os << argument->to_string();
                 if (i < arguments.size() - 1) {
-                    ss << ", ";
+                    os << ", ";
                 } else {
-                    ss << " ";
+                    os << " ";
                 }
             }
-            ss << "=> " << return_type->to_string() << " import";
-            return ss.str();
+            os << "=> " << return_type->to_string() << " import";
         }
 
         ~FunctionImport() override = default;
@@ -62,17 +60,22 @@ namespace cheese::bacteria::nodes {
 
         ~Return() override = default;
 
-        std::string get_textual_representation(int depth) override {
-            std::stringstream ss{};
-            ss << "return";
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "return";
             if (retVal.has_value()) {
-                ss << ' ' << retVal.value()->get_textual_representation(depth);
+                os << ' ';
+                retVal.value()->write_textual_representation(os, depth);
             }
-            return ss.str();
         }
 
         JSON_FUNCS("return", { "value" }, retVal)
 
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            if (retVal.has_value()) {
+                visitor(retVal.value());
+            }
+        }
+
         void lower_scope_level(ScopeContext &ctx) override;
     };
 
@@ -91,30 +94,38 @@ namespace cheese::bacteria::nodes {
 
         ~If() override = default;
 
-        std::string get_textual_representation(int depth) override {
-            std::stringstream ss{};
-            ss << "if " << condition->get_textual_representation(depth) << '\n';
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "if ";
+            condition->write_textual_representation(os, depth);
+            os << '\n';
             auto d = dynamic_cast<UnnamedBlock *>(body.get()) ? 0 : 1;
-            add_indentation(ss, depth + d);
-            ss << body->get_textual_representation(depth + d);
+            add_indentation(os, depth + d);
+            body->write_textual_representation(os, depth + d);
             if (els.has_value()) {
-                ss << '\n';
-                add_indentation(ss, depth);
+                os << '\n';
+                add_indentation(os, depth);
                 if (dynamic_cast<If *>(els.value().get())) {
-                    ss << "else ";
-                    ss << els.value()->get_textual_representation(depth);
+                    os << "else ";
+                    els.value()->write_textual_representation(os, depth);
                 } else {
-                    ss << "else\n";
+                    os << "else\n";
                     auto d2 = dynamic_cast<UnnamedBlock *>(els.value().get()) ? 0 : 1;
-                    add_indentation(ss, depth + d2);
-                    ss << els.value()->get_textual_representation(depth + d2);
+                    add_indentation(os, depth + d2);
+                    els.value()->write_textual_representation(os, depth + d2);
                 }
             }
-            return ss.str();
         }
 
         JSON_FUNCS("if", { "condition", "body", "else" }, condition, body, els)
 
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            visitor(condition);
+            visitor(body);
+            if (els.has_value()) {
+                visitor(els.value());
+            }
+        }
+
         void lower_scope_level(ScopeContext &ctx) override;
     };
 
@@ -133,33 +144,219 @@ namespace cheese::bacteria::nodes {
 
         ~While() override = default;
 
-        std::string get_textual_representation(int depth) override {
-            std::stringstream ss{};
-            ss << "while " << condition->get_textual_representation(depth) << '\n';
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "while ";
+            condition->write_textual_representation(os, depth);
+            os << '\n';
             auto d = dynamic_cast<UnnamedBlock *>(body.get()) ? 0 : 1;
-            add_indentation(ss, depth + d);
-            ss << body->get_textual_representation(depth + d);
+            add_indentation(os, depth + d);
+            body->write_textual_representation(os, depth + d);
             if (els.has_value()) {
-                ss << '\n';
-                add_indentation(ss, depth);
+                os << '\n';
+                add_indentation(os, depth);
                 if (dynamic_cast<If *>(els.value().get())) {
-                    ss << "else ";
-                    ss << els.value()->get_textual_representation(depth);
+                    os << "else ";
+                    els.value()->write_textual_representation(os, depth);
                 } else {
-                    ss << "else\n";
+                    os << "else\n";
                     auto d2 = dynamic_cast<UnnamedBlock *>(els.value().get()) ? 0 : 1;
-                    add_indentation(ss, depth + d2);
-                    ss << els.value()->get_textual_representation(depth + d2);
+                    add_indentation(os, depth + d2);
+                    els.value()->write_textual_representation(os, depth + d2);
                 }
             }
-            return ss.str();
         }
 
         JSON_FUNCS("while", { "condition", "body", "else" }, condition, body, els)
 
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            visitor(condition);
+            visitor(body);
+            if (els.has_value()) {
+                visitor(els.value());
+            }
+        }
+
+        void lower_scope_level(ScopeContext &ctx) override;
+    };
+
+    // A loop whose induction variable starts at begin and goes up by one each iteration until it reaches end, this is
+    // the shape that LLVM can compute a trip count for, which is what lets the loop vectorizer and unroller fire on it
+    struct CountedLoop : BacteriaNode {
+        CountedLoop(const Coordinate &location, std::string induction, TypePtr type, BacteriaPtr begin,
+                    BacteriaPtr end, bool inclusive, BacteriaPtr body) : BacteriaNode(location),
+                                                                         induction(std::move(induction)), type(type),
+                                                                         begin(std::move(begin)), end(std::move(end)),
+                                                                         inclusive(inclusive), body(std::move(body)),
+                                                                         els() {}
+
+        std::string induction;
+        TypePtr type;
+        BacteriaPtr begin;
+        BacteriaPtr end;
+        bool inclusive; // Whether the loop still runs when the induction variable is equal to end
+        BacteriaPtr body;
+        std::optional<BacteriaPtr> els;
+
+        ~CountedLoop() override = default;
+
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "for " << induction << " @ " << type->to_string() << " in ";
+            begin->write_textual_representation(os, depth);
+            os << (inclusive ? " .. " : " ..< ");
+            end->write_textual_representation(os, depth);
+            os << '\n';
+            auto d = dynamic_cast<UnnamedBlock *>(body.get()) ? 0 : 1;
+            add_indentation(os, depth + d);
+            body->write_textual_representation(os, depth + d);
+            if (els.has_value()) {
+                os << '\n';
+                add_indentation(os, depth);
+                os << "else\n";
+                auto d2 = dynamic_cast<UnnamedBlock *>(els.value().get()) ? 0 : 1;
+                add_indentation(os, depth + d2);
+                els.value()->write_textual_representation(os, depth + d2);
+            }
+        }
+
+        JSON_FUNCS("for", { "induction", "ty", "begin", "end", "inclusive", "body", "else" }, induction,
+                   type->to_string(), begin, end, inclusive, body, els)
+
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            visitor(begin);
+            visitor(end);
+            visitor(body);
+            if (els.has_value()) {
+                visitor(els.value());
+            }
+        }
+
         void lower_scope_level(ScopeContext &ctx) override;
     };
 
+    // A hint from $vectorize or $unroll, it lowers to nothing on its own, instead the loop it is directly inside of
+    // picks it up when building its llvm.loop metadata
+    struct LoopHint : BacteriaNode {
+        enum class Kind {
+            Vectorize,
+            Unroll
+        };
+
+        LoopHint(const Coordinate &location, Kind kind, bool enable, std::uint64_t count) : BacteriaNode(location),
+                                                                                             kind(kind),
+                                                                                             enable(enable),
+                                                                                             count(count) {}
+
+        Kind kind;
+        bool enable;
+        std::uint64_t count; // The vectorization width or unroll count, 0 leaves the choice up to LLVM
+
+        ~LoopHint() override = default;
+
+        [[nodiscard]] std::string kind_name() const {
+            return kind == Kind::Vectorize ? "vectorize" : "unroll";
+        }
+
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << '$' << kind_name() << '(';
+            if (!enable) {
+                os << "false";
+            } else if (count != 0) {
+                os << count;
+            } else {
+                os << "true";
+            }
+            os << ')';
+        }
+
+        JSON_FUNCS("loop_hint", { "kind", "enable", "count" }, kind_name(), enable, count)
+
+        void lower_scope_level(ScopeContext &ctx) override {}
+    };
+
+    // A single arm of a switch, the values are always integer literals of the switched type
+    struct SwitchCase : BacteriaNode {
+        SwitchCase(const Coordinate &location, BacteriaList values, BacteriaPtr body) : BacteriaNode(location),
+                                                                                        values(std::move(values)),
+                                                                                        body(std::move(body)) {}
+
+        BacteriaList values;
+        BacteriaPtr body;
+
+        ~SwitchCase() override = default;
+
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "case ";
+            for (int i = 0; i < values.size(); i++) {
+                values[i]->write_textual_representation(os, depth);
+                if (i < values.size() - 1) {
+                    os << ", ";
+                }
+            }
+            os << '\n';
+            auto d = dynamic_cast<UnnamedBlock *>(body.get()) ? 0 : 1;
+            add_indentation(os, depth + d);
+            body->write_textual_representation(os, depth + d);
+        }
+
+        JSON_FUNCS("case", { "values", "body" }, values, body)
+
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            for (auto &value: values) {
+                visitor(value);
+            }
+            visitor(body);
+        }
+    };
+
+    // Generated for matches where every arm is a compile time integer constant, this gets lowered to an LLVM switch
+    // so that the backend can turn it into a jump table rather than a chain of comparisons
+    struct Switch : BacteriaNode {
+        Switch(const Coordinate &location, BacteriaPtr value, TypePtr type) : BacteriaNode(location),
+                                                                               value(std::move(value)), type(type),
+                                                                               cases(), default_case() {}
+
+        BacteriaPtr value;
+        TypePtr type;
+        BacteriaList cases;
+        std::optional<BacteriaPtr> default_case;
+
+        ~Switch() override = default;
+
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "switch ";
+            value->write_textual_representation(os, depth);
+            for (auto &arm: cases) {
+                os << '\n';
+                add_indentation(os, depth + 1);
+                arm->write_textual_representation(os, depth + 1);
+            }
+            if (default_case.has_value()) {
+                os << '\n';
+                add_indentation(os, depth + 1);
+                os << "default\n";
+                auto d = dynamic_cast<UnnamedBlock *>(default_case.value().get()) ? 1 : 2;
+                add_indentation(os, depth + d);
+                default_case.value()->write_textual_representation(os, depth + d);
+            }
+        }
+
+        JSON_FUNCS("switch", { "value", "ty", "cases", "default" }, value, type->to_string(), cases, default_case)
+
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            visitor(value);
+            for (auto &arm: cases) {
+                visitor(arm);
+            }
+            if (default_case.has_value()) {
+                visitor(default_case.value());
+            }
+        }
+
+        void lower_scope_level(ScopeContext &ctx) override;
+
+        llvm::Value *lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) override;
+    };
+
     struct Nop : BacteriaNode {
         Nop(const Coordinate &location) : BacteriaNode(location) {
 
@@ -167,8 +364,8 @@ namespace cheese::bacteria::nodes {
 
         ~Nop() override = default;
 
-        std::string get_textual_representation(int depth) override {
-            return "/* elided */";
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "/* elided */";
         }
 
         JSON_FUNCS("nop", std::vector<std::string>{})
@@ -185,10 +382,8 @@ namespace cheese::bacteria::nodes {
 
         ~IntegerLiteral() override = default;
 
-        std::string get_textual_representation(int depth) override {
-            std::stringstream ss{};
-            ss << '(' << static_cast<std::string>(value) << " @ " << type->to_string() << ')';
-            return ss.str();
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << '(' << static_cast<std::string>(value) << " @ " << type->to_string() << ')';
         }
 
         JSON_FUNCS("integer", { "value", "ty" }, value, (type->to_string()))
@@ -208,10 +403,8 @@ namespace cheese::bacteria::nodes {
 
         ~StringLiteral() override = default;
 
-        std::string get_textual_representation(int depth) override {
-            std::stringstream ss{};
-            ss << '(' << '"' << stringutil::escape(value) << '"' << " @ " << type->to_string() << ')';
-            return ss.str();
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << '(' << '"' << stringutil::escape(value) << '"' << " @ " << type->to_string() << ')';
         }
 
         JSON_FUNCS("integer", { "value", "ty" }, value, (type->to_string()))
@@ -231,13 +424,17 @@ namespace cheese::bacteria::nodes {
 
         ~FloatLiteral() override = default;
 
-        std::string get_textual_representation(int depth) override {
-            std::stringstream ss{};
-            ss << '(' << value << " @ " << type->to_string() << ')';
-            return ss.str();
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << '(' << value << " @ " << type->to_string() << ')';
         }
 
         JSON_FUNCS("float", { "value", "ty" }, value, (type->to_string()));
+
+        llvm::Value *lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) override;
+
+        TypePtr get_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program) override {
+            return type;
+        }
     };
 
     struct ComplexLiteral : BacteriaNode {
@@ -251,10 +448,8 @@ namespace cheese::bacteria::nodes {
 
         ~ComplexLiteral() override = default;
 
-        std::string get_textual_representation(int depth) override {
-            std::stringstream ss{};
-            ss << '(' << a << "+" << b << "I @ " << type->to_string() << ')';
-            return ss.str();
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << '(' << a << "+" << b << "I @ " << type->to_string() << ')';
         }
 
         JSON_FUNCS("complex", { "a", "b", "ty" }, a, b, (type->to_string()));
@@ -262,14 +457,14 @@ namespace cheese::bacteria::nodes {
 
     struct ValueReference : BacteriaNode {
 
-        std::string name;
+        Symbol name;
 
-        ValueReference(const Coordinate &location, std::string name) : BacteriaNode(location), name(name) {}
+        ValueReference(const Coordinate &location, Symbol name) : BacteriaNode(location), name(name) {}
 
         ~ValueReference() override = default;
 
-        std::string get_textual_representation(int depth) override {
-            return name;
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << name;
         }
 
         JSON_FUNCS("value", { "name" }, name)
@@ -290,14 +485,17 @@ namespace cheese::bacteria::nodes {
 
         ~CastNode() override = default;
 
-        std::string get_textual_representation(int depth) override {
-            std::stringstream ss{};
-            ss << lhs->get_textual_representation(depth) << " @ " << rhs->to_string();
-            return ss.str();
+        void write_textual_representation(std::ostream &os, int depth) override {
+            lhs->write_textual_representation(os, depth);
+            os << " @ " << rhs->to_string();
         }
 
         JSON_FUNCS("cast", { "value", "ty" }, lhs, (rhs->to_string()))
 
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            visitor(lhs);
+        }
+
         llvm::Value *lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) override;
     };
 
@@ -311,21 +509,25 @@ namespace cheese::bacteria::nodes {
 
         ~NormalCallNode() override = default;
 
-        std::string get_textual_representation(int depth) override {
-            std::stringstream ss{};
-            ss << function << '(';
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << function << '(';
             for (int i = 0; i < arguments.size(); i++) {
-                ss << arguments[i]->get_textual_representation(depth);
+                arguments[i]->write_textual_representation(os, depth);
                 if (i < arguments.size() - 1) {
-                    ss << ", ";
+                    os << ", ";
                 }
             }
-            ss << ')';
-            return ss.str();
+            os << ')';
         }
 
         JSON_FUNCS("call", { "function", "arguments" }, function, arguments)
 
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            for (auto &argument: arguments) {
+                visitor(argument);
+            }
+        }
+
         llvm::Value *lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) override;
 
         void lower_scope_level(ScopeContext &ctx) override;
@@ -343,52 +545,72 @@ namespace cheese::bacteria::nodes {
 
         ~PointerCallNode() override = default;
 
-        std::string get_textual_representation(int depth) override {
-            std::stringstream ss{};
-            ss << "(*" + function->get_textual_representation(depth) + ")" << '(';
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "(*";
+            function->write_textual_representation(os, depth);
+            os << ")(";
             for (int i = 0; i < arguments.size(); i++) {
-                ss << arguments[i]->get_textual_representation(depth);
+                arguments[i]->write_textual_representation(os, depth);
                 if (i < arguments.size() - 1) {
-                    ss << ", ";
+                    os << ", ";
                 }
             }
-            ss << ')';
-            return ss.str();
+            os << ')';
         }
 
         JSON_FUNCS("pointer_call", { "function", "arguments" }, function, arguments)
+
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            visitor(function);
+            for (auto &argument: arguments) {
+                visitor(argument);
+            }
+        }
     };
 
     struct ArrayIndexNode : BacteriaNode {
         ArrayIndexNode(const Coordinate &location, BacteriaPtr array,
-                       std::vector<BacteriaPtr> arguments) : BacteriaNode(location), array(std::move(array)),
-                                                             arguments(std::move(arguments)) {}
+                       std::vector<BacteriaPtr> arguments, bool checked = true) : BacteriaNode(location),
+                                                                                  array(std::move(array)),
+                                                                                  arguments(std::move(arguments)),
+                                                                                  checked(checked) {}
 
         BacteriaPtr array;
         std::vector<BacteriaPtr> arguments;
+        // Whether the indices get checked against the bounds of arrays and slices in debug builds, curdle clears this
+        // when it can already prove every index is in bounds
+        bool checked;
 
         ~ArrayIndexNode() override = default;
 
-        std::string get_textual_representation(int depth) override {
-            std::stringstream ss{};
-            ss << array->get_textual_representation(depth) << '[';
+        void write_textual_representation(std::ostream &os, int depth) override {
+            array->write_textual_representation(os, depth);
+            os << '[';
             for (int i = 0; i < arguments.size(); i++) {
-                ss << arguments[i]->get_textual_representation(depth);
+                arguments[i]->write_textual_representation(os, depth);
                 if (i < arguments.size() - 1) {
-                    ss << ", ";
+                    os << ", ";
                 }
             }
-            ss << ']';
-            return ss.str();
+            os << ']';
         }
 
-        JSON_FUNCS("pointer_call", { "array", "arguments" }, array, arguments)
+        JSON_FUNCS("index", { "array", "arguments", "checked" }, array, arguments, checked)
+
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            visitor(array);
+            for (auto &argument: arguments) {
+                visitor(argument);
+            }
+        }
 
         TypePtr get_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program) override;
 
         llvm::Value *lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) override;
 
         llvm::Value *lower_address(ScopeContext &ctx) override;
+
+        llvm::Align get_address_alignment(ScopeContext &ctx) override;
     };
 
     struct VariableInitializationNode : BacteriaNode {
@@ -404,13 +626,18 @@ namespace cheese::bacteria::nodes {
 
         ~VariableInitializationNode() = default;
 
-        std::string get_textual_representation(int depth) override {
-            return name + ": " + type->to_string() + " = " + value->get_textual_representation(depth);
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << name << ": " << type->to_string() << " = ";
+            value->write_textual_representation(os, depth);
         }
 
         JSON_FUNCS("init", { "name", "ty", "value", "constant" }, name, type->to_string(), value,
                    std::to_string(constant))
 
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            visitor(value);
+        }
+
         void lower_scope_level(ScopeContext &ctx) override;;
     };
 
@@ -423,8 +650,8 @@ namespace cheese::bacteria::nodes {
 
         ~VariableDefinitionNode() = default;
 
-        std::string get_textual_representation(int depth) override {
-            return name + ": " + type->to_string();
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << name << ": " << type->to_string();
         }
 
         JSON_FUNCS("def", { "name", "ty" }, name, type->to_string())
@@ -438,23 +665,147 @@ namespace cheese::bacteria::nodes {
 
         ~AggregrateObject() override = default;
 
-        std::string get_textual_representation(int depth) override {
-            std::stringstream ss{};
-            ss << "(" << type->to_string() << "){";
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "(" << type->to_string() << "){";
             for (int i = 0; i < values.size(); i++) {
-                ss << values[i]->get_textual_representation(depth);
+                values[i]->write_textual_representation(os, depth);
                 if (i < values.size() - 1) {
-                    ss << ", ";
+                    os << ", ";
                 }
             }
-            ss << '}';
-            return ss.str();
+            os << '}';
         }
 
         TypePtr type;
         std::vector<BacteriaPtr> values;
 
         JSON_FUNCS("object", { "ty", "values" }, type->to_string(), values);
+
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            for (auto &value: values) {
+                visitor(value);
+            }
+        }
+
+        llvm::Value *lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) override;
+
+        TypePtr get_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program) override {
+            return type;
+        }
+
+        // Whether every value is a literal or a constant aggregate itself, so the whole thing is known at compile time
+        bool is_constant();
+
+        llvm::Constant *lower_constant(ScopeContext &ctx);
+    };
+
+    // Generated by $shuffle, picks lanes out of two vectors of the same type, lanes of rhs are numbered after those of
+    // lhs, the mask is always compile time known
+    struct VectorShuffle : BacteriaNode {
+        VectorShuffle(const Coordinate &location, BacteriaPtr lhs, BacteriaPtr rhs, std::vector<int> mask,
+                      TypePtr type) : BacteriaNode(location), lhs(std::move(lhs)), rhs(std::move(rhs)),
+                                      mask(std::move(mask)), type(type) {}
+
+        BacteriaPtr lhs;
+        BacteriaPtr rhs;
+        std::vector<int> mask;
+        TypePtr type; // The result type, which has as many lanes as there are entries in the mask
+
+        ~VectorShuffle() override = default;
+
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "$shuffle(";
+            lhs->write_textual_representation(os, depth);
+            os << ", ";
+            rhs->write_textual_representation(os, depth);
+            for (auto lane: mask) {
+                os << ", " << lane;
+            }
+            os << ')';
+        }
+
+        // The mask as a comma separated list of lanes, as the json helpers don't deal with plain integer lists
+        [[nodiscard]] std::string mask_string() const {
+            std::stringstream ss{};
+            for (size_t i = 0; i < mask.size(); i++) {
+                if (i != 0) ss << ',';
+                ss << mask[i];
+            }
+            return ss.str();
+        }
+
+        JSON_FUNCS("shuffle", { "lhs", "rhs", "mask", "ty" }, lhs, rhs, mask_string(), type->to_string())
+
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            visitor(lhs);
+            visitor(rhs);
+        }
+
+        llvm::Value *lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) override;
+
+        TypePtr get_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program) override {
+            return type;
+        }
+    };
+
+    // Generated by $reduce, folds every lane of a vector into a single value with one operation
+    struct VectorReduce : BacteriaNode {
+        enum class Operation {
+            Add,
+            Mul,
+            Min,
+            Max,
+            And,
+            Or,
+            Xor
+        };
+
+        VectorReduce(const Coordinate &location, Operation operation, BacteriaPtr value, TypePtr type)
+                : BacteriaNode(location), operation(operation), value(std::move(value)), type(type) {}
+
+        Operation operation;
+        BacteriaPtr value;
+        TypePtr type; // The type of the vector being reduced
+
+        ~VectorReduce() override = default;
+
+        [[nodiscard]] std::string operation_name() const {
+            switch (operation) {
+                case Operation::Add:
+                    return "Add";
+                case Operation::Mul:
+                    return "Mul";
+                case Operation::Min:
+                    return "Min";
+                case Operation::Max:
+                    return "Max";
+                case Operation::And:
+                    return "And";
+                case Operation::Or:
+                    return "Or";
+                case Operation::Xor:
+                    return "Xor";
+            }
+            return "";
+        }
+
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "$reduce(." << operation_name() << ", ";
+            value->write_textual_representation(os, depth);
+            os << ')';
+        }
+
+        JSON_FUNCS("reduce", { "operation", "value", "ty" }, operation_name(), value, type->to_string())
+
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            visitor(value);
+        }
+
+        llvm::Value *lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) override;
+
+        TypePtr get_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program) override {
+            return type->subtype;
+        }
     };
 
     struct UnaryMinusNode : BacteriaNode {
@@ -463,13 +814,19 @@ namespace cheese::bacteria::nodes {
 
         ~UnaryMinusNode() override = default;
 
-        std::string get_textual_representation(int depth) override {
-            return "(-" + child->get_textual_representation(depth) + ")";
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "(-";
+            child->write_textual_representation(os, depth);
+            os << ")";
         }
 
         BacteriaPtr child;
 
         JSON_FUNCS("unary -", { "child" }, child)
+
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            visitor(child);
+        }
     };
 
 
@@ -479,13 +836,19 @@ namespace cheese::bacteria::nodes {
 
         ~UnaryPlusNode() override = default;
 
-        std::string get_textual_representation(int depth) override {
-            return "(+" + child->get_textual_representation(depth) + ")";
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "(+";
+            child->write_textual_representation(os, depth);
+            os << ")";
         }
 
         BacteriaPtr child;
 
         JSON_FUNCS("unary +", { "child" }, child)
+
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            visitor(child);
+        }
     };
 
 
@@ -495,13 +858,19 @@ namespace cheese::bacteria::nodes {
 
         ~ImplicitReferenceNode() override = default;
 
-        std::string get_textual_representation(int depth) override {
-            return "(&&" + child->get_textual_representation(depth) + ")";
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "(&&";
+            child->write_textual_representation(os, depth);
+            os << ")";
         }
 
         BacteriaPtr child;
 
         JSON_FUNCS("&&", { "child" }, child)
+
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            visitor(child);
+        }
     };
 
     struct ReferenceNode : BacteriaNode {
@@ -510,13 +879,19 @@ namespace cheese::bacteria::nodes {
 
         ~ReferenceNode() override = default;
 
-        std::string get_textual_representation(int depth) override {
-            return "(&" + child->get_textual_representation(depth) + ")";
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "(&";
+            child->write_textual_representation(os, depth);
+            os << ")";
         }
 
         BacteriaPtr child;
 
         JSON_FUNCS("&", { "child" }, child)
+
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            visitor(child);
+        }
     };
 
     struct ObjectSubscriptNode : BacteriaNode {
@@ -526,8 +901,10 @@ namespace cheese::bacteria::nodes {
 
         ~ObjectSubscriptNode() override = default;
 
-        std::string get_textual_representation(int depth) override {
-            return "(" + child->get_textual_representation(depth) + "." + std::to_string(index) + ")";
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "(";
+            child->write_textual_representation(os, depth);
+            os << "." << index << ")";
         }
 
 
@@ -535,6 +912,18 @@ namespace cheese::bacteria::nodes {
         int index;
 
         JSON_FUNCS(".", { "child", "index" }, child, static_cast<int64_t>(index))
+
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            visitor(child);
+        }
+
+        TypePtr get_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program) override;
+
+        llvm::Value *lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) override;
+
+        llvm::Value *lower_address(ScopeContext &ctx) override;
+
+        llvm::Align get_address_alignment(ScopeContext &ctx) override;
     };
 
     struct ReferenceSubscriptNode : BacteriaNode {
@@ -544,8 +933,10 @@ namespace cheese::bacteria::nodes {
 
         ~ReferenceSubscriptNode() override = default;
 
-        std::string get_textual_representation(int depth) override {
-            return "(" + child->get_textual_representation(depth) + "->" + std::to_string(index) + ")";
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "(";
+            child->write_textual_representation(os, depth);
+            os << "->" << index << ")";
         }
 
 
@@ -553,6 +944,101 @@ namespace cheese::bacteria::nodes {
         int index;
 
         JSON_FUNCS("->", { "child", "index" }, child, static_cast<int64_t>(index))
+
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            visitor(child);
+        }
+
+        TypePtr get_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program) override;
+
+        llvm::Value *lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) override;
+
+        llvm::Value *lower_address(ScopeContext &ctx) override;
+
+        llvm::Align get_address_alignment(ScopeContext &ctx) override;
+    };
+
+    // Builds a slice out of a pointer to its first item and the amount of items
+    struct SliceNode : BacteriaNode {
+        SliceNode(const Coordinate &location, BacteriaPtr pointer, BacteriaPtr length, TypePtr type)
+                : BacteriaNode(location), pointer(std::move(pointer)), length(std::move(length)), type(type) {}
+
+        ~SliceNode() override = default;
+
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "(<>";
+            pointer->write_textual_representation(os, depth);
+            os << ", ";
+            length->write_textual_representation(os, depth);
+            os << " @ " << type->to_string() << ")";
+        }
+
+        BacteriaPtr pointer;
+        BacteriaPtr length;
+        TypePtr type;
+
+        JSON_FUNCS("slice", { "pointer", "length", "ty" }, pointer, length, (type->to_string()))
+
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            visitor(pointer);
+            visitor(length);
+        }
+
+        TypePtr get_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program) override;
+
+        llvm::Value *lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) override;
+    };
+
+    // Reads the amount of items in a slice, or in the slice a reference points to
+    struct SliceLengthNode : BacteriaNode {
+        SliceLengthNode(const Coordinate &location, BacteriaPtr child) : BacteriaNode(location),
+                                                                         child(std::move(child)) {}
+
+        ~SliceLengthNode() override = default;
+
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "(";
+            child->write_textual_representation(os, depth);
+            os << ".len)";
+        }
+
+        BacteriaPtr child;
+
+        JSON_FUNCS(".len", { "child" }, child)
+
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            visitor(child);
+        }
+
+        TypePtr get_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program) override;
+
+        llvm::Value *lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) override;
+    };
+
+    // Reads the pointer to the first item of a slice, or of the slice a reference points to
+    struct SlicePointerNode : BacteriaNode {
+        SlicePointerNode(const Coordinate &location, BacteriaPtr child) : BacteriaNode(location),
+                                                                          child(std::move(child)) {}
+
+        ~SlicePointerNode() override = default;
+
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "(";
+            child->write_textual_representation(os, depth);
+            os << ".ptr)";
+        }
+
+        BacteriaPtr child;
+
+        JSON_FUNCS(".ptr", { "child" }, child)
+
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            visitor(child);
+        }
+
+        TypePtr get_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program) override;
+
+        llvm::Value *lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) override;
     };
 
     struct BinaryNode : BacteriaNode {
@@ -563,17 +1049,23 @@ namespace cheese::bacteria::nodes {
 
         virtual const char *get_operator() const = 0;
 
-        std::string get_textual_representation(int depth) override final {
-            std::stringstream ss{};
-            ss << '(' << lhs->get_textual_representation(depth) << ' ' << get_operator() << ' '
-               << rhs->get_textual_representation(depth) << ')';
-            return ss.str();
+        void write_textual_representation(std::ostream &os, int depth) override final {
+            os << '(';
+            lhs->write_textual_representation(os, depth);
+            os << ' ' << get_operator() << ' ';
+            rhs->write_textual_representation(os, depth);
+            os << ')';
         }
 
         BacteriaPtr lhs;
         BacteriaPtr rhs;
 
         JSON_FUNCS(get_operator(), { "lhs", "rhs" }, lhs, rhs);
+
+        void visit_children(const std::function<void(BacteriaPtr &)> &visitor) override {
+            visitor(lhs);
+            visitor(rhs);
+        }
     };
 
     struct NotEqualNode : BinaryNode {
@@ -635,6 +1127,8 @@ namespace cheese::bacteria::nodes {
         const char *get_operator() const override {
             return "*";
         }
+
+        llvm::Value *lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) override;
     };
 
     struct SubtractNode : BinaryNode {
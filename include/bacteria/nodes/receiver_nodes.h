@@ -21,18 +21,16 @@ namespace cheese::bacteria::nodes {
         TypeList all_types = {};
         TypeDict named_types = {};
 
-        std::string get_textual_representation(int depth) override {
-            std::stringstream ss{};
+        void write_textual_representation(std::ostream &os, int depth) override {
             for (auto &type: named_types) {
-                add_indentation(ss, depth);
-                ss << type.first << ": type = " << type.second->to_string(true) << '\n';
+                add_indentation(os, depth);
+                os << type.first << ": type = " << type.second->to_string(true) << '\n';
             }
             for (auto &child: children) {
-                add_indentation(ss, depth);
-                ss << child->get_textual_representation(depth);
-                ss << "\n";
+                add_indentation(os, depth);
+                child->write_textual_representation(os, depth);
+                os << "\n";
             }
-            return ss.str();
         }
 
         TypePtr get_type(BacteriaType::Type type = BacteriaType::Type::Void, uint16_t integerSize = 0,
@@ -66,6 +64,20 @@ namespace cheese::bacteria::nodes {
             return object;
         }
 
+        void write_json(util::TreeWriter &writer) const override {
+            writer.begin_object();
+            for (auto &kv: named_types) {
+                writer.key(kv.first);
+                writer.value(kv.second->to_string(true));
+            }
+            auto map = get_child_map();
+            for (auto &kv: map) {
+                writer.key(kv.first);
+                children[kv.second]->write_json(writer);
+            }
+            writer.end_object();
+        }
+
         [[nodiscard]] bool compare_json(const nlohmann::json &json) const override {
             // This is going to be interesting
             if (!json.is_object()) return false;
@@ -88,17 +100,15 @@ namespace cheese::bacteria::nodes {
     struct UnnamedBlock : BacteriaReceiver {
         UnnamedBlock(Coordinate location) : BacteriaReceiver(location) {}
 
-        std::string get_textual_representation(int depth) override {
-            std::stringstream ss{};
-            ss << "{\n";
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "{\n";
             for (auto &child: children) {
-                add_indentation(ss, depth + 1);
-                ss << child->get_textual_representation(depth + 1);
-                ss << "\n";
+                add_indentation(os, depth + 1);
+                child->write_textual_representation(os, depth + 1);
+                os << "\n";
             }
-            add_indentation(ss, depth);
-            ss << "}";
-            return ss.str();
+            add_indentation(os, depth);
+            os << "}";
         }
 
         JSON_FUNCS("block", { "body" }, children)
@@ -112,36 +122,46 @@ namespace cheese::bacteria::nodes {
 
 
     struct Function : BacteriaReceiver {
-        Function(Coordinate location, std::string n, std::vector<FunctionArgument> args, bacteria::TypePtr rt)
-                : BacteriaReceiver(location), name(std::move(n)), arguments(args), return_type(rt) {
+        // What a function can do to memory that its callers can see, from least to most
+        enum class MemoryEffects {
+            None, // Only touches its own locals
+            ReadOnly, // Can read through pointers and references, but never writes through them
+            Unknown
+        };
+
+        Function(Coordinate location, std::string n, std::vector<FunctionArgument> args, bacteria::TypePtr rt,
+                 bool external = false, bool is_inline = false)
+                : BacteriaReceiver(location), name(std::move(n)), arguments(args), return_type(rt),
+                  external(external), is_inline(is_inline) {
 
         }
 
         std::string name;
         std::vector<FunctionArgument> arguments;
         bacteria::TypePtr return_type;
+        bool external; // Exported and entry functions, these are visible outside the module, so they are always kept
+        bool is_inline;
+        MemoryEffects memory_effects = MemoryEffects::Unknown; // Filled in by FunctionAttributeInferencePass
 
-        std::string get_textual_representation(int depth) override {
-            std::stringstream ss{};
-            ss << "fn " << name << " ";
+        void write_textual_representation(std::ostream &os, int depth) override {
+            os << "fn " << name << " ";
             for (int i = 0; i < arguments.size(); i++) {
                 auto &argument = arguments[i];
-                ss << argument.name << ": " << argument.type->to_string();
+                os << argument.name << ": " << argument.type->to_string();
                 if (i < arguments.size() - 1) {
-                    ss << ", ";
+                    os << ", ";
                 } else {
-                    ss << " ";
+                    os << " ";
                 }
             }
-            ss << "=> " << return_type->to_string();
-            ss << " {\n";
+            os << "=> " << return_type->to_string();
+            os << " {\n";
             for (auto &child: children) {
-                add_indentation(ss, depth + 1);
-                ss << child->get_textual_representation(depth + 1);
-                ss << "\n";
+                add_indentation(os, depth + 1);
+                child->write_textual_representation(os, depth + 1);
+                os << "\n";
             }
-            ss << "}";
-            return ss.str();
+            os << "}";
         }
 
         ~Function() override = default;
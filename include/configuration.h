@@ -12,6 +12,11 @@ namespace cheese::configuration {
         Debug,
         Release,
     };
+    enum class BoundsChecks {
+        Always, // Every index into an array or slice that can't be proven in bounds is checked
+        Debug, // Indices are only checked in debug builds
+        Never,
+    };
     void default_error_output_handler(std::string);
 
 
@@ -28,6 +33,9 @@ namespace cheese::configuration {
     extern bool log_errors; //Whether errors should be logged, this is set to false when running the compiler tests for things that don't expect errors for example
     extern bool warnings_are_errors; //Whether warnings should be treated as errors
     extern bool die_on_first_error; //Whether the compiler should die on the first error, used by the testing system to test for errors
+    extern bool ssa_lowering; //Whether mutable locals that never have their address taken are kept in registers, rather than on the stack
+    extern BoundsChecks bounds_checks;
+    bool bounds_checks_enabled(); //Whether indices get checked at runtime, with the current bounds check mode and release mode
     //Add the target information into here once it's feasible to do so
 
     void setup_escape_sequences();
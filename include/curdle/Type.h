@@ -77,9 +77,9 @@ namespace cheese::curdle {
     get_functional_argument_types(Type *type, cheese::project::GlobalContext *gctx);
 
     memory::garbage_collection::gcref<Type>
-    get_true_subtype(memory::garbage_collection::garbage_collector &gc, Type *type, std::size_t num_subindices);
+    get_true_subtype(cheese::project::GlobalContext *gctx, Type *type, std::size_t num_subindices);
 }
 #define INVALID_CHILD throw CurdleError("key not a comptime child of type " + to_string() + ": " + key, error::ErrorCode::InvalidSubscript)
 #define CATCH_DUNDER_NAME do { if (key == "__name__") { return gctx->gc.gcnew<ComptimeString>(to_string(), ComptimeStringType::get(gctx)); } } while(0)
-#define CATCH_DUNDER_SIZE do { if (key == "__size__") { return gctx->gc.gcnew<ComptimeInteger>(get_cached_type(gctx->global_receiver.get())->get_llvm_size(gctx), IntegerType::get(gctx, false, gctx->machine.data_pointer_size));}} while (0)
+#define CATCH_DUNDER_SIZE do { if (key == "__size__") { return gctx->gc.gcnew<ComptimeInteger>(get_cached_type(gctx->global_receiver.get())->get_llvm_size(gctx), IntegerType::get(gctx, false, gctx->machine.data_pointer_size * 8));}} while (0)
 #endif //CHEESE_TYPE_H
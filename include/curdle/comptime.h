@@ -13,6 +13,7 @@
 #include "memory/garbage_collection.h"
 #include "curdle/Type.h"
 #include "math/BigInteger.h"
+#include "Symbol.h"
 #include "curdle/types/Structure.h"
 #include "parser/nodes/other_nodes.h"
 #include "parser/nodes/single_member_nodes.h"
@@ -56,6 +57,9 @@ namespace cheese::curdle {
 
         virtual bool is_same_as(ComptimeValue *other) = 0;
 
+        // A cheap hash that agrees with is_same_as, values without one all land in the same bucket
+        virtual std::size_t hash();
+
         virtual gcref<ComptimeValue> cast(Type *target_type, garbage_collector &garbageCollector) = 0;
 
         virtual std::string to_string() = 0;
@@ -157,7 +161,7 @@ namespace cheese::curdle {
         Structure *currentStructure;
         ComptimeContext *parent;
         cheese::project::GlobalContext *globalContext;
-        std::unordered_map<std::string, ComptimeVariable *> comptimeVariables;
+        std::unordered_map<Symbol, ComptimeVariable *> comptimeVariables;
         std::vector<std::string> structure_name_stack;
         size_t next_offset_for_structure_name = 0;
 
@@ -187,7 +191,11 @@ namespace cheese::curdle {
 
         std::optional<gcref<ComptimeValue>> try_exec(parser::Node *node, RuntimeContext *rtime = nullptr);
 
-        std::optional<gcref<ComptimeValue>> get(const std::string &name);
+        // A tuple or array literal whose value ends up as target_type anyways is built as it directly, each element
+        // being converted (and packed) as it is evaluated, rather than being built as a literal and cast afterwards
+        std::optional<gcref<ComptimeValue>> try_exec_literal(parser::Node *node, RuntimeContext *rtime, Type *target_type);
+
+        std::optional<gcref<ComptimeValue>> get(Symbol name);
 
         gcref<ComptimeValue> exec(parser::Node *node, RuntimeContext *rtime = nullptr);
 
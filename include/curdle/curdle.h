@@ -25,6 +25,9 @@ namespace cheese::curdle {
 
     bacteria::BacteriaPtr translate_expression(LocalContext *lctx, parser::NodePtr expr);
 
+    // Translates an expression, converting it to the expected type of the context
+    bacteria::BacteriaPtr make_cast(LocalContext *lctx, parser::NodePtr ptr);
+
     gcref<Structure>
     translate_structure(ComptimeContext *ctx, parser::nodes::Structure *structure_node);
 
@@ -14,6 +14,7 @@
 
 #include <string>
 #include <vector>
+#include <unordered_map>
 #include "exception"
 
 namespace cheese::curdle {
@@ -59,7 +60,7 @@ namespace cheese::curdle {
 
         bool matches(const std::vector<PassedFunctionArgument> &otherArgs);
 
-        void generate_code(ComptimeContext *cctx, RuntimeContext *rctx, bool external,
+        void generate_code(ComptimeContext *cctx, RuntimeContext *rctx, bool external, bool is_inline,
                            parser::NodePtr body_ptr, bool is_generator, const std::vector<std::string> &rtime_names);
     };
 
@@ -99,6 +100,12 @@ namespace cheese::curdle {
     };
 
 
+    // An argument set that has already gone through overload resolution, and the function it resolved to
+    struct ResolvedCall {
+        std::vector<PassedFunctionArgument> arguments;
+        ConcreteFunction *function;
+    };
+
     struct FunctionSet : managed_object {
 
         void mark_references() override;
@@ -106,6 +113,9 @@ namespace cheese::curdle {
         ~FunctionSet() override = default;
 
         std::vector<FunctionTemplate *> templates;
+        std::unordered_map<std::size_t, std::vector<ResolvedCall>> resolved_calls; // Keyed by the hash of the arguments, cleared whenever a template is added
+
+        void add_template(FunctionTemplate *function_template);
 
         ConcreteFunction *get(const std::vector<PassedFunctionArgument> &arguments);
 
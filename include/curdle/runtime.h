@@ -8,6 +8,7 @@
 #include "memory/garbage_collection.h"
 #include "curdle/comptime.h"
 #include "curdle/variables.h"
+#include "Symbol.h"
 #include "bacteria/BacteriaReceiver.h"
 #include <string>
 #include <map>
@@ -55,9 +56,9 @@ namespace cheese::curdle {
         Structure *structure;
         Type *functionReturnType{nullptr}; // This is the return type of a function
 
-        std::unordered_map<std::string, RuntimeVariableInfo> variables;
+        std::unordered_map<Symbol, RuntimeVariableInfo> variables;
 
-        std::optional<RuntimeVariableInfo> get(const std::string &name);
+        std::optional<RuntimeVariableInfo> get(Symbol name);
 
         std::pair<gcref<Type>, bool> get_lvalue_type(parser::Node *node);
 
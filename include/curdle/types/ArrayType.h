@@ -20,6 +20,9 @@ namespace cheese::curdle {
 
         ArrayType(Type *subtype, std::vector<std::size_t> dimensions, bool constant);
 
+        static ArrayType *get(GlobalContext *gctx, Type *subtype, const std::vector<std::size_t> &dimensions,
+                              bool constant);
+
         ~ArrayType() override = default;
 
 
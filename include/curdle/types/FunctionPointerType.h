@@ -25,6 +25,11 @@ namespace cheese::curdle {
 
         std::string to_string() override;
 
+        FunctionPointerType(Type *return_type, std::vector<Type *> argument_types);
+
+        static FunctionPointerType *
+        get(cheese::project::GlobalContext *gctx, Type *return_type, const std::vector<Type *> &argument_types);
+
         ~FunctionPointerType() override = default;
 
         Type *return_type;
@@ -20,6 +20,8 @@ namespace cheese::curdle {
 
         PointerType(Type *subtype, bool constant);
 
+        static PointerType *get(GlobalContext *gctx, Type *subtype, bool constant);
+
         ~PointerType() override = default;
 
 
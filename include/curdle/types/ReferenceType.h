@@ -14,6 +14,8 @@ namespace cheese::curdle {
     struct ReferenceType : Type {
         ReferenceType(Type *child, bool constant) : child(child), constant(constant) {}
 
+        static ReferenceType *get(GlobalContext *gctx, Type *child, bool constant);
+
         bacteria::TypePtr get_bacteria_type(bacteria::nodes::BacteriaProgram *program) override;
 
         void mark_type_references() override;
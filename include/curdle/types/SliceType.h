@@ -0,0 +1,37 @@
+#ifndef CHEESE_SLICETYPE_H
+#define CHEESE_SLICETYPE_H
+
+#include "curdle/Type.h"
+#include "project/GlobalContext.h"
+
+using namespace cheese::project;
+namespace cheese::curdle {
+    // A pointer paired with the amount of items it points to, single dimensional arrays implicitly convert to these
+    struct SliceType : Type {
+        memory::garbage_collection::gcref<ComptimeValue>
+        get_child_comptime(std::string key, cheese::project::GlobalContext *gc) override;
+
+        bacteria::TypePtr get_bacteria_type(bacteria::nodes::BacteriaProgram *program) override;
+
+        void mark_type_references() override;
+
+        SliceType(Type *subtype, bool constant);
+
+        static SliceType *get(GlobalContext *gctx, Type *subtype, bool constant);
+
+        ~SliceType() override = default;
+
+
+        Comptimeness get_comptimeness() override;
+
+        int32_t compare(Type *other, bool implicit = true) override;
+
+        std::string to_string() override;
+
+        memory::garbage_collection::gcref<Type> peer(Type *other, cheese::project::GlobalContext *gctx) override;
+
+        Type *subtype;
+        bool constant;
+    };
+}
+#endif //CHEESE_SLICETYPE_H
@@ -8,9 +8,11 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include "parser/node.h"
 #include "curdle/Interface.h"
 #include "curdle/variables.h"
+#include "Symbol.h"
 #include "curdle/functions.h"
 #include "curdle/comptime.h"
 #include "project/GlobalContext.h"
@@ -28,7 +30,7 @@ namespace cheese::curdle {
     };
 
     struct LazyValue {
-        std::string name; // The name of the lazy value
+        Symbol name; // The name of the lazy value
         parser::NodePtr node; // The parser node that this corresponds to
     };
 
@@ -49,15 +51,25 @@ namespace cheese::curdle {
         bool is_tuple{false};
         bool implicit_type{false}; // If it is an implicit type, then it should compare to any other type
         std::vector<StructureField> fields;
-        std::map<std::string, TopLevelVariableInfo> top_level_variables;
-        std::map<std::string, ComptimeVariableInfo> comptime_variables;
+        std::map<Symbol, TopLevelVariableInfo> top_level_variables;
+        std::map<Symbol, ComptimeVariableInfo> comptime_variables;
         std::vector<LazyValue *> lazies;
+        std::unordered_map<Symbol, std::vector<std::size_t>> unresolved_lazies; // Indices into lazies by name, a name is removed once all of its lazies are resolved
         std::vector<Interface *> interfaces; // Separate from mixins as it isn't defining functions outside the structure
-        std::map<std::string, FunctionSet *> function_sets;
+        std::map<Symbol, FunctionSet *> function_sets;
+        // Layout controls, set from comptime blocks in the structure body via $packed, $align and $reorderFields
+        bool packed{false};
+        // Fields stay in declaration order unless this is set, as structures get passed to imported C functions, which
+        // expect them laid out the way they were declared
+        bool reorder_fields{false};
+        std::uint64_t alignment{0}; // 0 means the natural alignment
+        std::unordered_map<std::string, std::uint64_t> field_alignments;
         std::string name; // Structures must have names bound to them, at some point, unbound names start with ::(counter) which places where names can be bound automatically bind it by matching for a structure name starting with "::"
+        void add_lazy(Symbol lazy_name, parser::NodePtr node);
+
         void resolve_lazy(LazyValue *&lazy);
 
-        void resolve_by_name(const std::string &name);
+        void resolve_by_name(Symbol name);
 
 
         void search_entry();
@@ -0,0 +1,36 @@
+#ifndef CHEESE_VECTORTYPE_H
+#define CHEESE_VECTORTYPE_H
+
+#include "curdle/Type.h"
+#include "project/GlobalContext.h"
+
+using namespace cheese::project;
+namespace cheese::curdle {
+    // A SIMD vector of a fixed amount of lanes, arithmetic on it is done lane by lane
+    struct VectorType : Type {
+        memory::garbage_collection::gcref<ComptimeValue>
+        get_child_comptime(std::string key, cheese::project::GlobalContext *gc) override;
+
+        bacteria::TypePtr get_bacteria_type(bacteria::nodes::BacteriaProgram *program) override;
+
+        void mark_type_references() override;
+
+        VectorType(Type *subtype, std::uint64_t lanes);
+
+        static VectorType *get(GlobalContext *gctx, Type *subtype, std::uint64_t lanes);
+
+        ~VectorType() override = default;
+
+        Comptimeness get_comptimeness() override;
+
+        int32_t compare(Type *other, bool implicit = true) override;
+
+        std::string to_string() override;
+
+        memory::garbage_collection::gcref<Type> peer(Type *other, cheese::project::GlobalContext *gctx) override;
+
+        Type *subtype;
+        std::uint64_t lanes;
+    };
+}
+#endif //CHEESE_VECTORTYPE_H
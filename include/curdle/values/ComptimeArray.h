@@ -6,6 +6,7 @@
 #define CHEESE_COMPTIMEARRAY_H
 
 #include "curdle/comptime.h"
+#include <functional>
 
 namespace cheese::curdle {
     struct ComptimeArray : ComptimeValue {
@@ -13,6 +14,12 @@ namespace cheese::curdle {
 
         std::vector<ComptimeValue *> values;
 
+        // Arrays where every element is the same integer or float type keep their elements unboxed in packed_data
+        // instead, as raw little endian values, elements only get boxed when they are asked for one at a time
+        // comptime_int elements are packed as 64 bit signed values, for as long as every one of them fits
+        Type *element_type{nullptr};
+        std::vector<std::uint8_t> packed_data;
+
         ~ComptimeArray() override = default;
 
         bool is_same_as(ComptimeValue *other) override;
@@ -23,7 +30,66 @@ namespace cheese::curdle {
             this->type = type;
         }
 
+        ComptimeArray(Type *type, Type *element_type, std::vector<std::uint8_t> packed_data)
+                : element_type(element_type), packed_data(std::move(packed_data)) {
+            this->type = type;
+        }
+
         std::string to_string() override;
+
+        // Equality goes over the packed data as a whole rather than element by element
+        gcref<ComptimeValue> op_equal(GlobalContext *gctx, ComptimeValue *other) override;
+
+        gcref<ComptimeValue> op_not_equal(GlobalContext *gctx, ComptimeValue *other) override;
+
+        [[nodiscard]] bool is_packed() const {
+            return element_type != nullptr;
+        }
+
+        std::size_t size();
+
+        gcref<ComptimeValue> get(garbage_collector &garbageCollector, std::size_t index);
+
+        // These read a packed element without boxing it
+        math::BigInteger integer_at(std::size_t index);
+
+        double float_at(std::size_t index);
+
+        // The element type an array of this type gets packed with, or null if it can't be packed
+        static Type *get_packed_element_type(Type *type);
+
+        static std::size_t get_element_size(Type *element_type);
+
+        // Builds an array up one element at a time, packing each element as it comes in for as long as they all have
+        // the same packable type, so a large literal never has all of its elements boxed at once
+        struct Builder {
+            explicit Builder(garbage_collector &garbageCollector) : garbageCollector(garbageCollector) {}
+
+            void push(gcref<ComptimeValue> value);
+
+            gcref<ComptimeValue> finish(Type *type);
+
+        private:
+            // Boxes everything packed so far, once an element comes in that can't be packed with the rest
+            void unpack();
+
+            garbage_collector &garbageCollector;
+            Type *element_type{nullptr};
+            std::vector<std::uint8_t> packed_data;
+            std::vector<ComptimeValue *> values;
+            std::vector<gcref<ComptimeValue>> refs;
+            bool packing{true};
+        };
+
+    private:
+        bool is_integer_element();
+
+        // Whether a boxed value is the same as a packed element
+        bool element_is(std::size_t index, ComptimeValue *value);
+
+        // Casts every element to the type it has in the target, packing the result if the target can be packed
+        gcref<ComptimeValue> cast_elements(Type *target_type, garbage_collector &garbageCollector,
+                                           const std::function<Type *(std::size_t)> &element_type_at);
     };
 }
 #endif //CHEESE_COMPTIMEARRAY_H
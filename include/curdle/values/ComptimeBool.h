@@ -22,6 +22,8 @@ namespace cheese::curdle {
 
         bool is_same_as(ComptimeValue *other) override;
 
+        std::size_t hash() override;
+
         gcref<ComptimeValue> cast(Type *target_type, garbage_collector &garbageCollector) override;
 
         std::string to_string() override;
@@ -19,6 +19,8 @@ namespace cheese::curdle {
 
         bool is_same_as(ComptimeValue *other) override;
 
+        std::size_t hash() override;
+
         std::string to_string() override;
 
         gcref<ComptimeValue> cast(Type *target_type, garbage_collector &garbageCollector) override;
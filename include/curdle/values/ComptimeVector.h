@@ -0,0 +1,43 @@
+#ifndef CHEESE_COMPTIMEVECTOR_H
+#define CHEESE_COMPTIMEVECTOR_H
+
+#include "curdle/comptime.h"
+#include "project/GlobalContext.h"
+
+using namespace cheese::project;
+
+namespace cheese::curdle {
+    struct VectorType;
+
+    struct ComptimeVector : ComptimeValue {
+        explicit ComptimeVector(Type *type, std::vector<ComptimeValue *> values) : values(std::move(values)) {
+            this->type = type;
+        }
+
+        // Broadcasts a scalar to every lane of a vector type, casting it to the lane type first
+        static gcref<ComptimeValue> splat(ComptimeValue *scalar, VectorType *type, garbage_collector &garbageCollector);
+
+        void mark_value() override;
+
+        std::vector<ComptimeValue *> values;
+
+        ~ComptimeVector() override = default;
+
+        bool is_same_as(ComptimeValue *other) override;
+
+        std::string to_string() override;
+
+        gcref<ComptimeValue> cast(Type *target_type, garbage_collector &garbageCollector) override;
+
+        gcref<ComptimeValue> op_multiply(GlobalContext *gctx, ComptimeValue *other) override;
+
+        gcref<ComptimeValue> op_divide(GlobalContext *gctx, ComptimeValue *other) override;
+
+        gcref<ComptimeValue> op_remainder(GlobalContext *gctx, ComptimeValue *other) override;
+
+        gcref<ComptimeValue> op_add(GlobalContext *gctx, ComptimeValue *other) override;
+
+        gcref<ComptimeValue> op_subtract(GlobalContext *gctx, ComptimeValue *other) override;
+    };
+}
+#endif //CHEESE_COMPTIMEVECTOR_H
@@ -7,11 +7,14 @@
 
 #include <vector>
 #include <string>
+#include <optional>
 #include "comptime.h"
+#include "math/BigInteger.h"
 
 namespace cheese::curdle {
     struct ComptimeValue;
     struct Type;
+    struct RuntimeContext;
     struct TopLevelVariableInfo {
         bool constant;
         bool pub; //Vi
@@ -30,6 +33,10 @@ namespace cheese::curdle {
         bool constant;
         std::string runtime_name;
         Type *type;
+        // Loop counters that can only ever be within this inclusive range, so indexing with them may skip bounds checks
+        std::optional<std::pair<math::BigInteger, math::BigInteger>> range{};
+        // Loop counters over a slice, along with the context declaring that slice, are always in bounds of it
+        std::optional<std::pair<RuntimeContext *, std::string>> index_of{};
     };
 
 }
@@ -89,10 +89,12 @@ namespace cheese::error {
         InvalidComptimeOperation,
         InvalidRuntimeOperation,
         InvalidDimension,
+        InvalidForLoop,
 
         InvalidReturn = generator_error_start,
         InvalidComparison,
         InvalidIndex,
+        UnsupportedCallingConvention,
         //General error (thrown for example when multiple previous errors were printed)
         GeneralCompilerError = 9999,
     };
@@ -6,6 +6,7 @@
 #define CHEESE_LEXER_H
 
 #include "../Coordinate.h"
+#include "../Symbol.h"
 #include <map>
 
 namespace cheese::lexer {
@@ -195,6 +196,7 @@ namespace cheese::lexer {
         Coordinate location;
         TokenType ty;
         std::string_view value;
+        Symbol symbol{}; // Only set for identifiers, interned here so the rest of the compiler never rehashes the name
     };
 
     std::vector<Token> lex(std::string_view buffer, std::string filename = "unknown", bool errorInvalid = true,
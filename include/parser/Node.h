@@ -9,7 +9,9 @@
 #include <memory>
 #include "../../external/json.hpp"
 #include "Coordinate.h"
+#include "Symbol.h"
 #include "math/BigInteger.h"
+#include "util/TreeWriter.h"
 #include <optional>
 #include <iostream>
 
@@ -24,6 +26,9 @@ namespace cheese::parser {
 
         [[nodiscard]] virtual bool compare_json(const nlohmann::json &) const = 0;
 
+        // Streams the same json form as as_json into the writer, without building the whole document in memory
+        virtual void write_json(util::TreeWriter &writer) const = 0;
+
         virtual ~Node() = default;
 
         std::shared_ptr<Node> get();
@@ -125,6 +130,9 @@ namespace cheese::parser {
     template<>
     void build_json<math::BigInteger>(nlohmann::json &object, std::string name, const math::BigInteger &value);
 
+    template<>
+    void build_json<Symbol>(nlohmann::json &object, std::string name, const Symbol &value);
+
     template<typename J>
     void build_json(nlohmann::json &object, std::string name, const std::optional<J> &value) {
         if (implicit_compare_value(value)) return;
@@ -134,6 +142,31 @@ namespace cheese::parser {
     template<>
     void build_json<NodeDict>(nlohmann::json &object, std::string name, const NodeDict &value);
 
+    void stream_json(util::TreeWriter &writer, const std::string &name, const NodePtr &value);
+
+    void stream_json(util::TreeWriter &writer, const std::string &name, const NodeList &value);
+
+    void stream_json(util::TreeWriter &writer, const std::string &name, const FlagSet &value);
+
+    void stream_json(util::TreeWriter &writer, const std::string &name, const math::BigInteger &value);
+
+    void stream_json(util::TreeWriter &writer, const std::string &name, const Symbol &value);
+
+    void stream_json(util::TreeWriter &writer, const std::string &name, const NodeDict &value);
+
+    template<typename T>
+    void stream_json(util::TreeWriter &writer, const std::string &name, const T &value) {
+        if (implicit_compare_value(value)) return;
+        writer.key(name);
+        writer.value(value);
+    }
+
+    template<typename J>
+    void stream_json(util::TreeWriter &writer, const std::string &name, const std::optional<J> &value) {
+        if (implicit_compare_value(value)) return;
+        stream_json(writer, name, value.value());
+    }
+
     template<typename T, typename ...Ts>
     void implicit_compare_check(bool &success, T &arg, Ts &... args) {
         if (!implicit_compare_value(arg)) {
@@ -205,6 +238,34 @@ namespace cheese::parser {
         build_json_helper<0>(result, arg_names, args...);
         return result;
     }
+
+    template<size_t idx>
+    void stream_json_helper(util::TreeWriter &writer, const std::vector<std::string> &arg_names) {
+    }
+
+    template<size_t idx, typename T, typename... Ts>
+    void stream_json_helper(util::TreeWriter &writer, const std::vector<std::string> &arg_names, const T &arg,
+                            const Ts &... args) {
+        if (idx >= arg_names.size()) return;
+
+        stream_json(writer, arg_names[idx], arg);
+        stream_json_helper<idx + 1>(writer, arg_names, args...);
+    }
+
+    // The streaming counterpart to build_json, writing a node with the given type and members
+    template<typename ...Ts>
+    void stream_json_node(util::TreeWriter &writer, const std::string &type, const std::vector<std::string> &arg_names,
+                          const Ts &... args) {
+        bool all_implicit = true;
+        implicit_compare_check(all_implicit, args...);
+        if (all_implicit) {
+            writer.value(type);
+            return;
+        }
+        writer.begin_node(type);
+        stream_json_helper<0>(writer, arg_names, args...);
+        writer.end_object();
+    }
 }
 
 
@@ -215,6 +276,9 @@ namespace cheese::parser {
     [[nodiscard]] nlohmann::json as_json() const override {             \
         return build_json(T,{});                   \
     }                                                \
+    void write_json(util::TreeWriter& writer) const override { \
+        stream_json_node(writer,T,{});             \
+    }                                                \
     [[nodiscard]] bool compare_json(const nlohmann::json& o) const override {   \
         return compare_helper(o,T);               \
     }                                              \
@@ -228,6 +292,9 @@ namespace cheese::parser {
     [[nodiscard]] nlohmann::json as_json() const override {                       \
         return build_json(T,{# CN},CN);                       \
     }                                                         \
+    void write_json(util::TreeWriter& writer) const override {                    \
+        stream_json_node(writer,T,{# CN},CN);                 \
+    }                                                         \
     [[nodiscard]] bool compare_json(const nlohmann::json& o) const override {            \
         return compare_helper(o,T,{# CN},CN);                       \
     }                                                         \
@@ -243,6 +310,9 @@ namespace cheese::parser {
     [[nodiscard]] nlohmann::json as_json() const override {                       \
         return build_json(T,{"child","constant"},child,constant);                       \
     }                                                         \
+    void write_json(util::TreeWriter& writer) const override {                    \
+        stream_json_node(writer,T,{"child","constant"},child,constant);                 \
+    }                                                         \
     [[nodiscard]] bool compare_json(const nlohmann::json& o) const override {            \
         return compare_helper(o,T,{"child","constant"},child,constant);                       \
     }                                                         \
@@ -256,6 +326,9 @@ namespace cheese::parser {
     [[nodiscard]] nlohmann::json as_json() const override {                                \
         return build_json(T,{# C1N,# C2N},C1N,C2N);                  \
     }                                                                  \
+    void write_json(util::TreeWriter& writer) const override {                             \
+        stream_json_node(writer,T,{# C1N,# C2N},C1N,C2N);            \
+    }                                                                  \
     [[nodiscard]] bool compare_json(const nlohmann::json& o) const override {                      \
         return compare_helper(o,T,{# C1N, # C2N},C1N,C2N);                                                               \
     }\
@@ -272,6 +345,10 @@ namespace cheese::parser {
 [[nodiscard]] bool compare_json(const nlohmann::json& o) const override       \
 {                                                                             \
     return compare_helper(o, __VA_ARGS__);                                        \
+} \
+void write_json(cheese::util::TreeWriter& writer) const override              \
+{                                                                             \
+    stream_json_node(writer, __VA_ARGS__);                                        \
 }
 
 #endif //CHEESE_NODE_H
@@ -130,6 +130,10 @@ namespace cheese::parser::nodes {
             return compare_helper(json, "field", {"name", "field_type", "flags"}, name, type, flags);
         }
 
+        void write_json(util::TreeWriter &writer) const override {
+            stream_json_node(writer, "field", {"name", "field_type", "flags"}, name, type, flags);
+        }
+
         ~Field() override = default;
 
     };
@@ -163,6 +167,8 @@ namespace cheese::parser::nodes {
 
         [[nodiscard]] bool compare_json(const nlohmann::json &) const override;
 
+        void write_json(util::TreeWriter &writer) const override;
+
         ~Import() override = default;
     };
 
@@ -182,6 +188,8 @@ namespace cheese::parser::nodes {
 
         [[nodiscard]] bool compare_json(const nlohmann::json &) const override;
 
+        void write_json(util::TreeWriter &writer) const override;
+
         ~Structure() override = default;
     };
 
@@ -26,7 +26,7 @@ namespace cheese::parser::nodes {
     //[float_literal]I
     SINGLE_MEMBER_NODE(ImaginaryLiteral, "imaginary", double, value)
     //[identifier]
-    SINGLE_MEMBER_NODE(ValueReference, "ref", std::string, name)
+    SINGLE_MEMBER_NODE(ValueReference, "ref", Symbol, name)
     //{...}
     SINGLE_MEMBER_NODE(UnnamedBlock, "unnamed_block", NodeList, children)
     //.(...)
@@ -16,11 +16,25 @@
 #include "bacteria/BacteriaReceiver.h"
 #include "bacteria/nodes/receiver_nodes.h"
 #include "Machine.h"
+#include "ParseCache.h"
 #include <set>
+#include <map>
+#include <tuple>
+#include <typeindex>
+#include "curdle/enums/SimpleOperation.h"
 
 namespace cheese::curdle {
     struct Structure;
     struct FunctionTemplate;
+    struct Type;
+    struct ArrayType;
+    struct PointerType;
+    struct ReferenceType;
+    struct SliceType;
+    struct VectorType;
+    struct FunctionPointerType;
+    struct IntegerType;
+    struct ComposedFunctionType;
 }
 
 namespace cheese::project {
@@ -49,6 +63,10 @@ namespace cheese::project {
         size_t anonymous_variable_offset{0};
         std::set<std::string> all_struct_names;
         std::set<std::string> imported_functions;
+        // Every file parsed for this build, so that anything holding on to the result knows when it has gone stale
+        std::set<fs::path> read_files;
+        // When set, imports are parsed through this rather than from scratch, see tools::serve
+        ParseCache *parse_cache = nullptr;
 
         std::string verify_name(std::string struct_name);
 
@@ -61,16 +79,38 @@ namespace cheese::project {
 
         Structure *import_structure(Coordinate location, std::string path, fs::path dir, fs::path pdir);
 
+        parser::NodePtr parse_import(const fs::path &path);
+
         ~GlobalContext() override = default;
 
         std::string get_anonymous_variable(const std::string &base) {
             return "__" + base + "__" + std::to_string(anonymous_variable_offset++);
         }
 
-        // This is a lookup for cached objects
-        std::unordered_map<std::string, managed_object *> cached_objects;
+        // Types with only one instance, looked up by their C++ type
+        std::unordered_map<std::type_index, managed_object *> singleton_types;
+
+        template<typename T>
+        T *get_singleton() {
+            if (auto it = singleton_types.find(typeid(T)); it != singleton_types.end()) {
+                return static_cast<T *>(it->second);
+            }
+            auto ref = gc.gcnew<T>();
+            singleton_types[typeid(T)] = ref;
+            return ref;
+        }
 
-        bool try_get_cached_object(std::string key, managed_object *&out_value);
+        // Indexed by size * 2 + sign, grown whenever a wider integer type gets asked for
+        std::vector<IntegerType *> integer_types;
+        std::map<std::pair<enums::SimpleOperation, std::vector<Type *>>, ComposedFunctionType *> composed_function_types;
+
+        // Composite types are interned by their parts, so that identical types are always the same object
+        std::map<std::tuple<Type *, std::vector<std::uint64_t>, bool>, ArrayType *> array_types;
+        std::map<std::pair<Type *, bool>, PointerType *> pointer_types;
+        std::map<std::pair<Type *, bool>, ReferenceType *> reference_types;
+        std::map<std::pair<Type *, bool>, SliceType *> slice_types;
+        std::map<std::pair<Type *, std::uint64_t>, VectorType *> vector_types;
+        std::map<std::pair<Type *, std::vector<Type *>>, FunctionPointerType *> function_pointer_types;
 
     };
 }
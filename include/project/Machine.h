@@ -21,6 +21,8 @@ namespace cheese::curdle {
     // This defines information about the target machine
     struct Machine {
         std::string triple;
+        std::string cpu;
+        std::string features;
         const llvm::Target *target;
         llvm::TargetMachine *machine;
         util::Endianness endianness;
@@ -31,17 +33,39 @@ namespace cheese::curdle {
         std::size_t data_pointer_addr;
         llvm::DataLayout layout = llvm::DataLayout{""};
 
-        Machine(std::string in_triple = llvm::sys::getDefaultTargetTriple(), std::string cpu = "generic",
-                std::string features = "") {
+        // Gets the features of the cpu being compiled on, in the form LLVM expects (+avx2,-avx512f,...)
+        static std::string get_host_features() {
+            llvm::StringMap<bool> host_features;
+            std::string result;
+            if (!llvm::sys::getHostCPUFeatures(host_features)) return result;
+            for (auto &feature: host_features) {
+                if (!result.empty()) result += ',';
+                result += feature.getValue() ? '+' : '-';
+                result += feature.getKey().str();
+            }
+            return result;
+        }
+
+        // "native" can be passed as either the cpu or the features to target the machine being compiled on, where a native
+        // cpu w/o any explicit features also brings along every feature of the host
+        Machine(std::string in_triple = llvm::sys::getDefaultTargetTriple(), std::string in_cpu = "generic",
+                std::string in_features = "") {
             // This could have side effects, but they will only be run once, and if we get to this point we need them
             cheese::util::llvm::initialize_llvm();
             triple = in_triple;
+            if (in_cpu == "native") {
+                cpu = llvm::sys::getHostCPUName().str();
+                if (in_features.empty()) in_features = "native";
+            } else {
+                cpu = in_cpu;
+            }
+            features = in_features == "native" ? get_host_features() : in_features;
             // Now we set everything else up
             std::string error;
             target = llvm::TargetRegistry::lookupTarget(triple, error);
             if (!target) {
                 std::string err = "LLVM Error: " + error;
-                throw error::CompilerError(cheese::Coordinate{0, 0, 0}, error::ErrorCode::GeneralCompilerError, err);
+                throw error::CompilerError(cheese::Coordinate{}, error::ErrorCode::GeneralCompilerError, err);
             }
             llvm::TargetOptions opt;
             auto reloc = llvm::Optional<llvm::Reloc::Model>();
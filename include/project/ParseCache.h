@@ -0,0 +1,53 @@
+#ifndef CHEESE_PARSECACHE_H
+#define CHEESE_PARSECACHE_H
+
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include "parser/parser.h"
+
+namespace cheese::project {
+    namespace fs = std::filesystem;
+
+    // Parsed files that outlive a single build, a file only gets lexed and parsed again once it has been written to
+    // Curdling never changes a parse tree, so the same tree can be handed out to every build that imports the file
+    struct ParseCache {
+        // What a file looked like on disk, taken before it is read, so that a write racing the read is still noticed
+        struct Stamp {
+            fs::file_time_type write_time;
+            std::uintmax_t size;
+
+            static Stamp of(const fs::path &path);
+
+            static Stamp of(const fs::path &path, std::error_code &ec);
+
+            bool operator==(const Stamp &other) const = default;
+        };
+
+        struct Entry {
+            Stamp stamp;
+            parser::NodePtr tree;
+            std::string diagnostics; // Everything the lexer and parser reported, replayed whenever the tree is reused
+            std::uint32_t source_offset; // Where the buffer lives in the source manager, released once replaced
+        };
+
+        std::unordered_map<fs::path, Entry> entries;
+
+        // Keyed on the absolute path, as the server builds from many working directories
+        parser::NodePtr parse(const fs::path &path);
+
+        // The stamp of a file as it was when its cached tree was parsed
+        [[nodiscard]] const Stamp &get_stamp(const fs::path &path) const;
+
+        // The locations in every cached tree point into the source manager, whose offsets run out after 4 GiB of
+        // source, so once too many have been used up everything is dropped and the source manager starts over
+        // This may only be called between builds, as it invalidates every tree and location handed out before it
+        void start_generation();
+    };
+
+    // Reads, lexes, and parses a file, going through the cache if there is one
+    parser::NodePtr parse_file(const fs::path &path, ParseCache *cache = nullptr);
+}
+
+#endif //CHEESE_PARSECACHE_H
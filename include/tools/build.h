@@ -6,8 +6,25 @@
 #define CHEESE_BUILD_H
 
 #include "tools.h"
+#include <filesystem>
+#include <set>
+#include <string>
+#include <vector>
+#include "project/ParseCache.h"
 
 namespace cheese::tools {
     int build(std::vector<std::string>);
+
+    // What a build read and wrote, which is what the build server needs to know to tell when a build has gone stale
+    struct BuildRecord {
+        std::set<std::filesystem::path> inputs; // Absolute paths of the root file and every file it imported
+        std::vector<std::string> outputs;
+    };
+
+    void add_build_arguments(argparse::ArgumentParser &parser); //Adds the arguments of the build tool, shared with serve
+
+    // Runs a build described by arguments that were added with add_build_arguments, parsing through the cache if given
+    BuildRecord run_build(argparse::ArgumentParser &parser, curdle::Machine &machine,
+                          project::ParseCache *parse_cache = nullptr);
 }
 #endif //CHEESE_BUILD_H
@@ -0,0 +1,45 @@
+#ifndef CHEESE_EMIT_H
+#define CHEESE_EMIT_H
+
+#include <string>
+#include <vector>
+#include <argparse/argparse.hpp>
+#include <llvm/IR/Module.h>
+#include <llvm/Target/TargetMachine.h>
+#include "bacteria/BacteriaNode.h"
+#include "bacteria/nodes/receiver_nodes.h"
+#include "project/GlobalContext.h"
+
+namespace cheese::tools {
+    // Every artifact the tools that lower a program can write out
+    enum class EmitKind {
+        Bacteria, // The textual bacteria after the default passes
+        BacteriaJson, // The same bacteria in the json form used by the tests
+        BacteriaBinary, // The same bacteria in the binary tree format
+        LLVM, // Textual LLVM IR
+        Bitcode, // LLVM bitcode
+        Assembly, // Assembly for the target machine
+        Object, // An object file for the target machine
+    };
+
+    void add_emit_arguments(argparse::ArgumentParser &parser,
+                            const std::string &default_emit); //Adds --emit, defaulting to a comma separated list of kinds
+    std::vector<EmitKind> get_emit_kinds(argparse::ArgumentParser &parser); //Parses --emit, erroring on unknown kinds
+
+    // Whether any of the kinds needs the program lowered into an LLVM module
+    bool needs_module(const std::vector<EmitKind> &kinds);
+
+    // Where an artifact goes, when only one kind is emitted it goes straight to the output, otherwise the extension of
+    // the output is swapped out for the extension of the kind
+    std::string get_emit_path(const std::string &output, EmitKind kind, bool only_kind);
+
+    void emit_bacteria(const std::string &path, EmitKind kind, bacteria::BacteriaNode *program);
+
+    void emit_module(const std::string &path, EmitKind kind, llvm::Module &mod, llvm::TargetMachine *machine);
+
+    // Writes every requested artifact for a program, only lowering it into a module when an LLVM artifact is requested
+    void emit(const std::string &output, const std::vector<EmitKind> &kinds, bacteria::nodes::BacteriaProgram *program,
+              project::GlobalContext *ctx, llvm::TargetMachine *machine);
+}
+
+#endif //CHEESE_EMIT_H
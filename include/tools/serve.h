@@ -0,0 +1,21 @@
+#ifndef CHEESE_SERVE_H
+#define CHEESE_SERVE_H
+
+#include "tools.h"
+#include <filesystem>
+#include "../../external/json.hpp"
+
+namespace cheese::tools {
+    // Runs a long lived build server on a local socket, or with --send, sends it a build and waits for the result
+    // The server caches parse trees and memoizes whole builds, a build whose inputs changed is redone in full
+    int serve(std::vector<std::string>);
+
+#ifndef WIN32
+    // Serves requests on the socket until one asks it to shut down
+    int run_server(const std::filesystem::path &socket_path);
+
+    // Sends a single request to a running server, returning its response
+    nlohmann::json send_request(const std::filesystem::path &socket_path, const std::vector<std::string> &args);
+#endif
+}
+#endif //CHEESE_SERVE_H
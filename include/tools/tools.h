@@ -8,12 +8,18 @@
 #include <functional>
 #include <vector>
 #include <unordered_map>
+#include "project/Machine.h"
 namespace cheese::tools {
     typedef std::function<int(std::vector<std::string>)> CheeseTool;
     extern std::unordered_map<std::string, CheeseTool> tools;
 
-    argparse::ArgumentParser get_parser(std::string name); //Adds common arguments depending on the tool being run
+    extern const char *version;
+
+    argparse::ArgumentParser get_parser(std::string name, argparse::default_arguments default_arguments =
+            argparse::default_arguments::all); //Adds common arguments depending on the tool being run
     void process_common_arguments(argparse::ArgumentParser& parser); //Processes common arguments
+    void add_machine_arguments(argparse::ArgumentParser& parser); //Adds the target triple/cpu/feature arguments for tools that generate code
+    curdle::Machine get_machine(argparse::ArgumentParser& parser); //Creates the machine described by the target arguments
 }
 
 #endif //CHEESE_TOOLS_H
@@ -0,0 +1,226 @@
+#ifndef CHEESE_BINARYTREE_H
+#define CHEESE_BINARYTREE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "util/TreeWriter.h"
+
+// A compact binary encoding of the json form of parse trees and bacteria programs, written in one pass and readable
+// in place (say from a memory mapped file) without ever rebuilding the tree
+//
+// Trees exported in it hold exactly what the json form holds, which leaves out source locations and flattens types down
+// to their names, so no parse tree or program can be rebuilt from one, those exports are meant for external tools
+// reading the trees and for comparing them
+// The build server keeps its finished builds on disk in this format, as plain data rather than as trees
+//
+// The testenv fixtures stay json, they are written and edited by hand, hold templates that get expanded when they are
+// loaded, and are checked with compare_json, none of which a binary file helps with
+//
+// Everything is little endian, and laid out as
+//  header: the magic "CHBT" then a u32 version
+//  blocks: one per array, object, or node, every block comes after the blocks of its children
+//  string table: a u32 count, then a u64 offset for each string, then each string as a u32 length followed by its bytes
+//  footer: the root slot, the u64 offset of the string table, a u32 version, then the magic again
+//
+// A block is a u32 count and a u32 kind (the string index of a nodes kind, or no_index) followed by count slots
+// A slot is 16 bytes: a u32 key (the string index of the key, or no_index in arrays), a u8 tag, 3 bytes of padding, and
+// a u64 payload holding the value itself for scalars, the string index for strings, or the offset of the block for
+// containers
+namespace cheese::util {
+    constexpr std::uint32_t binary_tree_version = 1;
+    constexpr std::uint32_t no_index = UINT32_MAX;
+
+    enum class BinaryTag : std::uint8_t {
+        Null,
+        False,
+        True,
+        Int,
+        UInt,
+        Double,
+        String,
+        Array,
+        Object,
+        Node, // An object with a kind, the json form of which has the kind as its "type"
+    };
+
+    struct BinarySlot {
+        std::uint32_t key = no_index;
+        BinaryTag tag = BinaryTag::Null;
+        std::uint64_t payload = 0;
+    };
+
+    class BinaryTreeWriter final : public TreeWriter {
+    public:
+        explicit BinaryTreeWriter(std::ostream &out);
+
+        using TreeWriter::value;
+
+        void begin_object() override;
+
+        void end_object() override;
+
+        void begin_node(std::string_view kind) override;
+
+        void begin_array() override;
+
+        void end_array() override;
+
+        void key(std::string_view name) override;
+
+        void value(std::string_view v) override;
+
+        void value(bool v) override;
+
+        void value(std::int64_t v) override;
+
+        void value(std::uint64_t v) override;
+
+        void value(double v) override;
+
+        void null() override;
+
+        // Writes out the string table and footer, this must be called once, after the root value has been written
+        void finish();
+
+    private:
+        struct OpenBlock {
+            BinaryTag tag;
+            std::uint32_t key;
+            std::uint32_t kind;
+            std::vector<BinarySlot> slots;
+        };
+
+        std::ostream &out;
+        std::uint64_t offset = 0;
+        std::unordered_map<std::string, std::uint32_t> string_indices;
+        std::vector<std::string> strings;
+        std::vector<OpenBlock> open_blocks;
+        std::uint32_t pending_key = no_index;
+        BinarySlot root{};
+
+        std::uint32_t intern(std::string_view string);
+
+        void add_slot(BinaryTag tag, std::uint64_t payload);
+
+        void begin_block(BinaryTag tag, std::uint32_t kind);
+
+        void end_block();
+
+        void write_u32(std::uint32_t v);
+
+        void write_u64(std::uint64_t v);
+
+        void write_slot(const BinarySlot &slot);
+    };
+
+    // A read only view over a whole encoded tree, either memory mapped from a file or held in memory
+    class BinaryTree {
+    public:
+        // A value somewhere in the tree, this is only ever a few words and is cheap to copy around
+        class Value {
+        public:
+            [[nodiscard]] BinaryTag tag() const {
+                return slot.tag;
+            }
+
+            [[nodiscard]] bool is_null() const {
+                return slot.tag == BinaryTag::Null;
+            }
+
+            [[nodiscard]] bool is_bool() const {
+                return slot.tag == BinaryTag::False || slot.tag == BinaryTag::True;
+            }
+
+            [[nodiscard]] bool is_integer() const {
+                return slot.tag == BinaryTag::Int || slot.tag == BinaryTag::UInt;
+            }
+
+            [[nodiscard]] bool is_string() const {
+                return slot.tag == BinaryTag::String;
+            }
+
+            [[nodiscard]] bool is_array() const {
+                return slot.tag == BinaryTag::Array;
+            }
+
+            // Nodes are objects as well
+            [[nodiscard]] bool is_object() const {
+                return slot.tag == BinaryTag::Object || slot.tag == BinaryTag::Node;
+            }
+
+            [[nodiscard]] bool as_bool() const;
+
+            [[nodiscard]] std::int64_t as_int() const;
+
+            [[nodiscard]] std::uint64_t as_uint() const;
+
+            [[nodiscard]] double as_double() const;
+
+            [[nodiscard]] std::string_view as_string() const;
+
+            // The kind of a node, in the json form a node with nothing but implicit members is just its kind as a
+            // string, so this is the string itself for strings, and empty for anything else
+            [[nodiscard]] std::string_view kind() const;
+
+            // The number of elements or members of an array or object, 0 for anything else
+            [[nodiscard]] std::size_t size() const;
+
+            [[nodiscard]] Value operator[](std::size_t index) const;
+
+            // The key of the member at index in an object
+            [[nodiscard]] std::string_view key(std::size_t index) const;
+
+            [[nodiscard]] std::optional<Value> get(std::string_view name) const;
+
+            // Rebuilds the json form of this value, this is only meant for comparisons and debugging
+            [[nodiscard]] nlohmann::json to_json() const;
+
+        private:
+            friend class BinaryTree;
+
+            Value(const BinaryTree *tree, BinarySlot slot) : tree(tree), slot(slot) {}
+
+            const BinaryTree *tree;
+            BinarySlot slot;
+
+            [[nodiscard]] std::uint64_t block() const;
+        };
+
+        // Maps the file rather than reading it in
+        static BinaryTree open(const std::filesystem::path &path);
+
+        explicit BinaryTree(std::string buffer);
+
+        [[nodiscard]] Value root() const;
+
+        [[nodiscard]] std::string_view string(std::uint32_t index) const;
+
+    private:
+        BinaryTree(std::shared_ptr<const char> data, std::size_t size);
+
+        std::shared_ptr<const char> data;
+        std::size_t size;
+        std::uint64_t string_table;
+        std::uint32_t string_count;
+        std::uint64_t strings_begin; // The bytes of every string lie in [strings_begin, strings_end)
+        std::uint64_t strings_end;
+        BinarySlot root_slot;
+
+        void validate();
+
+        [[nodiscard]] std::uint32_t read_u32(std::uint64_t at) const;
+
+        [[nodiscard]] std::uint64_t read_u64(std::uint64_t at) const;
+
+        [[nodiscard]] BinarySlot read_slot(std::uint64_t at) const;
+    };
+}
+
+#endif //CHEESE_BINARYTREE_H
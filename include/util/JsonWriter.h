@@ -0,0 +1,56 @@
+#ifndef CHEESE_JSONWRITER_H
+#define CHEESE_JSONWRITER_H
+
+#include <ostream>
+#include <vector>
+#include "util/TreeWriter.h"
+
+namespace cheese::util {
+    // Writes json straight to a stream as it is walked, rather than building up a whole nlohmann::json document first
+    // The layout matches nlohmann::json::dump, an indent below 0 writes everything on one line
+    class JsonWriter final : public TreeWriter {
+    public:
+        explicit JsonWriter(std::ostream &out, int indent = -1) : out(out), indent(indent) {}
+
+        using TreeWriter::value;
+
+        void begin_object() override;
+
+        void end_object() override;
+
+        void begin_array() override;
+
+        void end_array() override;
+
+        void key(std::string_view name) override;
+
+        void value(std::string_view v) override;
+
+        void value(bool v) override;
+
+        void value(std::int64_t v) override;
+
+        void value(std::uint64_t v) override;
+
+        void value(double v) override;
+
+        void value(const nlohmann::json &v) override;
+
+        void null() override;
+
+    private:
+        std::ostream &out;
+        int indent;
+        // Whether the container at each level has had anything written into it yet
+        std::vector<bool> written;
+        bool after_key = false;
+
+        void begin_value();
+
+        void new_line();
+
+        void write_string(std::string_view v);
+    };
+}
+
+#endif //CHEESE_JSONWRITER_H
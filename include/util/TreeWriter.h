@@ -0,0 +1,70 @@
+#ifndef CHEESE_TREEWRITER_H
+#define CHEESE_TREEWRITER_H
+
+#include <concepts>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "../../external/json.hpp"
+
+namespace cheese::util {
+    // Something that parse trees and bacteria programs can be streamed into, node by node, in their json form
+    // The json form is only the data model here, what actually gets written depends on the writer
+    class TreeWriter {
+    public:
+        virtual ~TreeWriter() = default;
+
+        virtual void begin_object() = 0;
+
+        virtual void end_object() = 0;
+
+        // Begins an object describing a node of the given kind, ended with end_object
+        // In json this is just an object whose "type" is the kind
+        virtual void begin_node(std::string_view kind) {
+            begin_object();
+            key("type");
+            value(kind);
+        }
+
+        virtual void begin_array() = 0;
+
+        virtual void end_array() = 0;
+
+        // The next value written is the value of this key
+        virtual void key(std::string_view name) = 0;
+
+        virtual void value(std::string_view v) = 0;
+
+        void value(const std::string &v) {
+            value(std::string_view{v});
+        }
+
+        void value(const char *v) {
+            value(std::string_view{v});
+        }
+
+        virtual void value(bool v) = 0;
+
+        virtual void value(std::int64_t v) = 0;
+
+        virtual void value(std::uint64_t v) = 0;
+
+        virtual void value(double v) = 0;
+
+        template<std::integral T>
+        void value(T v) {
+            if constexpr (std::is_signed_v<T>) {
+                value(static_cast<std::int64_t>(v));
+            } else {
+                value(static_cast<std::uint64_t>(v));
+            }
+        }
+
+        // Anything else gets converted to a (hopefully small) json value first
+        virtual void value(const nlohmann::json &v);
+
+        virtual void null() = 0;
+    };
+}
+
+#endif //CHEESE_TREEWRITER_H
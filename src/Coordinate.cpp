@@ -5,26 +5,120 @@
 #include "Coordinate.h"
 #include <ranges>
 #include <algorithm>
+#include <limits>
+#include <stdexcept>
 
 namespace cheese {
-    std::vector<std::string> filenames{};
+    SourceManager source_manager{};
 
-    std::size_t getFileIndex(const std::string &filename) {
-        for (std::size_t i = 0; i < filenames.size(); i++) {
-            if (filename == filenames[i]) {
-                return i;
+    void SourceRange::compute_line_starts() {
+        if (!line_starts.empty()) return;
+        line_starts.push_back(0);
+        for (std::uint32_t i = 0; i < contents.size(); i++) {
+            if (contents[i] == '\n') {
+                line_starts.push_back(i + 1);
             }
         }
+    }
+
+    std::size_t SourceManager::get_file_index(const std::string &filename) {
+        if (auto it = file_indices.find(filename); it != file_indices.end()) {
+            return it->second;
+        }
         filenames.push_back(filename);
+        file_indices[filename] = filenames.size() - 1;
         return filenames.size() - 1;
     }
 
+    const std::string &SourceManager::get_filename(std::size_t file_index) const {
+        return filenames[file_index];
+    }
+
+    std::uint32_t SourceManager::add_source(const std::string &filename, std::string_view contents) {
+        if (contents.size() >= std::numeric_limits<std::uint32_t>::max() - next_base) {
+            throw std::length_error("ran out of source offsets while adding " + filename);
+        }
+        auto base = next_base;
+        next_base += static_cast<std::uint32_t>(contents.size()) + 1;
+        ranges.push_back(SourceRange{get_file_index(filename), base, std::string{contents}, {}});
+        return base;
+    }
+
+    void SourceManager::release_source(std::uint32_t offset) {
+        auto range = find_range(offset);
+        if (range == nullptr) return;
+        range->released = true;
+        range->contents = std::string{};
+        range->line_starts = std::vector<std::uint32_t>{};
+        while (!ranges.empty() && ranges.back().released) {
+            next_base = ranges.back().base;
+            ranges.pop_back();
+        }
+    }
+
+    void SourceManager::reset() {
+        ranges.clear();
+        next_base = 1;
+    }
+
+    std::uint32_t SourceManager::used_offsets() const {
+        return next_base - 1;
+    }
+
+    SourceRange *SourceManager::find_range(std::uint32_t offset) {
+        if (offset == 0) return nullptr;
+        // Ranges are handed out in increasing order, so the last one starting at or before the offset contains it
+        auto it = std::upper_bound(ranges.begin(), ranges.end(), offset,
+                                   [](std::uint32_t off, const SourceRange &range) { return off < range.base; });
+        if (it == ranges.begin()) return nullptr;
+        return &*(it - 1);
+    }
+
+    DecodedCoordinate SourceManager::decode(Coordinate location) {
+        auto range = find_range(location.offset);
+        if (range == nullptr) {
+            return DecodedCoordinate{get_file_index("unknown"), 0, 0};
+        }
+        if (range->released) {
+            return DecodedCoordinate{range->file_index, 0, 0};
+        }
+        range->compute_line_starts();
+        auto relative = location.offset - range->base;
+        auto line = std::upper_bound(range->line_starts.begin(), range->line_starts.end(), relative) - 1;
+        return DecodedCoordinate{
+                range->file_index,
+                static_cast<std::uint32_t>(line - range->line_starts.begin()) + 1,
+                relative - *line + 1
+        };
+    }
+
+    std::optional<std::string_view> SourceManager::get_line(Coordinate location) {
+        auto range = find_range(location.offset);
+        if (range == nullptr || range->released) return {};
+        auto decoded = decode(location);
+        auto start = range->line_starts[decoded.line_number - 1];
+        auto end = decoded.line_number < range->line_starts.size() ? range->line_starts[decoded.line_number] - 1
+                                                                   : static_cast<std::uint32_t>(range->contents.size());
+        auto line = std::string_view{range->contents}.substr(start, end - start);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        return line;
+    }
+
+    std::size_t getFileIndex(const std::string &filename) {
+        return source_manager.get_file_index(filename);
+    }
+
+    DecodedCoordinate Coordinate::decode() const {
+        return source_manager.decode(*this);
+    }
+
     std::string Coordinate::toString() const {
-        return filenames[file_index] + ":" + std::to_string(line_number) + ":" + std::to_string(column_number);
+        auto decoded = decode();
+        return source_manager.get_filename(decoded.file_index) + ":" + std::to_string(decoded.line_number) + ":" +
+               std::to_string(decoded.column_number);
     }
 
     bool Coordinate::operator!=(const Coordinate &other) const {
-        return file_index != other.file_index && line_number != other.line_number &&
-               column_number != other.column_number;
+        return offset != other.offset;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,55 @@
+#include "Symbol.h"
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace cheese {
+    // The deque keeps every interned string at a stable address, so the map can key on views into it
+    struct SymbolTable {
+        std::deque<std::string> strings{""};
+        std::vector<const std::string *> by_id{&strings.front()};
+        std::unordered_map<std::string_view, std::uint32_t> ids{{strings.front(), 0}};
+
+        std::uint32_t intern(std::string_view text) {
+            if (auto it = ids.find(text); it != ids.end()) {
+                return it->second;
+            }
+            auto &stored = strings.emplace_back(text);
+            auto id = static_cast<std::uint32_t>(by_id.size());
+            by_id.push_back(&stored);
+            ids[stored] = id;
+            return id;
+        }
+    };
+
+    static SymbolTable &symbol_table() {
+        static SymbolTable table{};
+        return table;
+    }
+
+    Symbol::Symbol(std::string_view text) : id(symbol_table().intern(text)) {}
+
+    const std::string &Symbol::str() const {
+        return *symbol_table().by_id[id];
+    }
+
+    std::string operator+(const std::string &lhs, const Symbol &rhs) {
+        return lhs + rhs.str();
+    }
+
+    std::string operator+(const Symbol &lhs, const std::string &rhs) {
+        return lhs.str() + rhs;
+    }
+
+    std::string operator+(const char *lhs, const Symbol &rhs) {
+        return lhs + rhs.str();
+    }
+
+    std::string operator+(const Symbol &lhs, const char *rhs) {
+        return lhs.str() + rhs;
+    }
+
+    std::ostream &operator<<(std::ostream &os, const Symbol &symbol) {
+        return os << symbol.str();
+    }
+}
@@ -13,6 +13,7 @@ cheese::bacteria::BacteriaContext::BacteriaContext(cheese::project::GlobalContex
         globalContext), context(globalContext->llvm_context), program(program) {
     program_module = new llvm::Module("main", globalContext->llvm_context);
     program_module->setDataLayout(globalContext->machine.layout);
+    program_module->setTargetTriple(globalContext->machine.triple);
     program_module->setSourceFileName(globalContext->project.root_path.filename().string());
 }
 
@@ -30,5 +31,17 @@ llvm::Value *cheese::bacteria::BacteriaContext::get_string_constant(std::string
     return globalVariable;
 }
 
+llvm::GlobalVariable *
+cheese::bacteria::BacteriaContext::get_aggregate_constant(llvm::Constant *constant, llvm::Align alignment) {
+    if (aggregate_constants.contains(constant)) return aggregate_constants[constant];
+    auto globalVariable = new llvm::GlobalVariable(*program_module, constant->getType(), true,
+                                                   llvm::GlobalValue::PrivateLinkage, constant,
+                                                   ".const__" + std::to_string(next_aggregate_constant_name++));
+    globalVariable->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+    globalVariable->setAlignment(alignment);
+    aggregate_constants[constant] = globalVariable;
+    return globalVariable;
+}
+
 cheese::bacteria::BacteriaContext::~BacteriaContext() {
 }
@@ -4,6 +4,8 @@
 
 #include "bacteria/BacteriaNode.h"
 #include "bacteria/BacteriaContext.h"
+#include "bacteria/ScopeContext.h"
+#include "bacteria/FunctionContext.h"
 #include "NotImplementedException.h"
 #include <sstream>
 
@@ -29,6 +31,11 @@ namespace cheese::bacteria {
         NOT_IMPL_FOR(typeid(*this).name());
     }
 
+    llvm::Align BacteriaNode::get_address_alignment(ScopeContext &ctx) {
+        auto bctx = ctx.function_context.bacteria_context;
+        return get_cached_expr_type(ctx, bctx->program)->get_llvm_alignment(bctx->global_context);
+    }
+
     llvm::Value *BacteriaNode::lower_write(ScopeContext &ctx, WriteContext &writeContext) {
         NOT_IMPL_FOR(typeid(*this).name());
     }
@@ -41,9 +48,22 @@ namespace cheese::bacteria {
         NOT_IMPL_FOR(typeid(*this).name());
     }
 
-    void add_indentation(std::stringstream &ss, int indentation) {
+    TypePtr BacteriaNode::get_cached_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program) {
+        if (!cached_expr_type) {
+            cached_expr_type = get_expr_type(ctx, program);
+        }
+        return cached_expr_type;
+    }
+
+    std::string BacteriaNode::get_textual_representation(int depth) {
+        std::stringstream ss{};
+        write_textual_representation(ss, depth);
+        return ss.str();
+    }
+
+    void add_indentation(std::ostream &os, int indentation) {
         for (int i = 0; i < indentation; i++) {
-            ss << "    ";
+            os << "    ";
         }
     }
 
@@ -96,6 +116,12 @@ namespace cheese::bacteria {
         COMPARE_DIRECT();
     }
 
+    bool bacteria::compare_helper(const nlohmann::json &object, const std::string &name, bool value) {
+        CATCH_IMPLICIT();
+        CATCH_TYPE(boolean);
+        COMPARE_DIRECT();
+    }
+
     bool bacteria::compare_helper(const nlohmann::json &object, const std::string &name, std::uint64_t value) {
         CATCH_IMPLICIT();
         CATCH_TYPE(number_integer);
@@ -192,6 +218,42 @@ namespace cheese::bacteria {
         if (!implicit_compare_value(value)) object[name] = value->as_json();
     }
 
+    void stream_json(util::TreeWriter &writer, const std::string &name, const BacteriaPtr &value) {
+        if (implicit_compare_value(value)) return;
+        writer.key(name);
+        value->write_json(writer);
+    }
+
+    void stream_json(util::TreeWriter &writer, const std::string &name, const BacteriaList &value) {
+        if (value.empty()) return;
+        writer.key(name);
+        writer.begin_array();
+        for (auto &n: value) {
+            n->write_json(writer);
+        }
+        writer.end_array();
+    }
+
+    void stream_json(util::TreeWriter &writer, const std::string &name, const BacteriaDict &value) {
+        if (implicit_compare_value(value)) return;
+        writer.key(name);
+        writer.begin_object();
+        for (const auto &kv: value) {
+            stream_json(writer, kv.first, kv.second);
+        }
+        writer.end_object();
+    }
+
+    void stream_json(util::TreeWriter &writer, const std::string &name, const math::BigInteger &value) {
+        if (implicit_compare_value(value)) return;
+        writer.key(name);
+        if (value.words.size() > 1) {
+            writer.value(static_cast<std::string>(value));
+        } else {
+            writer.value(static_cast<std::int64_t>(value));
+        }
+    }
+
 
     bool compare_helper(const nlohmann::json &object, const std::string &name,
                         const std::vector<FunctionArgument> &value) {
@@ -230,6 +292,22 @@ namespace cheese::bacteria {
         object[std::move(name)] = arr;
     }
 
+    void stream_json(util::TreeWriter &writer, const std::string &name, const Symbol &value) {
+        stream_json(writer, name, value.str());
+    }
+
+    void stream_json(util::TreeWriter &writer, const std::string &name, const std::vector<FunctionArgument> &value) {
+        writer.key(name);
+        writer.begin_array();
+        for (auto &v: value) {
+            writer.begin_object();
+            stream_json(writer, "name", v.name);
+            stream_json(writer, "type", v.type->to_string());
+            writer.end_object();
+        }
+        writer.end_array();
+    }
+
     template<>
     void cheese::bacteria::build_json<TypeList>(nlohmann::json &object, std::string name,
                                                 const TypeList &value) {
@@ -240,6 +318,15 @@ namespace cheese::bacteria {
         object[std::move(name)] = arr;
     }
 
+    void stream_json(util::TreeWriter &writer, const std::string &name, const TypeList &value) {
+        writer.key(name);
+        writer.begin_array();
+        for (auto &v: value) {
+            writer.value(v->to_string());
+        }
+        writer.end_array();
+    }
+
     bool
     compare_helper(const nlohmann::json &object, const std::string &name,
                    const TypeList &value) {
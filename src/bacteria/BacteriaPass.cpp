@@ -0,0 +1,446 @@
+#include "bacteria/BacteriaPass.h"
+#include "bacteria/nodes/expression_nodes.h"
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <llvm/ADT/APInt.h>
+#include <llvm/ADT/SmallString.h>
+
+namespace cheese::bacteria {
+    using namespace nodes;
+
+    // Walks everything below a node before the node itself, letting the rewriter replace each node in place
+    static bool rewrite(BacteriaPtr &node, const std::function<bool(BacteriaPtr &)> &rewriter) {
+        bool changed = false;
+        node->visit_children([&](BacteriaPtr &child) {
+            changed |= rewrite(child, rewriter);
+        });
+        return rewriter(node) || changed;
+    }
+
+    static bool rewrite(BacteriaProgram *program, const std::function<bool(BacteriaPtr &)> &rewriter) {
+        bool changed = false;
+        for (auto &child: program->children) {
+            changed |= rewrite(child, rewriter);
+        }
+        return changed;
+    }
+
+    static bool is_foldable_integer(TypePtr type) {
+        return (type->type == BacteriaType::Type::UnsignedInteger || type->type == BacteriaType::Type::SignedInteger) &&
+               type->integer_size > 0;
+    }
+
+    static bool is_foldable_float(TypePtr type) {
+        return type->type == BacteriaType::Type::Float32 || type->type == BacteriaType::Type::Float64;
+    }
+
+    // Integers are folded as APInts of the literal's width, so that they wrap exactly the way the lowered code would
+    static llvm::APInt to_ap_int(IntegerLiteral *literal) {
+        return {literal->type->integer_size, static_cast<std::string>(literal->value), 10};
+    }
+
+    static BacteriaPtr make_integer(Coordinate location, const llvm::APInt &value, TypePtr type) {
+        llvm::SmallString<40> digits;
+        value.toString(digits, 10, type->type == BacteriaType::Type::SignedInteger);
+        return std::make_unique<IntegerLiteral>(location, math::BigInteger{std::string_view{digits.data(),
+                                                                                            digits.size()}}, type);
+    }
+
+    static BacteriaPtr make_bool(Coordinate location, bool value, BacteriaProgram *program) {
+        return make_integer(location, llvm::APInt(1, value ? 1 : 0),
+                            program->get_type(BacteriaType::Type::UnsignedInteger, 1));
+    }
+
+    static BacteriaPtr fold_integers(BinaryNode *node, IntegerLiteral *lhs, IntegerLiteral *rhs,
+                                     BacteriaProgram *program) {
+        if (!is_foldable_integer(lhs->type) || !lhs->type->is_same_as(rhs->type)) return {};
+        auto is_signed = lhs->type->type == BacteriaType::Type::SignedInteger;
+        auto a = to_ap_int(lhs);
+        auto b = to_ap_int(rhs);
+        // Division by zero and signed overflow are left for runtime, they have no single right answer to fold to
+        auto bad_divisor = b.isZero() || (is_signed && a.isMinSignedValue() && b.isAllOnes());
+        bool overflow = false;
+        if (dynamic_cast<AdditionNode *>(node)) {
+            auto result = is_signed ? a.sadd_ov(b, overflow) : a + b;
+            if (overflow) return {};
+            return make_integer(node->location, result, lhs->type);
+        } else if (dynamic_cast<SubtractNode *>(node)) {
+            auto result = is_signed ? a.ssub_ov(b, overflow) : a - b;
+            if (overflow) return {};
+            return make_integer(node->location, result, lhs->type);
+        } else if (dynamic_cast<MultiplyNode *>(node)) {
+            auto result = is_signed ? a.smul_ov(b, overflow) : a * b;
+            if (overflow) return {};
+            return make_integer(node->location, result, lhs->type);
+        } else if (dynamic_cast<DivisionNode *>(node)) {
+            if (bad_divisor) return {};
+            return make_integer(node->location, is_signed ? a.sdiv(b) : a.udiv(b), lhs->type);
+        } else if (dynamic_cast<ModulusNode *>(node)) {
+            if (bad_divisor) return {};
+            return make_integer(node->location, is_signed ? a.srem(b) : a.urem(b), lhs->type);
+        } else if (dynamic_cast<OrNode *>(node)) {
+            if (lhs->type->integer_size != 1) return {};
+            return make_integer(node->location, a | b, lhs->type);
+        } else if (dynamic_cast<EqualToNode *>(node)) {
+            return make_bool(node->location, a == b, program);
+        } else if (dynamic_cast<NotEqualNode *>(node)) {
+            return make_bool(node->location, a != b, program);
+        } else if (dynamic_cast<LesserThanNode *>(node)) {
+            return make_bool(node->location, is_signed ? a.slt(b) : a.ult(b), program);
+        } else if (dynamic_cast<GreaterEqualNode *>(node)) {
+            return make_bool(node->location, is_signed ? a.sge(b) : a.uge(b), program);
+        }
+        return {};
+    }
+
+    template<typename F>
+    static BacteriaPtr fold_floats(BinaryNode *node, F a, F b, TypePtr type, BacteriaProgram *program) {
+        if (dynamic_cast<AdditionNode *>(node)) {
+            return std::make_unique<FloatLiteral>(node->location, static_cast<F>(a + b), type);
+        } else if (dynamic_cast<SubtractNode *>(node)) {
+            return std::make_unique<FloatLiteral>(node->location, static_cast<F>(a - b), type);
+        } else if (dynamic_cast<MultiplyNode *>(node)) {
+            return std::make_unique<FloatLiteral>(node->location, static_cast<F>(a * b), type);
+        } else if (dynamic_cast<DivisionNode *>(node)) {
+            return std::make_unique<FloatLiteral>(node->location, static_cast<F>(a / b), type);
+        } else if (dynamic_cast<EqualToNode *>(node)) {
+            return make_bool(node->location, a == b, program);
+        } else if (dynamic_cast<NotEqualNode *>(node)) {
+            return make_bool(node->location, a != b, program);
+        } else if (dynamic_cast<LesserThanNode *>(node)) {
+            return make_bool(node->location, a < b, program);
+        } else if (dynamic_cast<GreaterEqualNode *>(node)) {
+            return make_bool(node->location, a >= b, program);
+        }
+        return {};
+    }
+
+    static BacteriaPtr fold_binary(BinaryNode *node, BacteriaProgram *program) {
+        if (dynamic_cast<MutationNode *>(node)) return {};
+        if (auto lhs = dynamic_cast<IntegerLiteral *>(node->lhs.get()); lhs) {
+            if (auto rhs = dynamic_cast<IntegerLiteral *>(node->rhs.get()); rhs) {
+                return fold_integers(node, lhs, rhs, program);
+            }
+        } else if (auto lhs_float = dynamic_cast<FloatLiteral *>(node->lhs.get()); lhs_float) {
+            if (auto rhs_float = dynamic_cast<FloatLiteral *>(node->rhs.get()); rhs_float) {
+                if (!is_foldable_float(lhs_float->type) || !lhs_float->type->is_same_as(rhs_float->type)) return {};
+                if (lhs_float->type->type == BacteriaType::Type::Float32) {
+                    return fold_floats<float>(node, static_cast<float>(lhs_float->value),
+                                              static_cast<float>(rhs_float->value), lhs_float->type, program);
+                }
+                return fold_floats<double>(node, lhs_float->value, rhs_float->value, lhs_float->type, program);
+            }
+        }
+        return {};
+    }
+
+    static BacteriaPtr fold_cast(CastNode *node) {
+        auto literal = dynamic_cast<IntegerLiteral *>(node->lhs.get());
+        if (!literal) return {};
+        if (literal->type->is_same_as(node->rhs)) return std::move(node->lhs);
+        if (!is_foldable_integer(literal->type) || !is_foldable_integer(node->rhs)) return {};
+        auto value = to_ap_int(literal);
+        // This extends exactly like CastNode::lower_expression_level does, only unsigned to unsigned zero extends
+        auto zero_extend = literal->type->type == BacteriaType::Type::UnsignedInteger &&
+                           node->rhs->type == BacteriaType::Type::UnsignedInteger;
+        auto width = node->rhs->integer_size;
+        return make_integer(node->location, zero_extend ? value.zextOrTrunc(width) : value.sextOrTrunc(width),
+                            node->rhs);
+    }
+
+    bool ConstantFoldingPass::run(BacteriaProgram *program) {
+        return rewrite(program, [program](BacteriaPtr &node) {
+            BacteriaPtr folded;
+            if (auto as_binary = dynamic_cast<BinaryNode *>(node.get()); as_binary) {
+                folded = fold_binary(as_binary, program);
+            } else if (auto as_cast = dynamic_cast<CastNode *>(node.get()); as_cast) {
+                folded = fold_cast(as_cast);
+            }
+            if (!folded) return false;
+            node = std::move(folded);
+            return true;
+        });
+    }
+
+    // A taken branch has to stay its own scope, so that anything it declares doesn't leak out into the parent
+    static BacteriaPtr as_block(BacteriaPtr branch) {
+        if (dynamic_cast<UnnamedBlock *>(branch.get()) || dynamic_cast<If *>(branch.get())) return branch;
+        auto block = std::make_unique<UnnamedBlock>(branch->location);
+        block->receive(std::move(branch));
+        return block;
+    }
+
+    static std::optional<bool> literal_condition(const BacteriaPtr &condition) {
+        if (auto literal = dynamic_cast<IntegerLiteral *>(condition.get()); literal) {
+            return !literal->value.zero();
+        }
+        return {};
+    }
+
+    bool DeadBranchEliminationPass::run(BacteriaProgram *program) {
+        return rewrite(program, [](BacteriaPtr &node) {
+            if (auto as_if = dynamic_cast<If *>(node.get()); as_if) {
+                auto condition = literal_condition(as_if->condition);
+                if (!condition.has_value()) return false;
+                if (condition.value()) {
+                    node = as_block(std::move(as_if->body));
+                } else if (as_if->els.has_value()) {
+                    node = as_block(std::move(as_if->els.value()));
+                } else {
+                    node = std::make_unique<Nop>(as_if->location);
+                }
+                return true;
+            } else if (auto as_while = dynamic_cast<While *>(node.get()); as_while) {
+                // A loop that is always entered still has to loop, so only never entered loops go away
+                auto condition = literal_condition(as_while->condition);
+                if (!condition.has_value() || condition.value()) return false;
+                if (as_while->els.has_value()) {
+                    node = as_block(std::move(as_while->els.value()));
+                } else {
+                    node = std::make_unique<Nop>(as_while->location);
+                }
+                return true;
+            } else if (auto as_loop = dynamic_cast<CountedLoop *>(node.get()); as_loop) {
+                auto begin = dynamic_cast<IntegerLiteral *>(as_loop->begin.get());
+                auto end = dynamic_cast<IntegerLiteral *>(as_loop->end.get());
+                if (!begin || !end) return false;
+                auto order = begin->value <=> end->value;
+                auto entered = as_loop->inclusive ? order != std::strong_ordering::greater
+                                                  : order == std::strong_ordering::less;
+                if (entered) return false;
+                if (as_loop->els.has_value()) {
+                    node = as_block(std::move(as_loop->els.value()));
+                } else {
+                    node = std::make_unique<Nop>(as_loop->location);
+                }
+                return true;
+            } else if (auto as_switch = dynamic_cast<Switch *>(node.get()); as_switch) {
+                auto literal = dynamic_cast<IntegerLiteral *>(as_switch->value.get());
+                if (!literal) return false;
+                auto switched = static_cast<std::string>(literal->value);
+                for (auto &arm: as_switch->cases) {
+                    auto as_case = dynamic_cast<SwitchCase *>(arm.get());
+                    for (auto &value: as_case->values) {
+                        if (static_cast<std::string>(dynamic_cast<IntegerLiteral *>(value.get())->value) == switched) {
+                            node = as_block(std::move(as_case->body));
+                            return true;
+                        }
+                    }
+                }
+                if (as_switch->default_case.has_value()) {
+                    node = as_block(std::move(as_switch->default_case.value()));
+                } else {
+                    node = std::make_unique<Nop>(as_switch->location);
+                }
+                return true;
+            }
+            return false;
+        });
+    }
+
+    static bool is_nop(const BacteriaPtr &node) {
+        return dynamic_cast<Nop *>(node.get()) != nullptr;
+    }
+
+    // A branch body is lowered as an expression, which a nop can't be, so it gets replaced by an empty block instead
+    static bool strip_branch(BacteriaPtr &branch) {
+        if (!is_nop(branch)) return false;
+        branch = std::make_unique<UnnamedBlock>(branch->location);
+        return true;
+    }
+
+    static bool strip_branch(std::optional<BacteriaPtr> &branch) {
+        if (!branch.has_value() || !is_nop(branch.value())) return false;
+        branch.reset();
+        return true;
+    }
+
+    static bool strip_children(BacteriaList &children) {
+        return std::erase_if(children, is_nop) != 0;
+    }
+
+    bool NopStrippingPass::run(BacteriaProgram *program) {
+        auto changed = strip_children(program->children);
+        changed |= rewrite(program, [](BacteriaPtr &node) {
+            if (auto as_receiver = dynamic_cast<BacteriaReceiver *>(node.get()); as_receiver) {
+                return strip_children(as_receiver->children);
+            } else if (auto as_if = dynamic_cast<If *>(node.get()); as_if) {
+                auto stripped = strip_branch(as_if->body);
+                return strip_branch(as_if->els) || stripped;
+            } else if (auto as_while = dynamic_cast<While *>(node.get()); as_while) {
+                auto stripped = strip_branch(as_while->body);
+                return strip_branch(as_while->els) || stripped;
+            } else if (auto as_loop = dynamic_cast<CountedLoop *>(node.get()); as_loop) {
+                auto stripped = strip_branch(as_loop->body);
+                return strip_branch(as_loop->els) || stripped;
+            } else if (auto as_case = dynamic_cast<SwitchCase *>(node.get()); as_case) {
+                return strip_branch(as_case->body);
+            } else if (auto as_switch = dynamic_cast<Switch *>(node.get()); as_switch) {
+                return strip_branch(as_switch->default_case);
+            }
+            return false;
+        });
+        return changed;
+    }
+
+    // Gathers every name a node could refer to a function by
+    static void find_references(BacteriaPtr &node, std::vector<std::string> &names) {
+        if (auto as_call = dynamic_cast<NormalCallNode *>(node.get()); as_call) {
+            names.push_back(as_call->function);
+        } else if (auto as_value = dynamic_cast<ValueReference *>(node.get()); as_value) {
+            names.push_back(as_value->name);
+        }
+        node->visit_children([&](BacteriaPtr &child) {
+            find_references(child, names);
+        });
+    }
+
+    bool UnreachableFunctionRemovalPass::run(BacteriaProgram *program) {
+        std::unordered_map<std::string, Function *> functions;
+        std::vector<std::string> worklist;
+        for (auto &child: program->children) {
+            if (auto as_function = dynamic_cast<Function *>(child.get()); as_function) {
+                functions[as_function->name] = as_function;
+                if (as_function->external) worklist.push_back(as_function->name);
+            } else {
+                // Anything else at the top level, such as a global, is always kept, so its references are too
+                find_references(child, worklist);
+            }
+        }
+        std::unordered_set<Function *> reachable;
+        while (!worklist.empty()) {
+            auto name = std::move(worklist.back());
+            worklist.pop_back();
+            auto it = functions.find(name);
+            if (it == functions.end() || !reachable.insert(it->second).second) continue;
+            for (auto &child: it->second->children) {
+                find_references(child, worklist);
+            }
+        }
+        return std::erase_if(program->children, [&](const BacteriaPtr &child) {
+            auto as_function = dynamic_cast<Function *>(child.get());
+            return as_function && !reachable.contains(as_function);
+        }) != 0;
+    }
+
+    // Whether a value of this type can point at memory outside of the function holding it
+    static bool holds_pointers(BacteriaType *type) {
+        switch (type->type) {
+            case BacteriaType::Type::Slice:
+            case BacteriaType::Type::Reference:
+            case BacteriaType::Type::Pointer:
+            case BacteriaType::Type::FunctionPointer:
+                return true;
+            case BacteriaType::Type::Array:
+            case BacteriaType::Type::Vector:
+                return holds_pointers(type->subtype);
+            case BacteriaType::Type::Object:
+                return std::any_of(type->child_types.begin(), type->child_types.end(), holds_pointers);
+            default:
+                return false;
+        }
+    }
+
+    // A function that never sees a pointer can only ever touch its own locals, so a mutation in one is harmless
+    static bool sees_pointers(BacteriaPtr &node) {
+        if (dynamic_cast<ReferenceNode *>(node.get()) || dynamic_cast<ImplicitReferenceNode *>(node.get()) ||
+            dynamic_cast<ReferenceSubscriptNode *>(node.get())) {
+            return true;
+        }
+        if (auto as_init = dynamic_cast<VariableInitializationNode *>(node.get()); as_init) {
+            if (holds_pointers(as_init->type)) return true;
+        } else if (auto as_def = dynamic_cast<VariableDefinitionNode *>(node.get()); as_def) {
+            if (holds_pointers(as_def->type)) return true;
+        } else if (auto as_loop = dynamic_cast<CountedLoop *>(node.get()); as_loop) {
+            if (holds_pointers(as_loop->type)) return true;
+        }
+        bool result = false;
+        node->visit_children([&](BacteriaPtr &child) {
+            result = result || sees_pointers(child);
+        });
+        return result;
+    }
+
+    static Function::MemoryEffects
+    find_effects(BacteriaPtr &node, bool pointers, const std::unordered_map<std::string, Function *> &functions) {
+        using Effects = Function::MemoryEffects;
+        auto effects = pointers ? Effects::ReadOnly : Effects::None;
+        if (auto as_call = dynamic_cast<NormalCallNode *>(node.get()); as_call) {
+            // Imported functions could do anything
+            auto it = functions.find(as_call->function);
+            effects = std::max(effects, it == functions.end() ? Effects::Unknown : it->second->memory_effects);
+        } else if (dynamic_cast<PointerCallNode *>(node.get())) {
+            return Effects::Unknown;
+        } else if (dynamic_cast<MutationNode *>(node.get()) && pointers) {
+            // There is no telling whether the mutation is through a pointer or into a local
+            return Effects::Unknown;
+        }
+        node->visit_children([&](BacteriaPtr &child) {
+            if (effects != Effects::Unknown) effects = std::max(effects, find_effects(child, pointers, functions));
+        });
+        return effects;
+    }
+
+    bool FunctionAttributeInferencePass::run(BacteriaProgram *program) {
+        std::unordered_map<std::string, Function *> functions;
+        std::unordered_map<Function *, bool> pointers;
+        for (auto &child: program->children) {
+            if (auto as_function = dynamic_cast<Function *>(child.get()); as_function) {
+                functions[as_function->name] = as_function;
+                bool sees = std::any_of(as_function->arguments.begin(), as_function->arguments.end(),
+                                        [](const FunctionArgument &argument) {
+                                            return holds_pointers(argument.type);
+                                        });
+                for (auto &body_child: as_function->children) {
+                    sees = sees || sees_pointers(body_child);
+                }
+                pointers[as_function] = sees;
+                // Start from the best case, so that (mutually) recursive functions don't pessimize each other
+                as_function->memory_effects = Function::MemoryEffects::None;
+            }
+        }
+        // Effects only ever get worse, so this always settles
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (auto &[name, function]: functions) {
+                auto effects = pointers[function] ? Function::MemoryEffects::ReadOnly : Function::MemoryEffects::None;
+                for (auto &child: function->children) {
+                    effects = std::max(effects, find_effects(child, pointers[function], functions));
+                }
+                if (effects != function->memory_effects) {
+                    function->memory_effects = effects;
+                    changed = true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void BacteriaPassManager::add(std::unique_ptr<BacteriaPass> pass) {
+        passes.push_back(std::move(pass));
+    }
+
+    bool BacteriaPassManager::run(BacteriaProgram *program) {
+        bool changed = false;
+        for (auto &pass: passes) {
+            changed |= pass->run(program);
+        }
+        return changed;
+    }
+
+    void run_default_passes(BacteriaProgram *program) {
+        BacteriaPassManager manager{};
+        // Folding goes first so that branches on folded conditions get eliminated, and the nops left behind by that
+        // get stripped, which can in turn leave functions that are no longer called by anything
+        manager.add(std::make_unique<ConstantFoldingPass>());
+        manager.add(std::make_unique<DeadBranchEliminationPass>());
+        manager.add(std::make_unique<NopStrippingPass>());
+        manager.add(std::make_unique<UnreachableFunctionRemovalPass>());
+        manager.add(std::make_unique<FunctionAttributeInferencePass>());
+        manager.run(program);
+    }
+}
@@ -3,7 +3,13 @@
 //
 #include "bacteria/BacteriaType.h"
 #include "project/GlobalContext.h"
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Function.h>
+#include <llvm/ADT/Triple.h>
 #include <sstream>
+#include <algorithm>
+#include <array>
+#include <optional>
 
 namespace cheese::bacteria {
 
@@ -77,6 +83,8 @@ namespace cheese::bacteria {
                 ss << ")=>" << subtype->to_string();
                 return ss.str();
             }
+            case Type::Vector:
+                return "<" + std::to_string(array_dimensions[0]) + ">" + subtype->to_string();
             default:
                 return "unknown";
         }
@@ -92,6 +100,79 @@ namespace cheese::bacteria {
                                                           struct_name(structName),
                                                           constant_ref(constant_ref) {}
 
+    void BacteriaType::lay_out_object(cheese::project::GlobalContext *ctx, llvm::StructType *struct_type) {
+        auto &layout = ctx->machine.layout;
+        std::vector<std::size_t> order(child_types.size());
+        std::vector<llvm::Align> alignments;
+        for (std::size_t i = 0; i < child_types.size(); i++) {
+            order[i] = i;
+            // Not the ABI alignment of the LLVM type, as that is 1 for an object with an explicit layout
+            auto natural = packed ? llvm::Align(1) : child_types[i]->get_llvm_alignment(ctx);
+            auto requested = i < field_alignments.size() ? field_alignments[i] : 0;
+            alignments.push_back(requested > natural.value() ? llvm::Align(requested) : natural);
+        }
+        // Going from the most to the least aligned field means no padding is needed between fields
+        if (reorder_fields && !packed) {
+            std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+                return alignments[a] > alignments[b];
+            });
+        }
+        field_indices.assign(child_types.size(), 0);
+        std::vector<llvm::Type *> body;
+        bool explicit_layout = packed || alignment != 0;
+        for (std::size_t i = 0; i < child_types.size(); i++) {
+            if (alignments[i] > layout.getABITypeAlign(child_types[i]->get_llvm_type(ctx))) explicit_layout = true;
+        }
+        if (!explicit_layout) {
+            for (std::size_t i = 0; i < order.size(); i++) {
+                field_indices[order[i]] = static_cast<unsigned>(i);
+                body.push_back(child_types[order[i]]->get_llvm_type(ctx));
+            }
+            struct_type->setBody(body);
+            object_alignment = layout.getABITypeAlign(struct_type);
+            return;
+        }
+        // LLVM has no notion of over aligned fields, so the padding gets spelled out in a packed structure instead
+        auto i8 = llvm::Type::getInt8Ty(ctx->llvm_context);
+        std::uint64_t offset = 0;
+        llvm::Align struct_alignment = alignment != 0 ? llvm::Align(alignment) : llvm::Align(1);
+        for (auto child: order) {
+            auto aligned = llvm::alignTo(offset, alignments[child]);
+            if (aligned != offset) body.push_back(llvm::ArrayType::get(i8, aligned - offset));
+            field_indices[child] = static_cast<unsigned>(body.size());
+            auto child_type = child_types[child]->get_llvm_type(ctx);
+            body.push_back(child_type);
+            offset = aligned + layout.getTypeAllocSize(child_type);
+            if (!packed) struct_alignment = std::max(struct_alignment, alignments[child]);
+        }
+        // The tail padding keeps every element of an array of these aligned
+        auto size = llvm::alignTo(offset, struct_alignment);
+        if (size != offset) body.push_back(llvm::ArrayType::get(i8, size - offset));
+        struct_type->setBody(body, true);
+        object_alignment = struct_alignment;
+    }
+
+    unsigned BacteriaType::get_field_index(cheese::project::GlobalContext *ctx, std::size_t child) {
+        get_llvm_type(ctx);
+        return field_indices[child];
+    }
+
+    std::uint64_t BacteriaType::get_field_offset(cheese::project::GlobalContext *ctx, std::size_t child) {
+        auto struct_layout = ctx->machine.layout.getStructLayout(llvm::cast<llvm::StructType>(get_llvm_type(ctx)));
+        return struct_layout->getElementOffset(field_indices[child]);
+    }
+
+    llvm::Align BacteriaType::get_llvm_alignment(cheese::project::GlobalContext *ctx) {
+        auto llvm_type = get_llvm_type(ctx);
+        // Objects with an explicit layout are packed as far as LLVM knows, so their real alignment is kept separately
+        if (type == Type::Object) return object_alignment;
+        // And an array of those is only as aligned as its elements
+        if (type == Type::Array) {
+            return std::max(ctx->machine.layout.getABITypeAlign(llvm_type), subtype->get_llvm_alignment(ctx));
+        }
+        return ctx->machine.layout.getABITypeAlign(llvm_type);
+    }
+
     llvm::Type *BacteriaType::get_llvm_type(cheese::project::GlobalContext *ctx) {
         if (cached_llvm_type) return cached_llvm_type;
         switch (type) {
@@ -152,16 +233,15 @@ namespace cheese::bacteria {
             case Type::FunctionPointer:
                 cached_llvm_type = llvm::PointerType::get(ctx->llvm_context, ctx->machine.data_pointer_addr);
                 break;
+            case Type::Vector:
+                cached_llvm_type = llvm::FixedVectorType::get(subtype->get_llvm_type(ctx),
+                                                              static_cast<unsigned>(array_dimensions[0]));
+                break;
             case Type::Object: {
                 auto struct_type = llvm::StructType::create(ctx->llvm_context);
                 if (!struct_name.empty()) struct_type->setName(struct_name);
                 cached_llvm_type = struct_type;
-                auto vec = std::vector<llvm::Type *>{};
-                for (const auto &ty: child_types) {
-                    vec.push_back(ty->get_llvm_type(ctx));
-                }
-                auto arr = llvm::ArrayRef<llvm::Type *>{vec};
-                struct_type->setBody(arr);
+                lay_out_object(ctx, struct_type);
                 break;
             }
         }
@@ -196,6 +276,7 @@ namespace cheese::bacteria {
             case Type::Pointer:
                 return subtype == otherSubtype;
             case Type::Array:
+            case Type::Vector:
                 return arrayDimensions == array_dimensions && subtype == otherSubtype;
             case Type::Object:
                 if (structName != struct_name) return false;
@@ -231,6 +312,7 @@ namespace cheese::bacteria {
             case Type::Reference:
             case Type::Pointer:
             case Type::FunctionPointer:
+            case Type::Vector:
                 return false;
             case Type::Array:
             case Type::Object:
@@ -238,6 +320,360 @@ namespace cheese::bacteria {
         }
     }
 
+    BacteriaType::Passing BacteriaType::get_passing(cheese::project::GlobalContext *ctx) {
+        // Array values are always their address, so they can only ever be passed indirectly
+        if (type == Type::Array) return Passing::Indirect;
+        if (type != Type::Object) return Passing::Direct;
+        // Anything that fits in 2 registers is kept out of memory, same as the usual C ABIs do
+        auto register_size = ctx->machine.data_pointer_size;
+        auto size = get_llvm_size(ctx);
+        if (size > 2 * register_size) return Passing::Indirect;
+        if (child_types.empty() || child_types.size() > 4) return Passing::Direct;
+        for (auto child: child_types) {
+            switch (child->type) {
+                case Type::UnsignedInteger:
+                case Type::UnsignedSize:
+                case Type::SignedInteger:
+                case Type::SignedSize:
+                case Type::Float32:
+                case Type::Float64:
+                case Type::Reference:
+                case Type::Pointer:
+                case Type::FunctionPointer:
+                    break;
+                default:
+                    return Passing::Direct;
+            }
+        }
+        return Passing::Split;
+    }
+
+    namespace {
+        // The register classes of the x86-64 System V ABI, an eightbyte with any integer in it goes in an integer register
+        enum class SysVClass {
+            None, // Nothing but padding
+            Integer,
+            Sse,
+        };
+
+        struct SysVEightbyte {
+            SysVClass register_class = SysVClass::None;
+            bool only_f32 = true; // Two floats share an eightbyte as a <2 x float>
+        };
+
+        // Marks the eightbytes every scalar of an object covers, false means the object has to go in memory instead
+        bool classify_sysv(cheese::project::GlobalContext *ctx, BacteriaType *type, std::uint64_t offset,
+                           std::array<SysVEightbyte, 2> &eightbytes) {
+            using Type = BacteriaType::Type;
+            switch (type->type) {
+                case Type::Void:
+                case Type::Noreturn:
+                case Type::Opaque:
+                    return true;
+                case Type::Object:
+                    for (std::size_t i = 0; i < type->child_types.size(); i++) {
+                        auto child = type->child_types[i];
+                        auto child_offset = offset + type->get_field_offset(ctx, i);
+                        // A packed layout can move a field off of its natural alignment, which C passes in memory
+                        if (child_offset % child->get_llvm_alignment(ctx).value() != 0) return false;
+                        if (!classify_sysv(ctx, child, child_offset, eightbytes)) return false;
+                    }
+                    return true;
+                case Type::Array: {
+                    auto element_size = type->subtype->get_llvm_size(ctx);
+                    if (element_size == 0) return true;
+                    auto count = type->get_llvm_size(ctx) / element_size;
+                    for (std::uint64_t i = 0; i < count; i++) {
+                        if (!classify_sysv(ctx, type->subtype, offset + i * element_size, eightbytes)) return false;
+                    }
+                    return true;
+                }
+                default:
+                    break;
+            }
+            auto size = type->get_llvm_size(ctx);
+            if (size == 0) return true;
+            // Vectors wider than an eightbyte would need the SSEUP class, which is only used for whole vector arguments
+            if (type->type == Type::Vector && size > 8) return false;
+            auto sse = type->type == Type::Float32 || type->type == Type::Float64 || type->type == Type::Complex32 ||
+                       type->type == Type::Complex64 || type->type == Type::Vector;
+            auto f32 = type->type == Type::Float32 || type->type == Type::Complex32 ||
+                       (type->type == Type::Vector && type->subtype->type == Type::Float32);
+            for (auto i = offset / 8; i <= (offset + size - 1) / 8; i++) {
+                if (i >= eightbytes.size()) return false;
+                auto &eightbyte = eightbytes[i];
+                if (!sse) {
+                    eightbyte.register_class = SysVClass::Integer;
+                } else if (eightbyte.register_class == SysVClass::None) {
+                    eightbyte.register_class = SysVClass::Sse;
+                }
+                eightbyte.only_f32 = eightbyte.only_f32 && f32;
+            }
+            return true;
+        }
+
+        // Finds the one floating point type every scalar of an object is, and how many of them there are
+        bool find_homogeneous_float(cheese::project::GlobalContext *ctx, BacteriaType *type, llvm::Type *&base,
+                                    std::uint64_t &count) {
+            using Type = BacteriaType::Type;
+            auto &llvm_context = type->get_llvm_type(ctx)->getContext();
+            llvm::Type *element;
+            switch (type->type) {
+                case Type::Object:
+                    for (auto child: type->child_types) {
+                        if (!find_homogeneous_float(ctx, child, base, count)) return false;
+                    }
+                    return true;
+                case Type::Array: {
+                    auto before = count;
+                    if (!find_homogeneous_float(ctx, type->subtype, base, count)) return false;
+                    std::uint64_t elements = 1;
+                    for (auto dimension: type->array_dimensions) elements *= dimension;
+                    count = before + (count - before) * elements;
+                    return true;
+                }
+                case Type::Float32:
+                case Type::Complex32:
+                    element = llvm::Type::getFloatTy(llvm_context);
+                    break;
+                case Type::Float64:
+                case Type::Complex64:
+                    element = llvm::Type::getDoubleTy(llvm_context);
+                    break;
+                default:
+                    return false;
+            }
+            if (base != nullptr && base != element) return false;
+            base = element;
+            count += type->type == Type::Complex32 || type->type == Type::Complex64 ? 2 : 1;
+            return true;
+        }
+
+        // How the C ABI of the target passes an argument of this type, filling in the parts when it is coerced, empty
+        // when an object has to cross a boundary on a target whose C ABI isn't known
+        std::optional<BacteriaType::Passing>
+        get_c_passing(cheese::project::GlobalContext *ctx, BacteriaType *type, std::vector<llvm::Type *> &parts) {
+            using Passing = BacteriaType::Passing;
+            // An array is never a value in C, it decays to a pointer to its first element
+            if (type->type == BacteriaType::Type::Array) return Passing::Reference;
+            if (type->type != BacteriaType::Type::Object) return Passing::Direct;
+            auto size = type->get_llvm_size(ctx);
+            if (size == 0) return Passing::Direct;
+            auto &llvm_context = type->get_llvm_type(ctx)->getContext();
+            llvm::Triple triple{ctx->machine.triple};
+            if (triple.getArch() == llvm::Triple::x86_64 && triple.isOSWindows()) {
+                // Win64 puts an object in an integer register only if it is exactly the size of one
+                if (size == 1 || size == 2 || size == 4 || size == 8) {
+                    parts.push_back(llvm::IntegerType::get(llvm_context, size * 8));
+                    return Passing::Coerced;
+                }
+                return Passing::Reference;
+            }
+            if (triple.getArch() == llvm::Triple::x86_64) {
+                std::array<SysVEightbyte, 2> eightbytes{};
+                if (size > 16 || type->get_llvm_alignment(ctx).value() > 16 ||
+                    !classify_sysv(ctx, type, 0, eightbytes)) {
+                    return Passing::Indirect;
+                }
+                auto count = size > 8 && eightbytes[1].register_class != SysVClass::None ? 2 : 1;
+                for (std::size_t i = 0; i < count; i++) {
+                    auto bytes = std::min<std::uint64_t>(8, size - i * 8);
+                    if (eightbytes[i].register_class != SysVClass::Sse) {
+                        parts.push_back(llvm::IntegerType::get(llvm_context, bytes * 8));
+                    } else if (bytes <= 4) {
+                        parts.push_back(llvm::Type::getFloatTy(llvm_context));
+                    } else if (eightbytes[i].only_f32) {
+                        parts.push_back(llvm::FixedVectorType::get(llvm::Type::getFloatTy(llvm_context), 2));
+                    } else {
+                        parts.push_back(llvm::Type::getDoubleTy(llvm_context));
+                    }
+                }
+                return Passing::Coerced;
+            }
+            if (triple.isAArch64()) {
+                // Up to 4 floats or doubles go in the vector registers, one each
+                llvm::Type *base = nullptr;
+                std::uint64_t count = 0;
+                if (find_homogeneous_float(ctx, type, base, count) && count >= 1 && count <= 4) {
+                    parts.push_back(llvm::ArrayType::get(base, count));
+                    return Passing::Coerced;
+                }
+                if (size > 16) return Passing::Reference;
+                auto i64 = llvm::Type::getInt64Ty(llvm_context);
+                if (size <= 8) {
+                    parts.push_back(i64);
+                } else if (type->get_llvm_alignment(ctx).value() >= 16) {
+                    // Over aligned objects start at an even numbered register
+                    parts.push_back(llvm::IntegerType::get(llvm_context, 128));
+                } else {
+                    parts.push_back(llvm::ArrayType::get(i64, 2));
+                }
+                return Passing::Coerced;
+            }
+            return std::nullopt;
+        }
+    }
+
+    std::vector<llvm::Type *> BacteriaType::get_coerced_types(cheese::project::GlobalContext *ctx) {
+        std::vector<llvm::Type *> parts;
+        get_c_passing(ctx, this, parts);
+        return parts;
+    }
+
+    llvm::Type *BacteriaType::get_coerced_type(cheese::project::GlobalContext *ctx) {
+        auto parts = get_coerced_types(ctx);
+        if (parts.size() == 1) return parts[0];
+        return llvm::StructType::get(get_llvm_type(ctx)->getContext(), parts);
+    }
+
+    SignaturePassing SignaturePassing::get(cheese::project::GlobalContext *ctx, TypePtr result,
+                                           const TypeList &arguments, bool external) {
+        using Passing = BacteriaType::Passing;
+        SignaturePassing passing;
+        if (!external) {
+            passing.result = result->get_passing(ctx) == Passing::Indirect ? Passing::Indirect : Passing::Direct;
+            for (auto argument: arguments) passing.arguments.push_back(argument->get_passing(ctx));
+            return passing;
+        }
+        std::vector<llvm::Type *> parts;
+        auto c_passing = [&](TypePtr type) {
+            parts.clear();
+            auto found = get_c_passing(ctx, type, parts);
+            if (!found.has_value()) passing.supported = false;
+            return found.value_or(Passing::Direct);
+        };
+        // What goes in memory instead of a register when returned goes in memory the same way when passed
+        passing.result = c_passing(result);
+        if (passing.result == Passing::Reference) passing.result = Passing::Indirect;
+        // Only x86-64 System V decides between registers and memory for the whole object, the other ABIs either
+        // don't put objects in several registers or leave splitting one between registers and memory to LLVM
+        llvm::Triple triple{ctx->machine.triple};
+        auto system_v = triple.getArch() == llvm::Triple::x86_64 && !triple.isOSWindows();
+        std::size_t integer_registers = passing.result == Passing::Indirect ? 5 : 6;
+        std::size_t sse_registers = 8;
+        auto is_sse = [](llvm::Type *type) { return type->isFloatingPointTy() || type->isVectorTy(); };
+        for (auto argument: arguments) {
+            auto argument_passing = c_passing(argument);
+            if (system_v) {
+                std::vector<llvm::Type *> used;
+                if (argument_passing == Passing::Coerced) {
+                    used = parts;
+                } else if (argument_passing == Passing::Reference) {
+                    used.push_back(llvm::PointerType::get(argument->get_llvm_type(ctx)->getContext(), 0));
+                } else if (argument_passing == Passing::Direct) {
+                    auto llvm_type = argument->get_llvm_type(ctx);
+                    if (auto as_struct = llvm::dyn_cast<llvm::StructType>(llvm_type); as_struct) {
+                        used.insert(used.end(), as_struct->element_begin(), as_struct->element_end());
+                    } else {
+                        used.push_back(llvm_type);
+                    }
+                }
+                auto sse = (std::size_t) std::count_if(used.begin(), used.end(), is_sse);
+                auto integer = used.size() - sse;
+                if (argument_passing == Passing::Coerced && (integer > integer_registers || sse > sse_registers)) {
+                    // The whole object goes on the stack once it doesn't fit, it is never split between the two
+                    argument_passing = Passing::Indirect;
+                } else {
+                    integer_registers -= std::min(integer, integer_registers);
+                    sse_registers -= std::min(sse, sse_registers);
+                }
+            }
+            passing.arguments.push_back(argument_passing);
+        }
+        return passing;
+    }
+
+    llvm::FunctionType *SignaturePassing::get_function_type(cheese::project::GlobalContext *ctx, TypePtr result,
+                                                            const TypeList &arguments) const {
+        auto &llvm_context = result->get_llvm_type(ctx)->getContext();
+        auto pointer_type = llvm::PointerType::get(llvm_context, ctx->machine.data_pointer_addr);
+        llvm::Type *result_type;
+        std::vector<llvm::Type *> argument_types;
+        switch (this->result) {
+            case BacteriaType::Passing::Indirect:
+            case BacteriaType::Passing::Reference:
+                result_type = llvm::Type::getVoidTy(llvm_context);
+                argument_types.push_back(pointer_type);
+                break;
+            case BacteriaType::Passing::Coerced:
+                result_type = result->get_coerced_type(ctx);
+                break;
+            default:
+                result_type = result->get_llvm_type(ctx);
+                break;
+        }
+        for (std::size_t i = 0; i < arguments.size(); i++) {
+            switch (this->arguments[i]) {
+                case BacteriaType::Passing::Direct:
+                    argument_types.push_back(arguments[i]->get_llvm_type(ctx));
+                    break;
+                case BacteriaType::Passing::Split:
+                    for (auto child: arguments[i]->child_types) {
+                        argument_types.push_back(child->get_llvm_type(ctx));
+                    }
+                    break;
+                case BacteriaType::Passing::Indirect:
+                case BacteriaType::Passing::Reference:
+                    argument_types.push_back(pointer_type);
+                    break;
+                case BacteriaType::Passing::Coerced:
+                    for (auto part: arguments[i]->get_coerced_types(ctx)) {
+                        argument_types.push_back(part);
+                    }
+                    break;
+            }
+        }
+        return llvm::FunctionType::get(result_type, argument_types, false);
+    }
+
+    void SignaturePassing::add_attributes(cheese::project::GlobalContext *ctx, llvm::Function *function,
+                                          TypePtr result, const TypeList &arguments) const {
+        auto &llvm_context = function->getContext();
+        unsigned arg_no = 0;
+        if (returns_indirectly()) {
+            function->addParamAttr(arg_no, llvm::Attribute::getWithStructRetType(llvm_context,
+                                                                                 result->get_llvm_type(ctx)));
+            function->addParamAttr(arg_no, llvm::Attribute::NoAlias);
+            function->addParamAttr(arg_no, llvm::Attribute::getWithAlignment(llvm_context,
+                                                                             result->get_llvm_alignment(ctx)));
+            arg_no++;
+        }
+        for (std::size_t i = 0; i < arguments.size(); i++) {
+            auto argument = arguments[i];
+            switch (this->arguments[i]) {
+                case BacteriaType::Passing::Direct:
+                    arg_no++;
+                    break;
+                case BacteriaType::Passing::Split:
+                    arg_no += argument->child_types.size();
+                    break;
+                case BacteriaType::Passing::Indirect:
+                    function->addParamAttr(arg_no, llvm::Attribute::getWithByValType(llvm_context,
+                                                                                    argument->get_llvm_type(ctx)));
+                    function->addParamAttr(arg_no, llvm::Attribute::getWithAlignment(llvm_context,
+                                                                                     argument->get_llvm_alignment(
+                                                                                             ctx)));
+                    arg_no++;
+                    break;
+                case BacteriaType::Passing::Reference:
+                    // The copy belongs to this call alone, so nothing else can see it
+                    function->addParamAttr(arg_no, llvm::Attribute::NoAlias);
+                    function->addParamAttr(arg_no, llvm::Attribute::getWithAlignment(llvm_context,
+                                                                                     argument->get_llvm_alignment(
+                                                                                             ctx)));
+                    arg_no++;
+                    break;
+                case BacteriaType::Passing::Coerced:
+                    arg_no += argument->get_coerced_types(ctx).size();
+                    break;
+            }
+        }
+    }
+
+    bool SignaturePassing::returns_indirectly() const {
+        return result == BacteriaType::Passing::Indirect || result == BacteriaType::Passing::Reference;
+    }
+
     bool BacteriaType::is_same_as(BacteriaType *other) {
         return matches(other->type, other->integer_size, other->subtype, other->array_dimensions, other->child_types,
                        other->struct_name, other->constant_ref);
@@ -248,6 +684,7 @@ namespace cheese::bacteria {
         switch (type) {
             case Type::Slice:
             case Type::Pointer:
+            case Type::Vector:
                 return subtype->index_type(program, numIndices - 1);
             case Type::Array:
                 if (numIndices >= array_dimensions.size()) {
@@ -4,80 +4,75 @@
 #include <utility>
 
 #include "bacteria/FunctionContext.h"
+#include "configuration.h"
+#include "error.h"
+#include <llvm/IR/CFG.h>
 
 namespace cheese::bacteria {
 
-    VariableInfo *FunctionContext::get_mutable_variable(std::string varName, TypePtr type) {
-        auto name = dedupe_variable_name(std::move(varName));
+    VariableInfo *FunctionContext::add_variable(bool constant, std::string name, TypePtr type) {
         auto info = new VariableInfo{
-                false,
-                name,
-                type
+                constant,
+                std::move(name),
+                std::move(type)
         };
-        all_variables[name] = info;
-        info->value = allocate(name, type);
+        all_variables.push_back(info);
         return info;
     }
 
-    VariableInfo *FunctionContext::get_immutable_variable(std::string varName, TypePtr type) {
-        auto name = dedupe_variable_name(std::move(varName));
-        auto info = new VariableInfo{
-                true,
-                name,
-                type
-        };
-        all_variables[name] = info;
+    VariableInfo *FunctionContext::get_mutable_variable(std::string varName, TypePtr type) {
+        auto in_registers = can_live_in_registers(varName, type);
+        auto info = add_variable(false, dedupe_variable_name(std::move(varName)), type);
+        if (in_registers) {
+            info->in_registers = true;
+        } else {
+            info->value = allocate(info->name, type);
+        }
         return info;
     }
 
+    VariableInfo *FunctionContext::get_immutable_variable(std::string varName, TypePtr type) {
+        return add_variable(true, dedupe_variable_name(std::move(varName)), std::move(type));
+    }
+
     VariableInfo *FunctionContext::get_temporary_variable(TypePtr type) {
-        auto name = dedupe_variable_name(std::to_string(next_temporary_variable++));
-        auto info = new VariableInfo{
-                true,
-                name,
-                type
-        };
-        all_variables[name] = info;
-        return info;
+        next_temporary_variable++;
+        return add_variable(true, keep_names ? dedupe_variable_name(std::to_string(next_temporary_variable - 1)) : "",
+                            std::move(type));
     }
 
     VariableInfo *FunctionContext::get_temporary_in_memory_variable(TypePtr type) {
-        auto name = dedupe_variable_name(std::to_string(next_temporary_variable++));
-        auto info = new VariableInfo{
-                false,
-                name,
-                type
-        };
-        all_variables[name] = info;
-        info->value = allocate(name, type);
+        next_temporary_variable++;
+        auto info = add_variable(false,
+                                 keep_names ? dedupe_variable_name(std::to_string(next_temporary_variable - 1)) : "",
+                                 type);
+        info->value = allocate(info->name, type);
         return info;
     }
 
-    static bool is_number(const std::string &s) {
-        return !s.empty() && std::find_if(s.begin(),
-                                          s.end(), [](unsigned char c) { return !std::isdigit(c); }) == s.end();
+    // Gets the first of name, name.0, name.1, ... that isn't taken yet, remembering where it left off for each name
+    static std::string unique_name(std::unordered_set<std::string> &taken,
+                                   std::unordered_map<std::string, std::size_t> &next_suffix, std::string name) {
+        if (taken.insert(name).second) {
+            return name;
+        }
+        auto &suffix = next_suffix[name];
+        while (true) {
+            auto candidate = name + "." + std::to_string(suffix++);
+            if (taken.insert(candidate).second) {
+                return candidate;
+            }
+        }
     }
 
     std::string FunctionContext::dedupe_variable_name(std::string variableName) {
-        if (all_variables.contains(variableName)) {
-            auto dot = variableName.rfind('.');
-            if (dot != -1) {
-                auto last = variableName.substr(dot + 1);
-                if (is_number(last)) {
-                    auto num = std::stoi(last);
-                    return dedupe_variable_name(variableName.substr(0, dot) + "." + std::to_string(num + 1));
-                } else {
-                    return dedupe_variable_name(variableName + ".0");
-                }
-            } else {
-                return dedupe_variable_name(variableName + ".0");
-            }
-        } else {
-            return variableName;
-        }
+        if (!keep_names) return "";
+        return unique_name(all_variable_names, next_variable_suffix, std::move(variableName));
     }
 
-    FunctionContext::FunctionContext(BacteriaContext *bacteriaContext, llvm::Function *function) : function(function),
+    FunctionContext::FunctionContext(BacteriaContext *bacteriaContext, llvm::Function *function) : keep_names(
+            configuration::release_mode == configuration::ReleaseMode::Debug),
+                                                                                                   function(function),
                                                                                                    bacteria_context(
                                                                                                            bacteriaContext) {
         entry_block = llvm::BasicBlock::Create(bacteriaContext->context, get_block_name(".entry"), function);
@@ -87,51 +82,193 @@ namespace cheese::bacteria {
         auto irBuilder = llvm::IRBuilder<>(bacteria_context->context);
         irBuilder.SetInsertPoint(allocation_block);
         goto_entry_instruction = irBuilder.CreateBr(entry_block);
+        sealed_blocks.insert(allocation_block);
+        sealed_blocks.insert(entry_block);
     }
 
     llvm::Value *FunctionContext::allocate(const std::string &name, TypePtr type) {
         auto irBuilder = llvm::IRBuilder<>(bacteria_context->context);
         irBuilder.SetInsertPoint(goto_entry_instruction);
         auto alloc = irBuilder.CreateAlloca(type->get_llvm_type(bacteria_context->global_context), nullptr, name);
+        alloc->setAlignment(type->get_llvm_alignment(bacteria_context->global_context));
         return alloc;
     }
 
-    std::string FunctionContext::get_block_name(std::string wantedName) {
-        if (all_block_names.contains(wantedName)) {
-            auto dot = wantedName.rfind('.');
-            if (dot != -1) {
-                auto last = wantedName.substr(dot + 1);
-                if (is_number(last)) {
-                    auto num = std::stoi(last);
-                    return get_block_name(wantedName.substr(0, dot) + "." + std::to_string(num + 1));
-                } else {
-                    return get_block_name(wantedName + ".0");
-                }
-            } else {
-                return get_block_name(wantedName + ".0");
-            }
-        } else {
-            all_block_names.insert(wantedName);
-            return wantedName;
+    llvm::Value *FunctionContext::allocate_coerced(TypePtr type, llvm::StructType *parts_type) {
+        auto gctx = bacteria_context->global_context;
+        auto &layout = gctx->machine.layout;
+        llvm::Type *slot_type = type->get_llvm_type(gctx);
+        // The parts can cover more bytes than the object itself, such as a 12 byte object in 2 integer registers
+        if (layout.getTypeAllocSize(parts_type) > layout.getTypeAllocSize(slot_type)) slot_type = parts_type;
+        auto irBuilder = llvm::IRBuilder<>(bacteria_context->context);
+        irBuilder.SetInsertPoint(goto_entry_instruction);
+        auto alloc = irBuilder.CreateAlloca(slot_type);
+        alloc->setAlignment(std::max(type->get_llvm_alignment(gctx), layout.getABITypeAlign(parts_type)));
+        return alloc;
+    }
+
+    std::vector<llvm::Value *>
+    FunctionContext::coerce_to_parts(llvm::IRBuilder<> &builder, TypePtr type, llvm::Value *value) {
+        auto gctx = bacteria_context->global_context;
+        auto parts_type = llvm::StructType::get(bacteria_context->context, type->get_coerced_types(gctx));
+        auto slot = allocate_coerced(type, parts_type);
+        builder.CreateAlignedStore(value, slot, type->get_llvm_alignment(gctx));
+        std::vector<llvm::Value *> parts;
+        for (unsigned i = 0; i < parts_type->getNumElements(); i++) {
+            parts.push_back(builder.CreateLoad(parts_type->getElementType(i),
+                                               builder.CreateStructGEP(parts_type, slot, i)));
+        }
+        return parts;
+    }
+
+    llvm::Value *FunctionContext::coerce_from_parts(llvm::IRBuilder<> &builder, TypePtr type,
+                                                    const std::vector<llvm::Value *> &parts) {
+        auto gctx = bacteria_context->global_context;
+        auto parts_type = llvm::StructType::get(bacteria_context->context, type->get_coerced_types(gctx));
+        auto slot = allocate_coerced(type, parts_type);
+        for (unsigned i = 0; i < parts.size(); i++) {
+            builder.CreateStore(parts[i], builder.CreateStructGEP(parts_type, slot, i));
         }
+        return builder.CreateAlignedLoad(type->get_llvm_type(gctx), slot, type->get_llvm_alignment(gctx));
+    }
+
+    std::string FunctionContext::get_block_name(std::string wantedName) {
+        if (!keep_names) return "";
+        return unique_name(all_block_names, next_block_suffix, std::move(wantedName));
     }
 
     llvm::Value *FunctionContext::get_variable_address(VariableInfo &info) {
+        if (info.in_registers) {
+            // The address taken scan done before lowering a function should have kept this variable in memory
+            error::raise_exiting_error("bacteria", "attempting to take the address of register variable " + info.name,
+                                       {}, error::ErrorCode::GeneralCompilerError);
+        }
         if (!info.constant || info.type->type == BacteriaType::Type::Array) return info.value;
         if (info.ptr) return info.ptr;
-        auto full_name = info.name + ".addr";
+        auto full_name = keep_names ? info.name + ".addr" : "";
         auto irBuilder = llvm::IRBuilder<>(bacteria_context->context);
         irBuilder.SetInsertPoint(goto_entry_instruction);
         auto inst = irBuilder.CreateAlloca(info.type->get_llvm_type(bacteria_context->global_context), nullptr,
                                            full_name);
+        inst->setAlignment(info.type->get_llvm_alignment(bacteria_context->global_context));
         irBuilder.CreateStore(info.value, inst, false);
         info.ptr = inst;
         return info.ptr;
     }
 
+    bool FunctionContext::can_live_in_registers(const std::string &name, TypePtr type) {
+        if (!configuration::ssa_lowering || address_taken.contains(name)) return false;
+        switch (type->type) {
+            case BacteriaType::Type::UnsignedInteger:
+            case BacteriaType::Type::UnsignedSize:
+            case BacteriaType::Type::SignedInteger:
+            case BacteriaType::Type::SignedSize:
+            case BacteriaType::Type::Float32:
+            case BacteriaType::Type::Float64:
+            case BacteriaType::Type::Reference:
+            case BacteriaType::Type::Pointer:
+            case BacteriaType::Type::FunctionPointer:
+            case BacteriaType::Type::Vector:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    void FunctionContext::write_variable(VariableInfo *info, llvm::BasicBlock *block, llvm::Value *value) {
+        current_definitions[block][info] = value;
+    }
+
+    llvm::Value *FunctionContext::read_variable(VariableInfo *info, llvm::BasicBlock *block) {
+        auto &definitions = current_definitions[block];
+        if (auto it = definitions.find(info); it != definitions.end()) {
+            return it->second;
+        }
+        return read_variable_recursive(info, block);
+    }
+
+    // Creates an empty phi at the top of a block, for a variable that isn't defined in it
+    static llvm::PHINode *create_phi(VariableInfo *info, llvm::BasicBlock *block, project::GlobalContext *ctx) {
+        auto builder = llvm::IRBuilder<>(block, block->begin());
+        return builder.CreatePHI(info->type->get_llvm_type(ctx), 0, info->name);
+    }
+
+    llvm::Value *FunctionContext::read_variable_recursive(VariableInfo *info, llvm::BasicBlock *block) {
+        llvm::Value *value;
+        if (!sealed_blocks.contains(block)) {
+            auto phi = create_phi(info, block, bacteria_context->global_context);
+            incomplete_phis[block].emplace_back(info, phi);
+            value = phi;
+        } else if (auto predecessor = block->getSinglePredecessor()) {
+            value = read_variable(info, predecessor);
+        } else if (llvm::pred_empty(block)) {
+            // Either the variable was never written on this path, or this block is unreachable
+            value = llvm::PoisonValue::get(info->type->get_llvm_type(bacteria_context->global_context));
+        } else {
+            // The phi gets written before its operands are read, so that loops end up pointing back at it
+            auto phi = create_phi(info, block, bacteria_context->global_context);
+            write_variable(info, block, phi);
+            value = add_phi_operands(info, phi);
+        }
+        write_variable(info, block, value);
+        return value;
+    }
+
+    llvm::Value *FunctionContext::add_phi_operands(VariableInfo *info, llvm::PHINode *phi) {
+        for (auto predecessor: llvm::predecessors(phi->getParent())) {
+            phi->addIncoming(read_variable(info, predecessor), predecessor);
+        }
+        return try_remove_trivial_phi(phi);
+    }
+
+    llvm::Value *FunctionContext::try_remove_trivial_phi(llvm::PHINode *phi) {
+        llvm::Value *same = nullptr;
+        for (auto &operand: phi->incoming_values()) {
+            if (operand == same || operand == phi) continue;
+            if (same) return phi; // The phi merges at least two values, so it has to stay
+            same = operand;
+        }
+        if (!same) {
+            same = llvm::PoisonValue::get(phi->getType());
+        }
+        // Removing this phi might make the phis that use it trivial in turn
+        std::vector<llvm::WeakVH> phi_users;
+        for (auto user: phi->users()) {
+            if (user != phi && llvm::isa<llvm::PHINode>(user)) {
+                phi_users.emplace_back(user);
+            }
+        }
+        // The definitions are tracking handles, so they get redirected along with every other use
+        phi->replaceAllUsesWith(same);
+        phi->eraseFromParent();
+        for (auto &user: phi_users) {
+            if (auto user_phi = llvm::dyn_cast_or_null<llvm::PHINode>(user)) {
+                try_remove_trivial_phi(user_phi);
+            }
+        }
+        return same;
+    }
+
+    void FunctionContext::seal_block(llvm::BasicBlock *block) {
+        if (!sealed_blocks.insert(block).second) return;
+        if (auto it = incomplete_phis.find(block); it != incomplete_phis.end()) {
+            auto phis = std::move(it->second);
+            incomplete_phis.erase(it);
+            for (auto &[info, phi]: phis) {
+                add_phi_operands(info, phi);
+            }
+        }
+    }
+
+    void FunctionContext::seal_all_blocks() {
+        for (auto &block: *function) {
+            seal_block(&block);
+        }
+    }
+
     FunctionContext::~FunctionContext() {
         for (const auto &var: all_variables) {
-            delete var.second;
+            delete var;
         }
     }
 
@@ -11,32 +11,35 @@ namespace cheese::bacteria {
               parent_scope(parentScope) {
     }
 
-    llvm::BasicBlock *ScopeContext::create_block(std::string name) {
+    llvm::BasicBlock *ScopeContext::create_block(std::string name, bool attach) {
         return llvm::BasicBlock::Create(function_context.bacteria_context->context,
-                                        function_context.get_block_name(name), function_context.function);
-    }
-
-    VariableInfo *ScopeContext::get_info(std::string name) {
-//        return function_context.all_variables[variable_renames[name]];
-        if (variable_renames.contains(name)) {
-            return function_context.all_variables[variable_renames[name]];
-        } else if (parent_scope != nullptr) {
-            return parent_scope->get_info(name);
-        } else {
-            error::raise_exiting_error("bacteria", "unknown variable " + name, {0, 0, 0},
-                                       error::ErrorCode::InvalidVariableReference);
+                                        function_context.get_block_name(name),
+                                        attach ? function_context.function : nullptr);
+    }
+
+    void ScopeContext::attach_block(llvm::BasicBlock *block) {
+        block->insertInto(function_context.function);
+    }
+
+    VariableInfo *ScopeContext::get_info(Symbol name) {
+        for (auto scope = this; scope != nullptr; scope = scope->parent_scope) {
+            if (auto it = scope->variable_renames.find(name); it != scope->variable_renames.end()) {
+                return it->second;
+            }
         }
+        error::raise_exiting_error("bacteria", "unknown variable " + name, {},
+                                   error::ErrorCode::InvalidVariableReference);
     }
 
     VariableInfo *ScopeContext::get_mutable_variable(std::string name, TypePtr type) {
         auto result = function_context.get_mutable_variable(name, type);
-        variable_renames[name] = result->name;
+        variable_renames[name] = result;
         return result;
     }
 
     VariableInfo *ScopeContext::get_immutable_variable(std::string name, TypePtr type) {
         auto result = function_context.get_immutable_variable(name, type);
-        variable_renames[name] = result->name;
+        variable_renames[name] = result;
         return result;
     }
 
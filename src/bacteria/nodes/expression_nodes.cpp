@@ -9,23 +9,34 @@
 #include "curdle/curdle.h"
 #include "bacteria/FunctionContext.h"
 #include "bacteria/nodes/receiver_nodes.h"
+#include "configuration.h"
+#include <llvm/IR/MDBuilder.h>
+#include <algorithm>
 
 namespace cheese::bacteria::nodes {
 
+    // Imports cross the same boundary exported functions do, so they follow the C ABI of the target the same way
     void FunctionImport::gen_protos(cheese::bacteria::BacteriaContext *ctx) {
-        auto returnType = return_type->get_llvm_type(ctx->global_context);
-        std::vector<llvm::Type *> argTypes;
-        for (auto &arg: arguments) {
-            argTypes.push_back(arg->get_llvm_type(ctx->global_context));
+        auto gctx = ctx->global_context;
+        auto passing = SignaturePassing::get(gctx, return_type, arguments, true);
+        if (!passing.supported) {
+            throw curdle::LocalizedCurdleError{
+                    "Unsupported calling convention: the C ABI of " + gctx->machine.triple +
+                    " isn't known, so structures can't be passed to or returned from " + name,
+                    location,
+                    error::ErrorCode::UnsupportedCallingConvention
+            };
         }
-        auto functionType = llvm::FunctionType::get(returnType, argTypes, false);
-        auto prototype = llvm::Function::Create(functionType, llvm::Function::AvailableExternallyLinkage, name,
+        auto prototype = llvm::Function::Create(passing.get_function_type(gctx, return_type, arguments),
+                                                llvm::Function::AvailableExternallyLinkage, name,
                                                 ctx->program_module);
+        passing.add_attributes(gctx, prototype, return_type, arguments);
         ctx->functions[name] = FunctionInfo{
                 arguments,
                 return_type,
                 name,
-                prototype
+                prototype,
+                passing
         };
     }
 
@@ -40,7 +51,27 @@ namespace cheese::bacteria::nodes {
                     expected_type
             };
             auto value = retVal.value()->lower_expression_level(ctx, expressionContext);
-            ctx.scope_builder.CreateRet(value);
+            if (auto slot = ctx.function_context.return_slot; slot) {
+                auto gctx = ctx.function_context.bacteria_context->global_context;
+                auto alignment = expected_type->get_llvm_alignment(gctx);
+                if (expected_type->type == BacteriaType::Type::Array) {
+                    // Arrays are already an address, so they get copied over rather than stored
+                    ctx.scope_builder.CreateMemCpy(slot, alignment, value, alignment,
+                                                   expected_type->get_llvm_size(gctx));
+                } else {
+                    ctx.scope_builder.CreateAlignedStore(value, slot, alignment);
+                }
+                ctx.scope_builder.CreateRetVoid();
+            } else if (ctx.function_context.return_passing == BacteriaType::Passing::Coerced) {
+                auto parts = ctx.function_context.coerce_to_parts(ctx.scope_builder, expected_type, value);
+                if (parts.size() == 1) {
+                    ctx.scope_builder.CreateRet(parts[0]);
+                } else {
+                    ctx.scope_builder.CreateAggregateRet(parts.data(), parts.size());
+                }
+            } else {
+                ctx.scope_builder.CreateRet(value);
+            }
         } else {
             if (expected_type->type != BacteriaType::Type::Void) {
                 throw curdle::LocalizedCurdleError{
@@ -54,16 +85,76 @@ namespace cheese::bacteria::nodes {
     }
 
     llvm::Value *NormalCallNode::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
-        auto fn = ctx.function_context.bacteria_context->functions[function];
+        auto &fctx = ctx.function_context;
+        auto gctx = fctx.bacteria_context->global_context;
+        auto fn = fctx.bacteria_context->functions[function];
         std::vector<llvm::Value *> args;
+        llvm::Value *result_slot = nullptr;
+        if (fn.passing.returns_indirectly()) {
+            result_slot = fctx.allocate("", fn.returnType);
+            args.push_back(result_slot);
+        }
         size_t idx = 0;
         for (auto &arg: arguments) {
+            auto argument_passing = fn.passing.arguments[idx];
+            auto argument_type = fn.argumentTypes[idx++];
             ExpressionContext expressionContext{
-                    fn.argumentTypes[idx++]
+                    argument_type
             };
-            args.push_back(arg->lower_expression_level(ctx, expressionContext));
+            auto value = arg->lower_expression_level(ctx, expressionContext);
+            switch (argument_passing) {
+                case BacteriaType::Passing::Direct:
+                    args.push_back(value);
+                    break;
+                case BacteriaType::Passing::Indirect:
+                case BacteriaType::Passing::Reference:
+                    // byval copies from the address given to it, which an array value already is
+                    if (argument_type->type != BacteriaType::Type::Array) {
+                        auto temporary = fctx.allocate("", argument_type);
+                        ctx.scope_builder.CreateAlignedStore(value, temporary,
+                                                             argument_type->get_llvm_alignment(gctx));
+                        value = temporary;
+                    } else if (argument_passing == BacteriaType::Passing::Reference) {
+                        // Unlike byval, nothing copies the array on the way in, and the callee is free to write to it
+                        auto temporary = fctx.allocate("", argument_type);
+                        auto alignment = argument_type->get_llvm_alignment(gctx);
+                        ctx.scope_builder.CreateMemCpy(temporary, alignment, value, alignment,
+                                                       argument_type->get_llvm_size(gctx));
+                        value = temporary;
+                    }
+                    args.push_back(value);
+                    break;
+                case BacteriaType::Passing::Split:
+                    for (size_t i = 0; i < argument_type->child_types.size(); i++) {
+                        args.push_back(ctx.scope_builder.CreateExtractValue(value,
+                                                                            {argument_type->get_field_index(gctx,
+                                                                                                            i)}));
+                    }
+                    break;
+                case BacteriaType::Passing::Coerced:
+                    for (auto part: fctx.coerce_to_parts(ctx.scope_builder, argument_type, value)) {
+                        args.push_back(part);
+                    }
+                    break;
+            }
+        }
+        auto call = ctx.scope_builder.CreateCall(fn.prototype->getFunctionType(), fn.prototype, args);
+        if (fn.passing.result == BacteriaType::Passing::Coerced) {
+            std::vector<llvm::Value *> parts;
+            if (call->getType()->isStructTy()) {
+                for (unsigned i = 0; i < call->getType()->getStructNumElements(); i++) {
+                    parts.push_back(ctx.scope_builder.CreateExtractValue(call, {i}));
+                }
+            } else {
+                parts.push_back(call);
+            }
+            return fctx.coerce_from_parts(ctx.scope_builder, fn.returnType, parts);
         }
-        return ctx.scope_builder.CreateCall(fn.prototype->getFunctionType(), fn.prototype, args);
+        if (!result_slot) return call;
+        // Array values are just their address, so the slot itself is the result
+        if (fn.returnType->type == BacteriaType::Type::Array) return result_slot;
+        return ctx.scope_builder.CreateAlignedLoad(fn.returnType->get_llvm_type(gctx), result_slot,
+                                                   fn.returnType->get_llvm_alignment(gctx));
     }
 
     void NormalCallNode::lower_scope_level(ScopeContext &ctx) {
@@ -80,7 +171,7 @@ namespace cheese::bacteria::nodes {
 
     llvm::Value *CastNode::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
 //        return BacteriaNode::lower_expression_level(ctx, expr);
-        auto lhs_ty = lhs->get_expr_type(ctx, ctx.function_context.bacteria_context->program);
+        auto lhs_ty = lhs->get_cached_expr_type(ctx, ctx.function_context.bacteria_context->program);
         if (lhs_ty->is_same_as(rhs)) {
             return lhs->lower_expression_level(ctx, expr);
         } else {
@@ -104,6 +195,8 @@ namespace cheese::bacteria::nodes {
                                 return ctx.scope_builder.CreateTrunc(lhsValue, rhsTy);
                             }
                             break;
+                        default:
+                            break;
                     }
                     break;
                 case BacteriaType::Type::SignedInteger:
@@ -116,13 +209,37 @@ namespace cheese::bacteria::nodes {
                                 return ctx.scope_builder.CreateTrunc(lhsValue, rhsTy);
                             }
                             break;
+                        default:
+                            break;
                     }
                     break;
                 case BacteriaType::Type::Array:
                     switch (rhs->type) {
                         case BacteriaType::Type::Pointer:
                             return lhsValue;
+                        default:
+                            break;
                     }
+                    break;
+                case BacteriaType::Type::Slice:
+                    // Every slice type is its own struct, so making one constant means moving both fields over
+                    if (rhs->type == BacteriaType::Type::Slice) {
+                        llvm::Value *result = llvm::PoisonValue::get(rhsTy);
+                        result = ctx.scope_builder.CreateInsertValue(result,
+                                                                     ctx.scope_builder.CreateExtractValue(lhsValue,
+                                                                                                          {0}), {0});
+                        return ctx.scope_builder.CreateInsertValue(result,
+                                                                   ctx.scope_builder.CreateExtractValue(lhsValue, {1}),
+                                                                   {1});
+                    }
+                    break;
+                default:
+                    // Everything else is either a vector broadcast or a cast that can't be lowered, both handled below
+                    break;
+            }
+            // Curdle converts a scalar to the lane type before it gets here, so all that is left is the broadcast
+            if (rhs->type == BacteriaType::Type::Vector && lhs_ty->is_same_as(rhs->subtype)) {
+                return ctx.scope_builder.CreateVectorSplat(static_cast<unsigned>(rhs->array_dimensions[0]), lhsValue);
             }
             NOT_IMPL_FOR(lhs_ty->to_string() + " & " + rhs->to_string());
         }
@@ -131,6 +248,14 @@ namespace cheese::bacteria::nodes {
     llvm::Value *StringLiteral::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
         if (type->type == BacteriaType::Type::Pointer) {
             return ctx.function_context.bacteria_context->get_string_constant(value);
+        } else if (type->type == BacteriaType::Type::Slice) {
+            auto gctx = ctx.function_context.bacteria_context->global_context;
+            llvm::Value *result = llvm::PoisonValue::get(type->get_llvm_type(gctx));
+            result = ctx.scope_builder.CreateInsertValue(result, ctx.scope_builder.getIntN(
+                    gctx->machine.data_pointer_size * 8, value.size()), {0});
+            return ctx.scope_builder.CreateInsertValue(result,
+                                                       ctx.function_context.bacteria_context->get_string_constant(
+                                                               value), {1});
         } else {
             NOT_IMPL;
         }
@@ -143,10 +268,18 @@ namespace cheese::bacteria::nodes {
     void If::lower_scope_level(ScopeContext &ctx) {
         // Here we don't care about values
         ExpressionContext expressionContext{
-                condition->get_expr_type(ctx, ctx.function_context.bacteria_context->program)
+                condition->get_cached_expr_type(ctx, ctx.function_context.bacteria_context->program)
         };
         auto comparison = condition->lower_expression_level(ctx, expressionContext);
+        // Every branch is emitted before the bodies are lowered, so that each block is sealed with all of its
+        // predecessors known, the later blocks are only placed once the bodies are done to keep the block order
         auto if_block = ctx.create_block(".if-true");
+        auto else_block = els.has_value() ? ctx.create_block(".if-false", false) : nullptr;
+        auto cont_block = ctx.create_block(".cont", false);
+        if (!util::llvm::has_terminator(ctx.current_block)) {
+            ctx.scope_builder.CreateCondBr(comparison, if_block, els.has_value() ? else_block : cont_block);
+        }
+        ctx.function_context.seal_block(if_block);
         auto if_scope = ScopeContext{
                 ctx.function_context,
                 if_block,
@@ -156,42 +289,105 @@ namespace cheese::bacteria::nodes {
                 ctx.function_context.bacteria_context->program->get_type(bacteria::BacteriaType::Type::Void)
         };
         body->lower_expression_level(if_scope, voidContext);
+        if (!util::llvm::has_terminator(if_scope.current_block)) {
+            if_scope.scope_builder.CreateBr(cont_block);
+        }
         if (els.has_value()) {
-            auto else_block = ctx.create_block(".if-false");
+            ctx.attach_block(else_block);
+            ctx.function_context.seal_block(else_block);
             auto else_scope = ScopeContext{
                     ctx.function_context,
                     else_block,
                     &ctx
             };
             els.value()->lower_expression_level(else_scope, voidContext);
-            if (!util::llvm::has_terminator(ctx.current_block)) {
-                ctx.scope_builder.CreateCondBr(comparison, if_block, else_block);
-            }
-            auto cont_block = ctx.create_block(".cont");
-            if (!util::llvm::has_terminator(if_scope.current_block)) {
-                if_scope.scope_builder.CreateBr(cont_block);
-            }
             if (!util::llvm::has_terminator(else_scope.current_block)) {
                 else_scope.scope_builder.CreateBr(cont_block);
             }
-            ctx.set_current_block(cont_block);
-        } else {
-            auto cont_block = ctx.create_block(".cont");
-            if (!util::llvm::has_terminator(ctx.current_block)) {
-                ctx.scope_builder.CreateCondBr(comparison, if_block, cont_block);
+        }
+        ctx.attach_block(cont_block);
+        ctx.function_context.seal_block(cont_block);
+        ctx.set_current_block(cont_block);
+    }
+
+    // Hints only apply to the loop they are directly inside of, so this doesn't look into nested loops or branches
+    static void collect_loop_hints(BacteriaNode *node, std::vector<LoopHint *> &hints) {
+        if (auto hint = dynamic_cast<LoopHint *>(node); hint) {
+            hints.push_back(hint);
+        } else if (auto block = dynamic_cast<UnnamedBlock *>(node); block) {
+            for (auto &child: block->children) {
+                collect_loop_hints(child.get(), hints);
+            }
+        }
+    }
+
+    // Builds the llvm.loop metadata for the back edge of a loop, counted loops ask for vectorization and unrolling by
+    // default as they are known to terminate, any other loop only gets what was asked for from source
+    static llvm::MDNode *make_loop_metadata(llvm::LLVMContext &context, BacteriaNode *body, bool counted) {
+        std::optional<bool> vectorize;
+        std::uint64_t width = 0;
+        std::optional<bool> unroll;
+        std::uint64_t unroll_count = 0;
+        std::vector<LoopHint *> hints;
+        collect_loop_hints(body, hints);
+        for (auto hint: hints) {
+            if (hint->kind == LoopHint::Kind::Vectorize) {
+                vectorize = hint->enable;
+                width = hint->count;
+            } else {
+                unroll = hint->enable;
+                unroll_count = hint->count;
+            }
+        }
+        if (counted) {
+            vectorize = vectorize.value_or(true);
+            unroll = unroll.value_or(true);
+        }
+        std::vector<llvm::Metadata *> operands{nullptr}; // The first operand is the loop id itself, filled in below
+        auto name = [&](const char *property) -> llvm::Metadata * {
+            return llvm::MDString::get(context, property);
+        };
+        auto constant = [&](llvm::Type *type, std::uint64_t value) -> llvm::Metadata * {
+            return llvm::ConstantAsMetadata::get(llvm::ConstantInt::get(type, value));
+        };
+        if (counted) {
+            operands.push_back(llvm::MDNode::get(context, {name("llvm.loop.mustprogress")}));
+        }
+        if (vectorize.has_value()) {
+            operands.push_back(llvm::MDNode::get(context, {name("llvm.loop.vectorize.enable"),
+                                                           constant(llvm::Type::getInt1Ty(context),
+                                                                    vectorize.value())}));
+            if (vectorize.value() && width != 0) {
+                operands.push_back(llvm::MDNode::get(context, {name("llvm.loop.vectorize.width"),
+                                                               constant(llvm::Type::getInt32Ty(context), width)}));
             }
-            if (!util::llvm::has_terminator(if_scope.current_block)) {
-                if_scope.scope_builder.CreateBr(cont_block);
+        }
+        if (unroll.has_value()) {
+            if (!unroll.value()) {
+                operands.push_back(llvm::MDNode::get(context, {name("llvm.loop.unroll.disable")}));
+            } else if (unroll_count != 0) {
+                operands.push_back(llvm::MDNode::get(context, {name("llvm.loop.unroll.count"),
+                                                               constant(llvm::Type::getInt32Ty(context),
+                                                                        unroll_count)}));
+            } else {
+                operands.push_back(llvm::MDNode::get(context, {name("llvm.loop.unroll.enable")}));
             }
-            ctx.set_current_block(cont_block);
         }
+        if (operands.size() == 1) return nullptr;
+        auto loop_id = llvm::MDNode::getDistinct(context, operands);
+        loop_id->replaceOperandWith(0, loop_id);
+        return loop_id;
     }
 
     void While::lower_scope_level(ScopeContext &ctx) {
         ExpressionContext expressionContext{
-                condition->get_expr_type(ctx, ctx.function_context.bacteria_context->program)
+                condition->get_cached_expr_type(ctx, ctx.function_context.bacteria_context->program)
         };
         auto compare_block = ctx.create_block(".while-compare");
+        if (!util::llvm::has_terminator(ctx.current_block)) {
+            ctx.scope_builder.CreateBr(compare_block);
+        }
+        // The compare block stays unsealed until the body has been lowered, as the body adds the back edge into it
         auto compare_scope = ScopeContext{
                 ctx.function_context,
                 compare_block,
@@ -199,6 +395,14 @@ namespace cheese::bacteria::nodes {
         };
         auto comparison = condition->lower_expression_level(compare_scope, expressionContext);
         auto while_block = ctx.create_block(".while-loop");
+        auto else_block = els.has_value() ? ctx.create_block(".while-else", false) : nullptr;
+        auto cont_block = ctx.create_block(".cont", false);
+        if (!util::llvm::has_terminator(compare_scope.current_block)) {
+            // We are so going to have to create a `break block` at some point
+            compare_scope.scope_builder.CreateCondBr(comparison, while_block,
+                                                     els.has_value() ? else_block : cont_block);
+        }
+        ctx.function_context.seal_block(while_block);
         auto while_scope = ScopeContext{
                 ctx.function_context,
                 while_block,
@@ -208,47 +412,182 @@ namespace cheese::bacteria::nodes {
                 ctx.function_context.bacteria_context->program->get_type(bacteria::BacteriaType::Type::Void)
         };
         body->lower_expression_level(while_scope, voidContext);
+        if (!util::llvm::has_terminator(while_scope.current_block)) {
+            auto back_edge = while_scope.scope_builder.CreateBr(compare_block);
+            if (auto loop_id = make_loop_metadata(ctx.function_context.bacteria_context->context, body.get(), false)) {
+                back_edge->setMetadata(llvm::LLVMContext::MD_loop, loop_id);
+            }
+        }
+        ctx.function_context.seal_block(compare_block);
         if (els.has_value()) {
-            auto else_block = ctx.create_block(".while-else");
+            ctx.attach_block(else_block);
+            ctx.function_context.seal_block(else_block);
             auto else_scope = ScopeContext{
                     ctx.function_context,
                     else_block,
                     &ctx
             };
             els.value()->lower_expression_level(else_scope, voidContext);
-            if (!util::llvm::has_terminator(ctx.current_block)) {
-                ctx.scope_builder.CreateBr(compare_block);
-            }
-            if (!util::llvm::has_terminator(while_scope.current_block)) {
-                while_scope.scope_builder.CreateBr(compare_block);
-            }
-            if (!util::llvm::has_terminator(compare_scope.current_block)) {
-                // We are so going to have to create a `break block` at some point
-                compare_scope.scope_builder.CreateCondBr(comparison, while_block, else_block);
-            }
-            auto cont_block = ctx.create_block(".cont");
             if (!util::llvm::has_terminator(else_scope.current_block)) {
                 else_scope.scope_builder.CreateBr(cont_block);
             }
-            ctx.set_current_block(cont_block);
+        }
+        ctx.attach_block(cont_block);
+        ctx.function_context.seal_block(cont_block);
+        ctx.set_current_block(cont_block);
+    }
+
+    void CountedLoop::lower_scope_level(ScopeContext &ctx) {
+        auto bacteria_context = ctx.function_context.bacteria_context;
+        auto &llvm_context = bacteria_context->context;
+        ExpressionContext boundContext{
+                type
+        };
+        // Both bounds are evaluated exactly once, before the loop is entered
+        auto begin_value = begin->lower_expression_level(ctx, boundContext);
+        auto end_value = end->lower_expression_level(ctx, boundContext);
+        auto is_signed = type->type == BacteriaType::Type::SignedInteger || type->type == BacteriaType::Type::SignedSize;
+        auto preheader = ctx.scope_builder.GetInsertBlock();
+        auto body_block = ctx.create_block(".for-body");
+        auto latch_block = ctx.create_block(".for-latch", false);
+        auto else_block = els.has_value() ? ctx.create_block(".for-else", false) : nullptr;
+        auto cont_block = ctx.create_block(".cont", false);
+        auto exit_block = els.has_value() ? else_block : cont_block;
+        // The loop is rotated, the guard here decides whether it is entered at all, and the latch decides whether to go
+        // around again, which keeps the induction variable from ever having to step past end
+        auto entered = !util::llvm::has_terminator(preheader);
+        if (entered) {
+            auto guard = inclusive ? (is_signed ? ctx.scope_builder.CreateICmpSLE(begin_value, end_value)
+                                                : ctx.scope_builder.CreateICmpULE(begin_value, end_value))
+                                   : (is_signed ? ctx.scope_builder.CreateICmpSLT(begin_value, end_value)
+                                                : ctx.scope_builder.CreateICmpULT(begin_value, end_value));
+            ctx.scope_builder.CreateCondBr(guard, body_block, exit_block);
+        }
+        auto induction_type = type->get_llvm_type(bacteria_context->global_context);
+        llvm::IRBuilder<> header_builder{body_block};
+        auto induction_value = header_builder.CreatePHI(induction_type, 2, induction);
+        if (entered) {
+            induction_value->addIncoming(begin_value, preheader);
+        }
+        // Like the compare block of a while loop, the body stays unsealed until the back edge from the latch exists
+        auto body_scope = ScopeContext{
+                ctx.function_context,
+                body_block,
+                &ctx
+        };
+        auto info = body_scope.get_immutable_variable(induction, type);
+        info->value = induction_value;
+        ExpressionContext voidContext{
+                bacteria_context->program->get_type(bacteria::BacteriaType::Type::Void)
+        };
+        body->lower_expression_level(body_scope, voidContext);
+        if (!util::llvm::has_terminator(body_scope.current_block)) {
+            body_scope.scope_builder.CreateBr(latch_block);
+        }
+        ctx.attach_block(latch_block);
+        ctx.function_context.seal_block(latch_block);
+        llvm::IRBuilder<> latch_builder{latch_block};
+        // The induction variable is always below end when it gets incremented, so this can never wrap
+        auto next = latch_builder.CreateAdd(induction_value, llvm::ConstantInt::get(induction_type, 1),
+                                            induction + ".next", !is_signed, is_signed);
+        llvm::BranchInst *back_edge;
+        if (inclusive) {
+            auto done = latch_builder.CreateICmpEQ(induction_value, end_value);
+            back_edge = latch_builder.CreateCondBr(done, exit_block, body_block);
         } else {
-            auto cont_block = ctx.create_block(".cont");
-            if (!util::llvm::has_terminator(ctx.current_block)) {
-                ctx.scope_builder.CreateBr(compare_block);
+            auto more = is_signed ? latch_builder.CreateICmpSLT(next, end_value)
+                                  : latch_builder.CreateICmpULT(next, end_value);
+            back_edge = latch_builder.CreateCondBr(more, body_block, exit_block);
+        }
+        induction_value->addIncoming(next, latch_block);
+        back_edge->setMetadata(llvm::LLVMContext::MD_loop, make_loop_metadata(llvm_context, body.get(), true));
+        ctx.function_context.seal_block(body_block);
+        if (els.has_value()) {
+            ctx.attach_block(else_block);
+            ctx.function_context.seal_block(else_block);
+            auto else_scope = ScopeContext{
+                    ctx.function_context,
+                    else_block,
+                    &ctx
+            };
+            els.value()->lower_expression_level(else_scope, voidContext);
+            if (!util::llvm::has_terminator(else_scope.current_block)) {
+                else_scope.scope_builder.CreateBr(cont_block);
             }
-            if (!util::llvm::has_terminator(while_scope.current_block)) {
-                while_scope.scope_builder.CreateBr(compare_block);
+        }
+        ctx.attach_block(cont_block);
+        ctx.function_context.seal_block(cont_block);
+        ctx.set_current_block(cont_block);
+    }
+
+    void Switch::lower_scope_level(ScopeContext &ctx) {
+        ExpressionContext valueContext{
+                type
+        };
+        auto switched = value->lower_expression_level(ctx, valueContext);
+        // Like with if, every edge out of the switch exists before any arm is lowered, so each arm is sealed up front
+        std::vector<llvm::BasicBlock *> case_blocks;
+        for (std::size_t i = 0; i < cases.size(); i++) {
+            case_blocks.push_back(ctx.create_block(".switch-case"));
+        }
+        auto default_block = default_case.has_value() ? ctx.create_block(".switch-default", false) : nullptr;
+        auto cont_block = ctx.create_block(".cont", false);
+        if (!util::llvm::has_terminator(ctx.current_block)) {
+            auto instruction = ctx.scope_builder.CreateSwitch(switched, default_block ? default_block : cont_block,
+                                                              cases.size());
+            // Pointer sized integers don't carry a size of their own, so the width comes from the lowered value
+            auto width = switched->getType()->getIntegerBitWidth();
+            for (std::size_t i = 0; i < cases.size(); i++) {
+                auto arm = dynamic_cast<SwitchCase *>(cases[i].get());
+                for (auto &case_value: arm->values) {
+                    auto literal = dynamic_cast<IntegerLiteral *>(case_value.get());
+                    instruction->addCase(ctx.scope_builder.getInt(
+                            llvm::APInt(width, static_cast<std::string>(literal->value), 10)),
+                                         case_blocks[i]);
+                }
             }
-            if (!util::llvm::has_terminator(compare_scope.current_block)) {
-                // We are so going to have to create a `break block` at some point
-                compare_scope.scope_builder.CreateCondBr(comparison, while_block, cont_block);
+        }
+        ExpressionContext voidContext{
+                ctx.function_context.bacteria_context->program->get_type(bacteria::BacteriaType::Type::Void)
+        };
+        for (std::size_t i = 0; i < cases.size(); i++) {
+            ctx.function_context.seal_block(case_blocks[i]);
+            auto case_scope = ScopeContext{
+                    ctx.function_context,
+                    case_blocks[i],
+                    &ctx
+            };
+            dynamic_cast<SwitchCase *>(cases[i].get())->body->lower_expression_level(case_scope, voidContext);
+            if (!util::llvm::has_terminator(case_scope.current_block)) {
+                case_scope.scope_builder.CreateBr(cont_block);
             }
-            ctx.set_current_block(cont_block);
         }
+        if (default_case.has_value()) {
+            ctx.attach_block(default_block);
+            ctx.function_context.seal_block(default_block);
+            auto default_scope = ScopeContext{
+                    ctx.function_context,
+                    default_block,
+                    &ctx
+            };
+            default_case.value()->lower_expression_level(default_scope, voidContext);
+            if (!util::llvm::has_terminator(default_scope.current_block)) {
+                default_scope.scope_builder.CreateBr(cont_block);
+            }
+        }
+        ctx.attach_block(cont_block);
+        ctx.function_context.seal_block(cont_block);
+        ctx.set_current_block(cont_block);
+    }
+
+    llvm::Value *Switch::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
+        lower_scope_level(ctx);
+        return llvm::PoisonValue::get(
+                expr.result_type->get_llvm_type(ctx.function_context.bacteria_context->global_context));
     }
 
     llvm::Value *LesserThanNode::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
-        auto ty = lhs->get_expr_type(ctx, ctx.function_context.bacteria_context->program);
+        auto ty = lhs->get_cached_expr_type(ctx, ctx.function_context.bacteria_context->program);
         auto subContext = ExpressionContext{
                 ty
         };
@@ -281,7 +620,7 @@ namespace cheese::bacteria::nodes {
     }
 
     llvm::Value *EqualToNode::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
-        auto ty = lhs->get_expr_type(ctx, ctx.function_context.bacteria_context->program);
+        auto ty = lhs->get_cached_expr_type(ctx, ctx.function_context.bacteria_context->program);
         auto subContext = ExpressionContext{
                 ty
         };
@@ -313,7 +652,7 @@ namespace cheese::bacteria::nodes {
     }
 
     llvm::Value *NotEqualNode::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
-        auto ty = lhs->get_expr_type(ctx, ctx.function_context.bacteria_context->program);
+        auto ty = lhs->get_cached_expr_type(ctx, ctx.function_context.bacteria_context->program);
         auto subContext = ExpressionContext{
                 ty
         };
@@ -345,7 +684,7 @@ namespace cheese::bacteria::nodes {
     }
 
     llvm::Value *GreaterEqualNode::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
-        auto ty = lhs->get_expr_type(ctx, ctx.function_context.bacteria_context->program);
+        auto ty = lhs->get_cached_expr_type(ctx, ctx.function_context.bacteria_context->program);
         auto subContext = ExpressionContext{
                 ty
         };
@@ -377,17 +716,25 @@ namespace cheese::bacteria::nodes {
         return program->get_type(BacteriaType::Type::UnsignedInteger, 1);
     }
 
+    // Vectors do their arithmetic lane by lane, so the instruction is picked by the lane type
+    static BacteriaType *arithmetic_type(BacteriaType *type) {
+        return type->type == BacteriaType::Type::Vector ? type->subtype : type;
+    }
+
     llvm::Value *AdditionNode::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
-        auto ty = lhs->get_expr_type(ctx, ctx.function_context.bacteria_context->program);
+        auto ty = lhs->get_cached_expr_type(ctx, ctx.function_context.bacteria_context->program);
         auto subContext = ExpressionContext{
                 ty
         };
         auto lhsValue = lhs->lower_expression_level(ctx, subContext);
         auto rhsValue = rhs->lower_expression_level(ctx, subContext);
-        switch (ty->type) {
+        switch (arithmetic_type(ty)->type) {
             case BacteriaType::Type::UnsignedInteger:
             case BacteriaType::Type::SignedInteger:
                 return ctx.scope_builder.CreateAdd(lhsValue, rhsValue);
+            case BacteriaType::Type::Float32:
+            case BacteriaType::Type::Float64:
+                return ctx.scope_builder.CreateFAdd(lhsValue, rhsValue);
             default:
                 throw LocalizedCurdleError{
                         "Invalid Comparison: Cannot do + values of type " + ty->to_string(),
@@ -398,16 +745,19 @@ namespace cheese::bacteria::nodes {
     }
 
     llvm::Value *SubtractNode::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
-        auto ty = lhs->get_expr_type(ctx, ctx.function_context.bacteria_context->program);
+        auto ty = lhs->get_cached_expr_type(ctx, ctx.function_context.bacteria_context->program);
         auto subContext = ExpressionContext{
                 ty
         };
         auto lhsValue = lhs->lower_expression_level(ctx, subContext);
         auto rhsValue = rhs->lower_expression_level(ctx, subContext);
-        switch (ty->type) {
+        switch (arithmetic_type(ty)->type) {
             case BacteriaType::Type::UnsignedInteger:
             case BacteriaType::Type::SignedInteger:
                 return ctx.scope_builder.CreateSub(lhsValue, rhsValue);
+            case BacteriaType::Type::Float32:
+            case BacteriaType::Type::Float64:
+                return ctx.scope_builder.CreateFSub(lhsValue, rhsValue);
             default:
                 throw LocalizedCurdleError{
                         "Invalid Comparison: Cannot do - values of type " + ty->to_string(),
@@ -417,18 +767,44 @@ namespace cheese::bacteria::nodes {
         }
     }
 
+    llvm::Value *MultiplyNode::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
+        auto ty = lhs->get_cached_expr_type(ctx, ctx.function_context.bacteria_context->program);
+        auto subContext = ExpressionContext{
+                ty
+        };
+        auto lhsValue = lhs->lower_expression_level(ctx, subContext);
+        auto rhsValue = rhs->lower_expression_level(ctx, subContext);
+        switch (arithmetic_type(ty)->type) {
+            case BacteriaType::Type::UnsignedInteger:
+            case BacteriaType::Type::SignedInteger:
+                return ctx.scope_builder.CreateMul(lhsValue, rhsValue);
+            case BacteriaType::Type::Float32:
+            case BacteriaType::Type::Float64:
+                return ctx.scope_builder.CreateFMul(lhsValue, rhsValue);
+            default:
+                throw LocalizedCurdleError{
+                        "Invalid Comparison: Cannot do * values of type " + ty->to_string(),
+                        location,
+                        error::ErrorCode::InvalidComparison
+                };
+        }
+    }
+
     llvm::Value *ModulusNode::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
-        auto ty = lhs->get_expr_type(ctx, ctx.function_context.bacteria_context->program);
+        auto ty = lhs->get_cached_expr_type(ctx, ctx.function_context.bacteria_context->program);
         auto subContext = ExpressionContext{
                 ty
         };
         auto lhsValue = lhs->lower_expression_level(ctx, subContext);
         auto rhsValue = rhs->lower_expression_level(ctx, subContext);
-        switch (ty->type) {
+        switch (arithmetic_type(ty)->type) {
             case BacteriaType::Type::UnsignedInteger:
                 return ctx.scope_builder.CreateURem(lhsValue, rhsValue);
             case BacteriaType::Type::SignedInteger:
                 return ctx.scope_builder.CreateSRem(lhsValue, rhsValue);
+            case BacteriaType::Type::Float32:
+            case BacteriaType::Type::Float64:
+                return ctx.scope_builder.CreateFRem(lhsValue, rhsValue);
             default:
                 throw LocalizedCurdleError{
                         "Invalid Comparison: Cannot do % values of type " + ty->to_string(),
@@ -439,17 +815,20 @@ namespace cheese::bacteria::nodes {
     }
 
     llvm::Value *DivisionNode::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
-        auto ty = lhs->get_expr_type(ctx, ctx.function_context.bacteria_context->program);
+        auto ty = lhs->get_cached_expr_type(ctx, ctx.function_context.bacteria_context->program);
         auto subContext = ExpressionContext{
                 ty
         };
         auto lhsValue = lhs->lower_expression_level(ctx, subContext);
         auto rhsValue = rhs->lower_expression_level(ctx, subContext);
-        switch (ty->type) {
+        switch (arithmetic_type(ty)->type) {
             case BacteriaType::Type::UnsignedInteger:
                 return ctx.scope_builder.CreateUDiv(lhsValue, rhsValue);
             case BacteriaType::Type::SignedInteger:
                 return ctx.scope_builder.CreateSDiv(lhsValue, rhsValue);
+            case BacteriaType::Type::Float32:
+            case BacteriaType::Type::Float64:
+                return ctx.scope_builder.CreateFDiv(lhsValue, rhsValue);
             default:
                 throw LocalizedCurdleError{
                         "Invalid Comparison: Cannot do / values of type " + ty->to_string(),
@@ -460,7 +839,11 @@ namespace cheese::bacteria::nodes {
     }
 
     llvm::Value *ValueReference::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
-        return ctx.get_info(name)->load_value(ctx.scope_builder, ctx.function_context.bacteria_context->global_context);
+        auto info = ctx.get_info(name);
+        if (info->in_registers) {
+            return ctx.function_context.read_variable(info, ctx.scope_builder.GetInsertBlock());
+        }
+        return info->load_value(ctx.scope_builder, ctx.function_context.bacteria_context->global_context);
     }
 
     TypePtr ValueReference::get_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program) {
@@ -478,23 +861,88 @@ namespace cheese::bacteria::nodes {
         return ctx.scope_builder.getInt(apInt);
     }
 
+    llvm::Value *FloatLiteral::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
+        return llvm::ConstantFP::get(type->get_llvm_type(ctx.function_context.bacteria_context->global_context), value);
+    }
+
     TypePtr IntegerLiteral::get_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program) {
-        return BacteriaNode::get_expr_type(ctx, program);
+        return type;
     }
 
     TypePtr ArrayIndexNode::get_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program) {
-        return array->get_expr_type(ctx, program)->index_type(program, arguments.size());
+        return array->get_cached_expr_type(ctx, program)->index_type(program, arguments.size());
+    }
+
+    // Traps unless the index is below the length, the trap is weighted as never being taken so that the in bounds path
+    // stays the fall through
+    static void emit_bounds_check(ScopeContext &ctx, llvm::Value *index, llvm::Value *length) {
+        auto &context = ctx.function_context.bacteria_context->context;
+        auto in_bounds = ctx.scope_builder.CreateICmpULT(index, length);
+        auto trap_block = ctx.create_block(".out-of-bounds");
+        auto cont_block = ctx.create_block(".in-bounds", false);
+        ctx.scope_builder.CreateCondBr(in_bounds, cont_block, trap_block,
+                                       llvm::MDBuilder(context).createBranchWeights(1 << 20, 1));
+        ctx.function_context.seal_block(trap_block);
+        llvm::IRBuilder<> trap_builder{trap_block};
+        trap_builder.CreateIntrinsic(llvm::Intrinsic::trap, {}, {});
+        trap_builder.CreateUnreachable();
+        ctx.attach_block(cont_block);
+        ctx.function_context.seal_block(cont_block);
+        ctx.set_current_block(cont_block);
+    }
+
+    static bool should_check_bounds(ArrayIndexNode *node) {
+        return node->checked && configuration::bounds_checks_enabled();
+    }
+
+    static void check_array_bounds(ScopeContext &ctx, ArrayIndexNode *node, BacteriaType *arr_type,
+                                   const std::vector<llvm::Value *> &indices) {
+        if (!should_check_bounds(node)) return;
+        for (std::size_t i = 0; i < indices.size() && i < arr_type->array_dimensions.size(); i++) {
+            emit_bounds_check(ctx, indices[i],
+                              llvm::ConstantInt::get(indices[i]->getType(), arr_type->array_dimensions[i]));
+        }
+    }
+
+    // Slices index through their pointer, after their length has been checked
+    static llvm::Value *get_slice_element_address(ScopeContext &ctx, ArrayIndexNode *node, BacteriaType *slice_type) {
+        auto gctx = ctx.function_context.bacteria_context->global_context;
+        auto program = ctx.function_context.bacteria_context->program;
+        ExpressionContext usizeContext{
+                program->get_type(BacteriaType::Type::UnsignedInteger, gctx->machine.data_pointer_size * 8)
+        };
+        ExpressionContext sliceContext{
+                slice_type
+        };
+        auto slice = node->array->lower_expression_level(ctx, sliceContext);
+        auto index = node->arguments[0]->lower_expression_level(ctx, usizeContext);
+        if (should_check_bounds(node)) {
+            emit_bounds_check(ctx, index, ctx.scope_builder.CreateExtractValue(slice, {0}));
+        }
+        return ctx.scope_builder.CreateGEP(slice_type->subtype->get_llvm_type(gctx),
+                                           ctx.scope_builder.CreateExtractValue(slice, {1}), {index});
     }
 
     llvm::Value *ArrayIndexNode::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
-        auto arr_type = array->get_expr_type(ctx, ctx.function_context.bacteria_context->program);
+        auto arr_type = array->get_cached_expr_type(ctx, ctx.function_context.bacteria_context->program);
         switch (arr_type->type) {
+            case BacteriaType::Type::Slice: {
+                auto subtype = arr_type->subtype;
+                auto ep = get_slice_element_address(ctx, this, arr_type);
+                if (subtype->type != BacteriaType::Type::Array) { // We don't want to load arrays ...
+                    return ctx.scope_builder.CreateAlignedLoad(
+                            subtype->get_llvm_type(ctx.function_context.bacteria_context->global_context), ep,
+                            get_address_alignment(ctx));
+                } else {
+                    return ep;
+                }
+            }
             case BacteriaType::Type::Pointer: {
                 auto subtype = arr_type->subtype;
                 auto subtypeLLVM = subtype->get_llvm_type(ctx.function_context.bacteria_context->global_context);
                 ExpressionContext usizeContext{
                         ctx.function_context.bacteria_context->program->get_type(BacteriaType::Type::UnsignedInteger,
-                                                                                 ctx.function_context.bacteria_context->global_context->machine.data_pointer_size)
+                                                                                 ctx.function_context.bacteria_context->global_context->machine.data_pointer_size * 8)
                 };
                 ExpressionContext arrayContext{
                         arr_type
@@ -504,7 +952,7 @@ namespace cheese::bacteria::nodes {
 
                 auto ep = ctx.scope_builder.CreateGEP(subtypeLLVM, ptr, {index});
                 if (subtype->type != BacteriaType::Type::Array) { // We don't want to load arrays ...
-                    return ctx.scope_builder.CreateLoad(subtypeLLVM, ep);
+                    return ctx.scope_builder.CreateAlignedLoad(subtypeLLVM, ep, get_address_alignment(ctx));
                 } else {
                     return ep;
                 }
@@ -514,7 +962,7 @@ namespace cheese::bacteria::nodes {
                 auto subtypeLLVM = subtype->get_llvm_type(ctx.function_context.bacteria_context->global_context);
                 ExpressionContext usizeContext{
                         ctx.function_context.bacteria_context->program->get_type(BacteriaType::Type::UnsignedInteger,
-                                                                                 ctx.function_context.bacteria_context->global_context->machine.data_pointer_size)
+                                                                                 ctx.function_context.bacteria_context->global_context->machine.data_pointer_size * 8)
                 };
                 ExpressionContext arrayContext{
                         arr_type
@@ -524,15 +972,30 @@ namespace cheese::bacteria::nodes {
                 for (const auto &child: arguments) {
                     indices.push_back(child->lower_expression_level(ctx, usizeContext));
                 }
+                check_array_bounds(ctx, this, arr_type, indices);
+                // The array value is a pointer to the whole array, so the first index steps over that pointer
+                indices.insert(indices.begin(), ctx.scope_builder.getInt32(0));
                 auto ep = ctx.scope_builder.CreateGEP(
                         arr_type->get_llvm_type(ctx.function_context.bacteria_context->global_context), ptr, indices);
                 if (subtype->type != BacteriaType::Type::Array &&
                     indices.size() >= arr_type->array_dimensions.size()) { // We don't want to load arrays ...
-                    return ctx.scope_builder.CreateLoad(subtypeLLVM, ep);
+                    return ctx.scope_builder.CreateAlignedLoad(subtypeLLVM, ep, get_address_alignment(ctx));
                 } else {
                     return ep;
                 }
             }
+            case BacteriaType::Type::Vector: {
+                ExpressionContext usizeContext{
+                        ctx.function_context.bacteria_context->program->get_type(BacteriaType::Type::UnsignedInteger,
+                                                                                 ctx.function_context.bacteria_context->global_context->machine.data_pointer_size * 8)
+                };
+                ExpressionContext vectorContext{
+                        arr_type
+                };
+                auto vector = array->lower_expression_level(ctx, vectorContext);
+                auto index = arguments[0]->lower_expression_level(ctx, usizeContext);
+                return ctx.scope_builder.CreateExtractElement(vector, index);
+            }
             default:
                 throw LocalizedCurdleError{
                         "Invalid Index: Cannot index values of type " + arr_type->to_string(),
@@ -544,14 +1007,16 @@ namespace cheese::bacteria::nodes {
     }
 
     llvm::Value *ArrayIndexNode::lower_address(ScopeContext &ctx) {
-        auto arr_type = array->get_expr_type(ctx, ctx.function_context.bacteria_context->program);
+        auto arr_type = array->get_cached_expr_type(ctx, ctx.function_context.bacteria_context->program);
         switch (arr_type->type) {
+            case BacteriaType::Type::Slice:
+                return get_slice_element_address(ctx, this, arr_type);
             case BacteriaType::Type::Pointer: {
                 auto subtype = arr_type->subtype;
                 auto subtypeLLVM = subtype->get_llvm_type(ctx.function_context.bacteria_context->global_context);
                 ExpressionContext usizeContext{
                         ctx.function_context.bacteria_context->program->get_type(BacteriaType::Type::UnsignedInteger,
-                                                                                 ctx.function_context.bacteria_context->global_context->machine.data_pointer_size)
+                                                                                 ctx.function_context.bacteria_context->global_context->machine.data_pointer_size * 8)
                 };
                 ExpressionContext arrayContext{
                         arr_type
@@ -567,7 +1032,7 @@ namespace cheese::bacteria::nodes {
                 auto subtypeLLVM = subtype->get_llvm_type(ctx.function_context.bacteria_context->global_context);
                 ExpressionContext usizeContext{
                         ctx.function_context.bacteria_context->program->get_type(BacteriaType::Type::UnsignedInteger,
-                                                                                 ctx.function_context.bacteria_context->global_context->machine.data_pointer_size)
+                                                                                 ctx.function_context.bacteria_context->global_context->machine.data_pointer_size * 8)
                 };
                 ExpressionContext arrayContext{
                         arr_type
@@ -577,10 +1042,24 @@ namespace cheese::bacteria::nodes {
                 for (const auto &child: arguments) {
                     indices.push_back(child->lower_expression_level(ctx, usizeContext));
                 }
+                check_array_bounds(ctx, this, arr_type, indices);
+                // The array value is a pointer to the whole array, so the first index steps over that pointer
+                indices.insert(indices.begin(), ctx.scope_builder.getInt32(0));
                 auto ep = ctx.scope_builder.CreateGEP(
                         arr_type->get_llvm_type(ctx.function_context.bacteria_context->global_context), ptr, indices);
                 return ep;
             }
+            case BacteriaType::Type::Vector: {
+                ExpressionContext usizeContext{
+                        ctx.function_context.bacteria_context->program->get_type(BacteriaType::Type::UnsignedInteger,
+                                                                                 ctx.function_context.bacteria_context->global_context->machine.data_pointer_size * 8)
+                };
+                auto ptr = array->lower_address(ctx);
+                auto index = arguments[0]->lower_expression_level(ctx, usizeContext);
+                return ctx.scope_builder.CreateGEP(
+                        arr_type->get_llvm_type(ctx.function_context.bacteria_context->global_context), ptr,
+                        {ctx.scope_builder.getInt32(0), index});
+            }
             default:
                 throw LocalizedCurdleError{
                         "Invalid Index: Cannot index values of type " + arr_type->to_string(),
@@ -590,6 +1069,18 @@ namespace cheese::bacteria::nodes {
         }
     }
 
+    llvm::Align ArrayIndexNode::get_address_alignment(ScopeContext &ctx) {
+        auto gctx = ctx.function_context.bacteria_context->global_context;
+        auto program = ctx.function_context.bacteria_context->program;
+        auto arr_type = array->get_cached_expr_type(ctx, program);
+        auto element_type = get_cached_expr_type(ctx, program);
+        auto natural = element_type->get_llvm_alignment(gctx);
+        if (arr_type->type != BacteriaType::Type::Array && arr_type->type != BacteriaType::Type::Vector) return natural;
+        // Arrays and vectors are stored inline, so an element is only as aligned as the storage it sits in allows
+        auto element_size = gctx->machine.layout.getTypeAllocSize(element_type->get_llvm_type(gctx));
+        return std::min(natural, llvm::commonAlignment(array->get_address_alignment(ctx), element_size));
+    }
+
     void VariableInitializationNode::lower_scope_level(ScopeContext &ctx) {
         ExpressionContext valueContext{
                 type
@@ -597,11 +1088,22 @@ namespace cheese::bacteria::nodes {
         auto val = value->lower_expression_level(ctx, valueContext);
         if (constant) {
             auto info = ctx.get_immutable_variable(name, type);
-            val->setName(info->name);
+            // Constant arrays are the address of a global, which keeps its own name
+            if (!llvm::isa<llvm::GlobalValue>(val)) val->setName(info->name);
             info->value = val;
         } else {
             auto info = ctx.get_mutable_variable(name, type);
-            ctx.scope_builder.CreateStore(val, info->value);
+            if (type->type == BacteriaType::Type::Array) {
+                // The value is the address of the array, so its elements get copied over
+                auto gctx = ctx.function_context.bacteria_context->global_context;
+                auto alignment = type->get_llvm_alignment(gctx);
+                ctx.scope_builder.CreateMemCpy(info->value, alignment, val, alignment,
+                                               gctx->machine.layout.getTypeAllocSize(type->get_llvm_type(gctx)));
+            } else if (info->in_registers) {
+                ctx.function_context.write_variable(info, ctx.scope_builder.GetInsertBlock(), val);
+            } else {
+                ctx.scope_builder.CreateStore(val, info->value);
+            }
         }
     }
 
@@ -612,13 +1114,336 @@ namespace cheese::bacteria::nodes {
 
 
     void MutationNode::lower_scope_level(ScopeContext &ctx) {
+        // Writing a lane of a vector that lives in registers has no address to store to, so the lane is inserted instead
+        if (auto index = dynamic_cast<ArrayIndexNode *>(lhs.get())) {
+            auto reference = dynamic_cast<ValueReference *>(index->array.get());
+            auto info = reference ? ctx.get_info(reference->name) : nullptr;
+            if (info && info->in_registers && info->type->type == BacteriaType::Type::Vector) {
+                ExpressionContext usizeContext{
+                        ctx.function_context.bacteria_context->program->get_type(BacteriaType::Type::UnsignedInteger,
+                                                                                 ctx.function_context.bacteria_context->global_context->machine.data_pointer_size * 8)
+                };
+                ExpressionContext laneContext{
+                        info->type->subtype
+                };
+                auto lane = index->arguments[0]->lower_expression_level(ctx, usizeContext);
+                auto value = rhs->lower_expression_level(ctx, laneContext);
+                auto vector = ctx.function_context.read_variable(info, ctx.scope_builder.GetInsertBlock());
+                ctx.function_context.write_variable(info, ctx.scope_builder.GetInsertBlock(),
+                                                    ctx.scope_builder.CreateInsertElement(vector, value, lane));
+                return;
+            }
+        }
+        if (auto reference = dynamic_cast<ValueReference *>(lhs.get())) {
+            auto info = ctx.get_info(reference->name);
+            if (info->in_registers) {
+                ExpressionContext expressionContext{
+                        info->type
+                };
+                auto value = rhs->lower_expression_level(ctx, expressionContext);
+                ctx.function_context.write_variable(info, ctx.scope_builder.GetInsertBlock(), value);
+                return;
+            }
+        }
         auto lhs_addr = lhs->lower_address(ctx);
-        auto lhs_ty = lhs->get_expr_type(ctx, ctx.function_context.bacteria_context->program);
+        auto lhs_ty = lhs->get_cached_expr_type(ctx, ctx.function_context.bacteria_context->program);
         ExpressionContext expressionContext{
                 lhs_ty
         };
-        ctx.scope_builder.CreateStore(rhs->lower_expression_level(ctx, expressionContext), lhs_addr);
+        ctx.scope_builder.CreateAlignedStore(rhs->lower_expression_level(ctx, expressionContext), lhs_addr,
+                                             lhs->get_address_alignment(ctx));
+    }
+
+
+    bool AggregrateObject::is_constant() {
+        return std::all_of(values.begin(), values.end(), [](BacteriaPtr &value) {
+            if (auto as_aggregate = dynamic_cast<AggregrateObject *>(value.get()); as_aggregate) {
+                return as_aggregate->is_constant();
+            }
+            return dynamic_cast<IntegerLiteral *>(value.get()) != nullptr ||
+                   dynamic_cast<FloatLiteral *>(value.get()) != nullptr ||
+                   dynamic_cast<StringLiteral *>(value.get()) != nullptr;
+        });
+    }
+
+    llvm::Constant *AggregrateObject::lower_constant(ScopeContext &ctx) {
+        auto gctx = ctx.function_context.bacteria_context->global_context;
+        std::vector<llvm::Constant *> constants;
+        for (size_t i = 0; i < values.size(); i++) {
+            auto child_type = type->type == BacteriaType::Type::Vector || type->type == BacteriaType::Type::Array
+                              ? type->subtype : type->child_types[i];
+            if (auto as_aggregate = dynamic_cast<AggregrateObject *>(values[i].get()); as_aggregate) {
+                constants.push_back(as_aggregate->lower_constant(ctx));
+            } else {
+                // Literals lower straight to constants without emitting anything
+                ExpressionContext childContext{
+                        child_type
+                };
+                constants.push_back(llvm::cast<llvm::Constant>(values[i]->lower_expression_level(ctx, childContext)));
+            }
+        }
+        if (type->type == BacteriaType::Type::Vector) return llvm::ConstantVector::get(constants);
+        if (type->type == BacteriaType::Type::Array) {
+            // The values are flat, so they get grouped up one dimension at a time, starting from the innermost
+            llvm::Type *element_type = type->subtype->get_llvm_type(gctx);
+            for (auto dimension = type->array_dimensions.rbegin(); dimension != type->array_dimensions.rend();
+                 dimension++) {
+                auto group_type = llvm::ArrayType::get(element_type, *dimension);
+                std::vector<llvm::Constant *> groups;
+                for (size_t i = 0; i < constants.size(); i += *dimension) {
+                    groups.push_back(llvm::ConstantArray::get(group_type, llvm::ArrayRef(constants).slice(i,
+                                                                                                          *dimension)));
+                }
+                constants = std::move(groups);
+                element_type = group_type;
+            }
+            return constants[0];
+        }
+        // Padding inserted for an explicit layout is left zeroed
+        auto struct_type = llvm::cast<llvm::StructType>(type->get_llvm_type(gctx));
+        std::vector<llvm::Constant *> elements;
+        for (auto element: struct_type->elements()) {
+            elements.push_back(llvm::Constant::getNullValue(element));
+        }
+        for (size_t i = 0; i < constants.size(); i++) {
+            elements[type->get_field_index(gctx, i)] = constants[i];
+        }
+        return llvm::ConstantStruct::get(struct_type, elements);
+    }
+
+    llvm::Value *AggregrateObject::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
+        auto gctx = ctx.function_context.bacteria_context->global_context;
+        // Array values are the address of the array, so a constant one is always the address of its global
+        if (type->type == BacteriaType::Type::Array && is_constant()) {
+            return ctx.function_context.bacteria_context->get_aggregate_constant(lower_constant(ctx),
+                                                                                 type->get_llvm_alignment(gctx));
+        }
+        if ((type->type == BacteriaType::Type::Vector || type->type == BacteriaType::Type::Object) && is_constant()) {
+            auto constant = lower_constant(ctx);
+            // Anything too big to be passed around in registers gets read out of a constant in .rodata instead of
+            // being built up field by field
+            if (type->get_passing(gctx) != BacteriaType::Passing::Indirect) return constant;
+            auto global = ctx.function_context.bacteria_context->get_aggregate_constant(constant,
+                                                                                       type->get_llvm_alignment(gctx));
+            return ctx.scope_builder.CreateAlignedLoad(constant->getType(), global, type->get_llvm_alignment(gctx));
+        }
+        llvm::Value *result = llvm::PoisonValue::get(type->get_llvm_type(gctx));
+        switch (type->type) {
+            case BacteriaType::Type::Vector: {
+                ExpressionContext laneContext{
+                        type->subtype
+                };
+                for (size_t i = 0; i < values.size(); i++) {
+                    auto lane = values[i]->lower_expression_level(ctx, laneContext);
+                    result = ctx.scope_builder.CreateInsertElement(result, lane, static_cast<std::uint64_t>(i));
+                }
+                return result;
+            }
+            case BacteriaType::Type::Object: {
+                for (size_t i = 0; i < values.size(); i++) {
+                    ExpressionContext childContext{
+                            type->child_types[i]
+                    };
+                    auto child = values[i]->lower_expression_level(ctx, childContext);
+                    result = ctx.scope_builder.CreateInsertValue(result, child, {type->get_field_index(gctx, i)});
+                }
+                return result;
+            }
+            default:
+                NOT_IMPL_FOR(type->to_string());
+        }
+    }
+
+    // Subscripts index by declared field, which get_field_index maps onto the field in the lowered layout
+    TypePtr ObjectSubscriptNode::get_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program) {
+        return child->get_cached_expr_type(ctx, program)->child_types[index];
+    }
+
+    llvm::Value *ObjectSubscriptNode::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
+        auto gctx = ctx.function_context.bacteria_context->global_context;
+        auto object_type = child->get_cached_expr_type(ctx, ctx.function_context.bacteria_context->program);
+        ExpressionContext objectContext{
+                object_type
+        };
+        auto object = child->lower_expression_level(ctx, objectContext);
+        return ctx.scope_builder.CreateExtractValue(object, {object_type->get_field_index(gctx, index)});
+    }
+
+    llvm::Value *ObjectSubscriptNode::lower_address(ScopeContext &ctx) {
+        auto gctx = ctx.function_context.bacteria_context->global_context;
+        auto object_type = child->get_cached_expr_type(ctx, ctx.function_context.bacteria_context->program);
+        auto object = child->lower_address(ctx);
+        return ctx.scope_builder.CreateStructGEP(object_type->get_llvm_type(gctx), object,
+                                                 object_type->get_field_index(gctx, index));
+    }
+
+    llvm::Align ObjectSubscriptNode::get_address_alignment(ScopeContext &ctx) {
+        auto gctx = ctx.function_context.bacteria_context->global_context;
+        auto object_type = child->get_cached_expr_type(ctx, ctx.function_context.bacteria_context->program);
+        return llvm::commonAlignment(child->get_address_alignment(ctx), object_type->get_field_offset(gctx, index));
     }
 
+    TypePtr ReferenceSubscriptNode::get_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program) {
+        return child->get_cached_expr_type(ctx, program)->subtype->child_types[index];
+    }
+
+    llvm::Value *ReferenceSubscriptNode::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
+        auto gctx = ctx.function_context.bacteria_context->global_context;
+        auto program = ctx.function_context.bacteria_context->program;
+        auto field_type = get_cached_expr_type(ctx, program);
+        return ctx.scope_builder.CreateAlignedLoad(field_type->get_llvm_type(gctx), lower_address(ctx),
+                                                   get_address_alignment(ctx));
+    }
+
+    llvm::Value *ReferenceSubscriptNode::lower_address(ScopeContext &ctx) {
+        auto gctx = ctx.function_context.bacteria_context->global_context;
+        auto reference_type = child->get_cached_expr_type(ctx, ctx.function_context.bacteria_context->program);
+        ExpressionContext referenceContext{
+                reference_type
+        };
+        auto reference = child->lower_expression_level(ctx, referenceContext);
+        return ctx.scope_builder.CreateStructGEP(reference_type->subtype->get_llvm_type(gctx), reference,
+                                                 reference_type->subtype->get_field_index(gctx, index));
+    }
+
+    llvm::Align ReferenceSubscriptNode::get_address_alignment(ScopeContext &ctx) {
+        auto gctx = ctx.function_context.bacteria_context->global_context;
+        auto object_type = child->get_cached_expr_type(ctx, ctx.function_context.bacteria_context->program)->subtype;
+        return llvm::commonAlignment(object_type->get_llvm_alignment(gctx), object_type->get_field_offset(gctx, index));
+    }
+
+    TypePtr SliceNode::get_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program) {
+        return type;
+    }
+
+    llvm::Value *SliceNode::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
+        auto gctx = ctx.function_context.bacteria_context->global_context;
+        auto program = ctx.function_context.bacteria_context->program;
+        ExpressionContext pointerContext{
+                pointer->get_cached_expr_type(ctx, program)
+        };
+        ExpressionContext usizeContext{
+                program->get_type(BacteriaType::Type::UnsignedInteger, gctx->machine.data_pointer_size * 8)
+        };
+        llvm::Value *result = llvm::PoisonValue::get(type->get_llvm_type(gctx));
+        result = ctx.scope_builder.CreateInsertValue(result, length->lower_expression_level(ctx, usizeContext), {0});
+        return ctx.scope_builder.CreateInsertValue(result, pointer->lower_expression_level(ctx, pointerContext), {1});
+    }
+
+    // Slice members can be read either from a slice value, or through a reference to one without loading the rest of it
+    static llvm::Value *lower_slice_member(ScopeContext &ctx, BacteriaNode *child, unsigned member) {
+        auto gctx = ctx.function_context.bacteria_context->global_context;
+        auto program = ctx.function_context.bacteria_context->program;
+        auto child_type = child->get_cached_expr_type(ctx, program);
+        ExpressionContext childContext{
+                child_type
+        };
+        auto value = child->lower_expression_level(ctx, childContext);
+        if (child_type->type == BacteriaType::Type::Reference) {
+            auto slice_type = child_type->subtype->get_llvm_type(gctx);
+            return ctx.scope_builder.CreateLoad(slice_type->getStructElementType(member),
+                                                ctx.scope_builder.CreateStructGEP(slice_type, value, member));
+        }
+        return ctx.scope_builder.CreateExtractValue(value, {member});
+    }
+
+    static BacteriaType *get_slice_type(ScopeContext &ctx, BacteriaNode *child, nodes::BacteriaProgram *program) {
+        auto child_type = child->get_cached_expr_type(ctx, program);
+        return child_type->type == BacteriaType::Type::Reference ? child_type->subtype : child_type;
+    }
+
+    TypePtr SliceLengthNode::get_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program) {
+        return program->get_type(BacteriaType::Type::UnsignedInteger,
+                                 ctx.function_context.bacteria_context->global_context->machine.data_pointer_size * 8);
+    }
+
+    llvm::Value *SliceLengthNode::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
+        return lower_slice_member(ctx, child.get(), 0);
+    }
+
+    TypePtr SlicePointerNode::get_expr_type(ScopeContext &ctx, nodes::BacteriaProgram *program) {
+        auto slice_type = get_slice_type(ctx, child.get(), program);
+        return program->get_type(BacteriaType::Type::Pointer, 0, slice_type->subtype, {}, {}, {},
+                                 slice_type->constant_ref);
+    }
+
+    llvm::Value *SlicePointerNode::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
+        return lower_slice_member(ctx, child.get(), 1);
+    }
+
+    llvm::Value *VectorShuffle::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
+        auto program = ctx.function_context.bacteria_context->program;
+        ExpressionContext lhsContext{
+                lhs->get_cached_expr_type(ctx, program)
+        };
+        ExpressionContext rhsContext{
+                rhs->get_cached_expr_type(ctx, program)
+        };
+        auto lhsValue = lhs->lower_expression_level(ctx, lhsContext);
+        auto rhsValue = rhs->lower_expression_level(ctx, rhsContext);
+        return ctx.scope_builder.CreateShuffleVector(lhsValue, rhsValue, mask);
+    }
+
+    llvm::Value *VectorReduce::lower_expression_level(ScopeContext &ctx, ExpressionContext &expr) {
+        ExpressionContext vectorContext{
+                type
+        };
+        auto vector = value->lower_expression_level(ctx, vectorContext);
+        auto lane = type->subtype;
+        switch (lane->type) {
+            case BacteriaType::Type::UnsignedInteger:
+            case BacteriaType::Type::SignedInteger: {
+                auto is_signed = lane->type == BacteriaType::Type::SignedInteger;
+                switch (operation) {
+                    case Operation::Add:
+                        return ctx.scope_builder.CreateAddReduce(vector);
+                    case Operation::Mul:
+                        return ctx.scope_builder.CreateMulReduce(vector);
+                    case Operation::Min:
+                        return ctx.scope_builder.CreateIntMinReduce(vector, is_signed);
+                    case Operation::Max:
+                        return ctx.scope_builder.CreateIntMaxReduce(vector, is_signed);
+                    case Operation::And:
+                        return ctx.scope_builder.CreateAndReduce(vector);
+                    case Operation::Or:
+                        return ctx.scope_builder.CreateOrReduce(vector);
+                    case Operation::Xor:
+                        return ctx.scope_builder.CreateXorReduce(vector);
+                }
+                break;
+            }
+            case BacteriaType::Type::Float32:
+            case BacteriaType::Type::Float64: {
+                auto lane_ty = lane->get_llvm_type(ctx.function_context.bacteria_context->global_context);
+                llvm::CallInst *call;
+                // Without reassociation LLVM has to do float reductions strictly in lane order, which can't be vectorized
+                switch (operation) {
+                    case Operation::Add:
+                        call = ctx.scope_builder.CreateFAddReduce(llvm::ConstantFP::getNegativeZero(lane_ty), vector);
+                        call->setHasAllowReassoc(true);
+                        return call;
+                    case Operation::Mul:
+                        call = ctx.scope_builder.CreateFMulReduce(llvm::ConstantFP::get(lane_ty, 1.0), vector);
+                        call->setHasAllowReassoc(true);
+                        return call;
+                    case Operation::Min:
+                        return ctx.scope_builder.CreateFPMinReduce(vector);
+                    case Operation::Max:
+                        return ctx.scope_builder.CreateFPMaxReduce(vector);
+                    default:
+                        break;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        throw LocalizedCurdleError{
+                "Invalid Reduction: Cannot reduce a vector of type " + type->to_string() + " with ." +
+                operation_name(),
+                location,
+                error::ErrorCode::InvalidRuntimeOperation
+        };
+    }
 
 }
\ No newline at end of file
@@ -7,11 +7,14 @@
 #include "NotImplementedException.h"
 #include <typeinfo>
 #include <utility>
+#include <algorithm>
 #include "project/GlobalContext.h"
+#include "configuration.h"
 #include "bacteria/BacteriaContext.h"
 #include "bacteria/FunctionContext.h"
 #include "bacteria/ScopeContext.h"
 #include "bacteria/ExpressionContext.h"
+#include "curdle/curdle.h"
 
 namespace cheese::bacteria::nodes {
     std::map<std::string, int> BacteriaProgram::get_child_map() const {
@@ -58,6 +61,8 @@ namespace cheese::bacteria::nodes {
     }
 
     std::unique_ptr<llvm::Module> BacteriaProgram::lower_into_module(project::GlobalContext *ctx) {
+        // Let LLVM drop whatever names still get set (arguments and the like) outside of debug mode
+        ctx->llvm_context.setDiscardValueNames(configuration::release_mode != configuration::ReleaseMode::Debug);
         auto bacteriaModule = ctx->gc.gcnew<BacteriaContext>(ctx, this);
         ctx->gc.add_root_object(bacteriaModule);
         ctx->gc.remove_root_object(ctx);
@@ -73,26 +78,83 @@ namespace cheese::bacteria::nodes {
         return std::unique_ptr<llvm::Module>(bacteriaModule->program_module);
     }
 
+    // Finds every variable name that gets referenced (& or &&) in a function, those can't be kept in registers
+    static void find_address_taken(BacteriaPtr &node, std::unordered_set<Symbol> &names) {
+        BacteriaNode *referenced = nullptr;
+        if (auto as_reference = dynamic_cast<ReferenceNode *>(node.get()); as_reference) {
+            referenced = as_reference->child.get();
+        } else if (auto as_implicit = dynamic_cast<ImplicitReferenceNode *>(node.get()); as_implicit) {
+            referenced = as_implicit->child.get();
+        }
+        if (auto as_value = dynamic_cast<ValueReference *>(referenced); as_value) {
+            names.insert(as_value->name);
+        }
+        node->visit_children([&](BacteriaPtr &child) {
+            find_address_taken(child, names);
+        });
+    }
+
     void Function::lower_top_level(BacteriaContext *ctx) {
         auto prototype = ctx->functions[name].prototype;
         FunctionContext fctx{ctx, prototype};
         fctx.return_type = return_type;
+        for (auto &child: children) {
+            find_address_taken(child, fctx.address_taken);
+        }
         ScopeContext sctx{fctx, fctx.entry_block};
+        auto gctx = ctx->global_context;
+        auto arg = prototype->arg_begin();
+        auto &passing = ctx->functions[name].passing;
+        if (passing.returns_indirectly()) {
+            fctx.return_slot = arg++;
+        }
+        fctx.return_passing = passing.result;
         size_t idx = 0;
-        for (auto &arg: prototype->args()) {
-            fctx.all_variables[arguments[idx].name] = new VariableInfo{
+        for (auto &argument: arguments) {
+            llvm::Value *value;
+            switch (passing.arguments[idx++]) {
+                case BacteriaType::Passing::Direct:
+                    value = arg++;
+                    break;
+                case BacteriaType::Passing::Indirect:
+                case BacteriaType::Passing::Reference:
+                    // The caller already made a copy for this function, arrays are just that address
+                    value = arg++;
+                    if (argument.type->type != BacteriaType::Type::Array) {
+                        value = sctx.scope_builder.CreateLoad(argument.type->get_llvm_type(gctx), value);
+                    }
+                    break;
+                case BacteriaType::Passing::Split:
+                    value = llvm::PoisonValue::get(argument.type->get_llvm_type(gctx));
+                    for (size_t i = 0; i < argument.type->child_types.size(); i++) {
+                        value = sctx.scope_builder.CreateInsertValue(value, arg++,
+                                                                     {argument.type->get_field_index(gctx, i)});
+                    }
+                    break;
+                case BacteriaType::Passing::Coerced: {
+                    std::vector<llvm::Value *> parts;
+                    for (size_t i = 0; i < argument.type->get_coerced_types(gctx).size(); i++) {
+                        parts.push_back(arg++);
+                    }
+                    value = fctx.coerce_from_parts(sctx.scope_builder, argument.type, parts);
+                    break;
+                }
+            }
+            auto info = new VariableInfo{
                     true,
-                    arguments[idx].name,
-                    arguments[idx].type,
-                    &arg
+                    argument.name,
+                    argument.type,
+                    value
             };
-            sctx.variable_renames[arguments[idx].name] = arguments[idx].name;
-            idx += 1;
+            fctx.all_variables.push_back(info);
+            fctx.all_variable_names.insert(argument.name);
+            sctx.variable_renames[argument.name] = info;
         }
 
         for (const auto &child: children) {
             child->lower_scope_level(sctx);
         }
+        fctx.seal_all_blocks();
 
         if (fctx.return_type->type == BacteriaType::Type::Void &&
             !cheese::util::llvm::has_terminator(sctx.current_block)) {
@@ -101,25 +163,110 @@ namespace cheese::bacteria::nodes {
     }
 
     void Function::gen_protos(BacteriaContext *ctx) {
-        auto returnType = return_type->get_llvm_type(ctx->global_context);
-        std::vector<llvm::Type *> argTypes;
+        auto gctx = ctx->global_context;
         std::vector<TypePtr> bacteriaArgTypes;
         for (auto &arg: arguments) {
-            argTypes.push_back(arg.type->get_llvm_type(ctx->global_context));
             bacteriaArgTypes.push_back(arg.type);
         }
-        auto functionType = llvm::FunctionType::get(returnType, argTypes, false);
-        auto prototype = llvm::Function::Create(functionType, llvm::Function::ExternalLinkage, name,
+        auto passing = SignaturePassing::get(gctx, return_type, bacteriaArgTypes, external);
+        if (!passing.supported) {
+            throw curdle::LocalizedCurdleError{
+                    "Unsupported calling convention: the C ABI of " + gctx->machine.triple +
+                    " isn't known, so structures can't be passed to or returned from " + name,
+                    location,
+                    error::ErrorCode::UnsupportedCallingConvention
+            };
+        }
+        auto returns_indirectly = passing.returns_indirectly();
+        auto functionType = passing.get_function_type(gctx, return_type, bacteriaArgTypes);
+        // Nothing outside the module can see a function that isn't exported, so LLVM is free to inline or drop it
+        auto prototype = llvm::Function::Create(functionType, external ? llvm::Function::ExternalLinkage
+                                                                       : llvm::Function::InternalLinkage, name,
                                                 ctx->program_module);
+        // The vectorizer and instruction selection go off of these rather than the target machine
+        auto &machine = gctx->machine;
+        prototype->addFnAttr("target-cpu", machine.cpu);
+        if (!machine.features.empty()) {
+            prototype->addFnAttr("target-features", machine.features);
+        }
+        // An exported function has to keep its own body anyways, so it only gets the hint
+        if (is_inline) {
+            prototype->addFnAttr(external ? llvm::Attribute::InlineHint : llvm::Attribute::AlwaysInline);
+        }
+        // Cheese has no unwinding, so nothing it defines can throw
+        prototype->setDoesNotThrow();
+        // Writing the result out is a write the inference can't see, and reading a byval copy is still a read
+        auto effects = memory_effects;
+        if (returns_indirectly) {
+            effects = MemoryEffects::Unknown;
+        } else if (effects == MemoryEffects::None &&
+                   std::any_of(passing.arguments.begin(), passing.arguments.end(), [](BacteriaType::Passing argument) {
+                       return argument == BacteriaType::Passing::Indirect ||
+                              argument == BacteriaType::Passing::Reference;
+                   })) {
+            effects = MemoryEffects::ReadOnly;
+        }
+        switch (effects) {
+            case MemoryEffects::None:
+                prototype->setDoesNotAccessMemory();
+                break;
+            case MemoryEffects::ReadOnly:
+                prototype->setOnlyReadsMemory();
+                break;
+            case MemoryEffects::Unknown:
+                break;
+        }
+        passing.add_attributes(gctx, prototype, return_type, bacteriaArgTypes);
+        unsigned arg_no = 0;
+        if (returns_indirectly) {
+            prototype->getArg(arg_no)->setName("$result");
+            arg_no++;
+        }
         size_t idx = 0;
-        for (auto &arg: prototype->args()) {
-            arg.setName(arguments[idx++].name);
+        for (auto &argument: arguments) {
+            auto argument_type = argument.type;
+            switch (passing.arguments[idx++]) {
+                case BacteriaType::Passing::Direct: {
+                    auto arg = prototype->getArg(arg_no);
+                    arg->setName(argument.name);
+                    if (argument_type->type == BacteriaType::Type::Reference) {
+                        // References always point to a live value, unlike pointers
+                        prototype->addParamAttr(arg_no, llvm::Attribute::NonNull);
+                        if (argument_type->subtype->get_llvm_type(gctx)->isSized()) {
+                            auto size = argument_type->subtype->get_llvm_size(gctx);
+                            if (size != 0) prototype->addDereferenceableParamAttr(arg_no, size);
+                        }
+                        if (argument_type->constant_ref) prototype->addParamAttr(arg_no, llvm::Attribute::ReadOnly);
+                    }
+                    // With no writes anywhere in the call, nothing can be observed through another pointer to the same memory
+                    if (effects == MemoryEffects::ReadOnly && arg->getType()->isPointerTy()) {
+                        prototype->addParamAttr(arg_no, llvm::Attribute::NoAlias);
+                    }
+                    arg_no++;
+                    break;
+                }
+                case BacteriaType::Passing::Indirect:
+                case BacteriaType::Passing::Reference:
+                    prototype->getArg(arg_no++)->setName(argument.name);
+                    break;
+                case BacteriaType::Passing::Split:
+                    for (size_t i = 0; i < argument_type->child_types.size(); i++) {
+                        prototype->getArg(arg_no++)->setName(argument.name + "." + std::to_string(i));
+                    }
+                    break;
+                case BacteriaType::Passing::Coerced:
+                    for (size_t i = 0; i < argument_type->get_coerced_types(gctx).size(); i++) {
+                        prototype->getArg(arg_no++)->setName(argument.name + ".coerce" + std::to_string(i));
+                    }
+                    break;
+            }
         }
         ctx->functions[name] = FunctionInfo{
                 bacteriaArgTypes,
                 return_type,
                 name,
-                prototype
+                prototype,
+                passing
         };
     }
 
@@ -18,6 +18,8 @@ namespace cheese::configuration {
     bool log_errors = true;
     bool warnings_are_errors = false;
     bool die_on_first_error = false;
+    bool ssa_lowering = true;
+    BoundsChecks bounds_checks = BoundsChecks::Debug;
 
     std::function<void(std::string)> error_output_handler = default_error_output_handler;
 
@@ -46,6 +48,18 @@ namespace cheese::configuration {
 #endif
     }
 
+    bool bounds_checks_enabled() {
+        switch (bounds_checks) {
+            case BoundsChecks::Always:
+                return true;
+            case BoundsChecks::Debug:
+                return release_mode == ReleaseMode::Debug;
+            case BoundsChecks::Never:
+                return false;
+        }
+        return false;
+    }
+
     void default_error_output_handler(std::string err) {
         std::cout << err;
     }
@@ -20,6 +20,8 @@
 #include "curdle/types/FunctionPointerType.h"
 #include "curdle/types/PointerType.h"
 #include "curdle/types/ArrayType.h"
+#include "curdle/types/SliceType.h"
+#include "curdle/types/VectorType.h"
 
 namespace cheese::curdle {
 
@@ -67,6 +69,10 @@ namespace cheese::curdle {
         for (int i = 1; i < types.size(); i++) {
             if (types[i] != base_type) {
                 auto ref = base_type->peer(types[i], gctx);
+                // Scalars don't know about vectors, so a scalar followed by a vector has to be asked the other way around
+                if (ref.value == nullptr && dynamic_cast<VectorType *>(types[i])) {
+                    ref = types[i]->peer(base_type, gctx);
+                }
                 base_type = ref.value;
                 _keepInScope.push_back(std::move(ref));
             }
@@ -89,12 +95,32 @@ namespace cheese::curdle {
         TRIVIAL(ComptimeComplexType);
         TRIVIAL(Complex64Type);
 #undef TRIVIAL
+        if (auto as_vector = dynamic_cast<VectorType *>(type); as_vector) {
+            return trivial_arithmetic_type(as_vector->subtype);
+        }
         return false;
     }
 
     memory::garbage_collection::gcref<Type>
     binary_result_type(enums::SimpleOperation op, Type *a, Type *b, cheese::project::GlobalContext *gctx) {
         if (trivial_arithmetic_type(a) && trivial_arithmetic_type(b)) {
+            if (dynamic_cast<VectorType *>(a) || dynamic_cast<VectorType *>(b)) {
+                switch (op) {
+                    case enums::SimpleOperation::Multiplication:
+                    case enums::SimpleOperation::Division:
+                    case enums::SimpleOperation::Remainder:
+                    case enums::SimpleOperation::Addition:
+                    case enums::SimpleOperation::Subtraction:
+                        return peer_type({a, b}, gctx);
+                    default:
+                        // Lane wise comparisons would need boolean vectors, which don't exist yet
+                        throw CurdleError{
+                                "Invalid Runtime Operation: only +, -, *, / and % are supported between " +
+                                a->to_string() + " and " + b->to_string(),
+                                error::ErrorCode::InvalidRuntimeOperation
+                        };
+                }
+            }
             switch (op) {
                 case enums::SimpleOperation::Multiplication:
                 case enums::SimpleOperation::Division:
@@ -170,25 +196,31 @@ namespace cheese::curdle {
         NOT_IMPL_FOR(typeid(*type).name());
     }
 
-    gcref<Type> get_true_subtype(garbage_collector &gc, Type *type, std::size_t num_subindices) {
-        if (num_subindices == 0) return {gc, type};
+    gcref<Type> get_true_subtype(cheese::project::GlobalContext *gctx, Type *type, std::size_t num_subindices) {
+        if (num_subindices == 0) return {gctx->gc, type};
 #define WHEN_TY_IS(ty, name) if (auto name = dynamic_cast<ty*>(type); name)
         WHEN_TY_IS(PointerType, pPointerType) {
-            return get_true_subtype(gc, pPointerType->subtype, num_subindices - 1);
+            return get_true_subtype(gctx, pPointerType->subtype, num_subindices - 1);
         }
         WHEN_TY_IS(ArrayType, pArrayType) {
             if (num_subindices >= pArrayType->dimensions.size()) {
-                return get_true_subtype(gc, pArrayType->subtype, num_subindices - pArrayType->dimensions.size());
+                return get_true_subtype(gctx, pArrayType->subtype, num_subindices - pArrayType->dimensions.size());
             }
             if (num_subindices < pArrayType->dimensions.size()) {
                 auto num_ptrs = num_subindices - pArrayType->dimensions.size();
-                auto base_ptr = gc.gcnew<PointerType>(pArrayType->subtype, pArrayType->constant);
+                auto base_ptr = PointerType::get(gctx, pArrayType->subtype, pArrayType->constant);
                 for (int i = 1; i < num_ptrs; i++) {
-                    base_ptr = gc.gcnew<PointerType>(base_ptr, pArrayType->constant);
+                    base_ptr = PointerType::get(gctx, base_ptr, pArrayType->constant);
                 }
-                return base_ptr;
+                return {gctx->gc, base_ptr};
             }
         }
+        WHEN_TY_IS(SliceType, pSliceType) {
+            return get_true_subtype(gctx, pSliceType->subtype, num_subindices - 1);
+        }
+        WHEN_TY_IS(VectorType, pVectorType) {
+            return get_true_subtype(gctx, pVectorType->subtype, num_subindices - 1);
+        }
 #undef WHEN_TY_IS
         throw CurdleError{
                 "Cannot get subtype of: " + std::string(typeid(*type).name()),
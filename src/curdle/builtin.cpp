@@ -9,6 +9,16 @@
 #include "curdle/values/ComptimeFunctionSet.h"
 #include "curdle/values/ComptimeEnumLiteral.h"
 #include "curdle/types/FunctionPointerType.h"
+#include "curdle/values/ComptimeBool.h"
+#include "curdle/values/ComptimeInteger.h"
+#include "curdle/values/ComptimeVector.h"
+#include "curdle/types/VectorType.h"
+#include "curdle/types/IntegerType.h"
+#include "curdle/types/Float64Type.h"
+#include "curdle/types/Structure.h"
+#include "curdle/values/ComptimeObject.h"
+#include "curdle/values/ComptimeVoid.h"
+#include "curdle/types/VoidType.h"
 
 namespace cheese::curdle {
 
@@ -200,17 +210,410 @@ namespace cheese::curdle {
             }
         }
         auto fn = as_function->set->get(passedArguments);
-        auto fnPtr = globalContext->gc.gcnew<FunctionPointerType>();
-        fnPtr->return_type = fn->returnType;
+        std::vector<Type *> argument_types;
         for (const auto &arg: fn->arguments) {
             if (arg.is_type) {
-                fnPtr->argument_types.push_back(arg.type);
+                argument_types.push_back(arg.type);
             }
         }
-        return fnPtr;
+        return {globalContext->gc, FunctionPointerType::get(globalContext, fn->returnType, argument_types)};
     }
 
     BUILTIN2("fnPtr", fn_ptr_builtin, fn_ptr_type)
 
+    // Loop hints take either a boolean to turn a transformation on or off, or a positive integer to give the
+    // vectorization width or unroll count, they apply to the loop whose body they are placed directly in
+    static bacteria::BacteriaPtr
+    loop_hint(Coordinate location, LocalContext *localContext, std::vector<parser::Node *> arguments,
+              bacteria::nodes::LoopHint::Kind kind, const std::string &name) {
+        auto runtimeContext = localContext->runtime;
+        auto comptimeContext = runtimeContext->comptime;
+        if (arguments.size() != 1) {
+            throw LocalizedCurdleError(
+                    "Attempting to use $" + name + " w/ the wrong number of arguments, it only takes one argument",
+                    location, error::ErrorCode::BadBuiltinCall);
+        }
+        auto value = comptimeContext->exec(arguments[0], runtimeContext);
+        if (auto as_bool = dynamic_cast<ComptimeBool *>(value.get()); as_bool) {
+            return std::make_unique<bacteria::nodes::LoopHint>(location, kind, as_bool->value, 0);
+        }
+        if (auto as_integer = dynamic_cast<ComptimeInteger *>(value.get()); as_integer && as_integer->value > 0) {
+            return std::make_unique<bacteria::nodes::LoopHint>(location, kind, true,
+                                                               static_cast<std::uint64_t>(as_integer->value));
+        }
+        throw LocalizedCurdleError(
+                "Attempting to use $" + name + " w/ an argument that is neither a boolean nor a positive integer",
+                arguments[0]->location, error::ErrorCode::BadBuiltinCall);
+    }
+
+    bacteria::BacteriaPtr
+    vectorize_builtin(Coordinate location, LocalContext *localContext, std::vector<parser::Node *> arguments) {
+        return loop_hint(location, localContext, std::move(arguments), bacteria::nodes::LoopHint::Kind::Vectorize,
+                         "vectorize");
+    }
+
+    bacteria::BacteriaPtr
+    unroll_builtin(Coordinate location, LocalContext *localContext, std::vector<parser::Node *> arguments) {
+        return loop_hint(location, localContext, std::move(arguments), bacteria::nodes::LoopHint::Kind::Unroll,
+                         "unroll");
+    }
+
+    gcref<Type>
+    loop_hint_type(Coordinate location, LocalContext *localContext, std::vector<parser::Node *> arguments) {
+        auto globalContext = localContext->runtime->comptime->globalContext;
+        return {globalContext->gc, VoidType::get(globalContext)};
+    }
+
+    BUILTIN2("vectorize", vectorize_builtin, loop_hint_type)
+
+    BUILTIN2("unroll", unroll_builtin, loop_hint_type)
+
+    gcref<ComptimeValue>
+    vector_builtin(Coordinate location, std::vector<parser::Node *> arguments, ComptimeContext *cctx,
+                   RuntimeContext *rctx) {
+        auto gctx = cctx->globalContext;
+        if (arguments.size() != 2) {
+            throw LocalizedCurdleError(
+                    "Attempting to use $Vector w/ the wrong number of arguments, it takes a lane type and a lane count",
+                    location, error::ErrorCode::BadBuiltinCall);
+        }
+        auto lane = cctx->exec(arguments[0], rctx);
+        auto as_type = dynamic_cast<ComptimeType *>(lane.get());
+        // Only types that LLVM can put in a vector register are allowed as lanes
+        if (!as_type || !(dynamic_cast<IntegerType *>(as_type->typeValue) ||
+                          dynamic_cast<Float64Type *>(as_type->typeValue))) {
+            throw LocalizedCurdleError(
+                    "Attempting to use $Vector w/ a lane type that is not an integer or float type",
+                    arguments[0]->location, error::ErrorCode::BadBuiltinCall);
+        }
+        auto lanes = cctx->exec(arguments[1], rctx);
+        auto as_integer = dynamic_cast<ComptimeInteger *>(lanes.get());
+        if (!as_integer || as_integer->value <= 0) {
+            throw LocalizedCurdleError(
+                    "Attempting to use $Vector w/ a lane count that is not a positive integer",
+                    arguments[1]->location, error::ErrorCode::BadBuiltinCall);
+        }
+        auto vector = VectorType::get(gctx, as_type->typeValue, static_cast<std::uint64_t>(as_integer->value));
+        return create_from_type(gctx, vector);
+    }
+
+    BUILTIN("Vector", vector_builtin)
+
+    // The arguments are owned by the call being translated, so borrowing them for translation is safe
+    static parser::NodePtr borrow(parser::Node *node) {
+        return {parser::NodePtr{}, node};
+    }
+
+    static gcref<Type> expect_vector(ComptimeContext *cctx, RuntimeContext *rctx, parser::Node *argument,
+                                     const std::string &name) {
+        auto value = cctx->exec(argument, rctx);
+        if (auto as_type = dynamic_cast<ComptimeType *>(value.get());
+                as_type && dynamic_cast<VectorType *>(as_type->typeValue)) {
+            return {cctx->globalContext->gc, as_type->typeValue};
+        }
+        throw LocalizedCurdleError("Attempting to use $" + name + " w/ a first argument that is not a vector type",
+                                   argument->location, error::ErrorCode::BadBuiltinCall);
+    }
+
+    gcref<ComptimeValue>
+    splat_comptime(Coordinate location, std::vector<parser::Node *> arguments, ComptimeContext *cctx,
+                   RuntimeContext *rctx) {
+        if (arguments.size() != 2) {
+            throw LocalizedCurdleError(
+                    "Attempting to use $splat w/ the wrong number of arguments, it takes a vector type and a value",
+                    location, error::ErrorCode::BadBuiltinCall);
+        }
+        auto vector = expect_vector(cctx, rctx, arguments[0], "splat");
+        auto value = cctx->exec(arguments[1], rctx);
+        return ComptimeVector::splat(value.get(), dynamic_cast<VectorType *>(vector.get()), cctx->globalContext->gc);
+    }
+
+    bacteria::BacteriaPtr
+    splat_builtin(Coordinate location, LocalContext *localContext, std::vector<parser::Node *> arguments) {
+        auto runtimeContext = localContext->runtime;
+        if (arguments.size() != 2) {
+            throw LocalizedCurdleError(
+                    "Attempting to use $splat w/ the wrong number of arguments, it takes a vector type and a value",
+                    location, error::ErrorCode::BadBuiltinCall);
+        }
+        auto vector = expect_vector(runtimeContext->comptime, runtimeContext, arguments[0], "splat");
+        auto vector_context = runtimeContext->comptime->globalContext->gc.gcnew<LocalContext>(localContext,
+                                                                                            vector.get());
+        return make_cast(vector_context, borrow(arguments[1]));
+    }
+
+    gcref<Type>
+    splat_type(Coordinate location, LocalContext *localContext, std::vector<parser::Node *> arguments) {
+        auto runtimeContext = localContext->runtime;
+        if (arguments.size() != 2) {
+            throw LocalizedCurdleError(
+                    "Attempting to use $splat w/ the wrong number of arguments, it takes a vector type and a value",
+                    location, error::ErrorCode::BadBuiltinCall);
+        }
+        return expect_vector(runtimeContext->comptime, runtimeContext, arguments[0], "splat");
+    }
+
+    BUILTIN3("splat", splat_comptime, splat_builtin, splat_type)
+
+    // Gets the vector type both operands of $shuffle are converted to, alongside the lanes that are picked out of them,
+    // where lanes past the first vector's lane count are taken from the second vector
+    static gcref<Type>
+    shuffle_operands(Coordinate location, LocalContext *localContext, std::vector<parser::Node *> &arguments,
+                     std::vector<int> &mask) {
+        auto runtimeContext = localContext->runtime;
+        auto comptimeContext = runtimeContext->comptime;
+        auto globalContext = comptimeContext->globalContext;
+        if (arguments.size() < 3) {
+            throw LocalizedCurdleError(
+                    "Attempting to use $shuffle w/ the wrong number of arguments, it takes two vectors and at least one lane",
+                    location, error::ErrorCode::BadBuiltinCall);
+        }
+        auto empty_context = globalContext->gc.gcnew<LocalContext>(runtimeContext);
+        auto lhs_type = empty_context->get_type(arguments[0]);
+        auto rhs_type = empty_context->get_type(arguments[1]);
+        auto operand_type = peer_type({lhs_type.get(), rhs_type.get()}, globalContext);
+        auto as_vector = dynamic_cast<VectorType *>(operand_type.get());
+        if (!as_vector) {
+            throw LocalizedCurdleError(
+                    "Attempting to use $shuffle on values of type " + lhs_type->to_string() + " and " +
+                    rhs_type->to_string() + ", which are not vectors", location, error::ErrorCode::BadBuiltinCall);
+        }
+        for (size_t i = 2; i < arguments.size(); i++) {
+            auto lane = comptimeContext->exec(arguments[i], runtimeContext);
+            auto as_integer = dynamic_cast<ComptimeInteger *>(lane.get());
+            if (!as_integer || as_integer->value < 0 || as_integer->value >= 2 * as_vector->lanes) {
+                throw LocalizedCurdleError(
+                        "Attempting to use $shuffle w/ a lane that is not an integer in the range 0 ..< " +
+                        std::to_string(2 * as_vector->lanes), arguments[i]->location,
+                        error::ErrorCode::BadBuiltinCall);
+            }
+            mask.push_back(static_cast<int>(static_cast<std::int64_t>(as_integer->value)));
+        }
+        return operand_type;
+    }
+
+    bacteria::BacteriaPtr
+    shuffle_builtin(Coordinate location, LocalContext *localContext, std::vector<parser::Node *> arguments) {
+        auto globalContext = localContext->runtime->comptime->globalContext;
+        std::vector<int> mask;
+        auto operand_type = shuffle_operands(location, localContext, arguments, mask);
+        auto as_vector = dynamic_cast<VectorType *>(operand_type.get());
+        auto result_type = VectorType::get(globalContext, as_vector->subtype, mask.size());
+        auto operand_context = globalContext->gc.gcnew<LocalContext>(localContext, as_vector);
+        auto lhs = make_cast(operand_context, borrow(arguments[0]));
+        auto rhs = make_cast(operand_context, borrow(arguments[1]));
+        return std::make_unique<bacteria::nodes::VectorShuffle>(location, std::move(lhs), std::move(rhs),
+                                                                std::move(mask), result_type->get_cached_type(
+                        globalContext->global_receiver.get()));
+    }
+
+    gcref<Type>
+    shuffle_type(Coordinate location, LocalContext *localContext, std::vector<parser::Node *> arguments) {
+        auto globalContext = localContext->runtime->comptime->globalContext;
+        std::vector<int> mask;
+        auto operand_type = shuffle_operands(location, localContext, arguments, mask);
+        auto as_vector = dynamic_cast<VectorType *>(operand_type.get());
+        return {globalContext->gc, VectorType::get(globalContext, as_vector->subtype, mask.size())};
+    }
+
+    BUILTIN2("shuffle", shuffle_builtin, shuffle_type)
+
+    // Gets the operation of $reduce from an enum literal such as .Add, and the type of the vector being reduced
+    static gcref<Type>
+    reduce_operands(Coordinate location, LocalContext *localContext, std::vector<parser::Node *> &arguments,
+                    bacteria::nodes::VectorReduce::Operation &operation) {
+        using Operation = bacteria::nodes::VectorReduce::Operation;
+        auto runtimeContext = localContext->runtime;
+        auto comptimeContext = runtimeContext->comptime;
+        auto globalContext = comptimeContext->globalContext;
+        if (arguments.size() != 2) {
+            throw LocalizedCurdleError(
+                    "Attempting to use $reduce w/ the wrong number of arguments, it takes an operation and a vector",
+                    location, error::ErrorCode::BadBuiltinCall);
+        }
+        auto op = comptimeContext->exec(arguments[0], runtimeContext);
+        auto as_enum = dynamic_cast<ComptimeEnumLiteral *>(op.get());
+        static const std::map<std::string, Operation> operations = {
+                {"Add", Operation::Add},
+                {"Mul", Operation::Mul},
+                {"Min", Operation::Min},
+                {"Max", Operation::Max},
+                {"And", Operation::And},
+                {"Or",  Operation::Or},
+                {"Xor", Operation::Xor},
+        };
+        if (!as_enum || !operations.contains(as_enum->value)) {
+            throw LocalizedCurdleError(
+                    "Attempting to use $reduce w/ an operation that is not one of .Add, .Mul, .Min, .Max, .And, .Or, or .Xor",
+                    arguments[0]->location, error::ErrorCode::BadBuiltinCall);
+        }
+        operation = operations.at(as_enum->value);
+        auto empty_context = globalContext->gc.gcnew<LocalContext>(runtimeContext);
+        auto vector_type = empty_context->get_type(arguments[1]);
+        auto as_vector = dynamic_cast<VectorType *>(vector_type.get());
+        if (!as_vector) {
+            throw LocalizedCurdleError(
+                    "Attempting to use $reduce on a value of type " + vector_type->to_string() +
+                    ", which is not a vector", arguments[1]->location, error::ErrorCode::BadBuiltinCall);
+        }
+        if (dynamic_cast<Float64Type *>(as_vector->subtype) &&
+            (operation == Operation::And || operation == Operation::Or || operation == Operation::Xor)) {
+            throw LocalizedCurdleError(
+                    "Attempting to use $reduce w/ a bitwise operation on a vector of floats",
+                    arguments[0]->location, error::ErrorCode::BadBuiltinCall);
+        }
+        return vector_type;
+    }
+
+    bacteria::BacteriaPtr
+    reduce_builtin(Coordinate location, LocalContext *localContext, std::vector<parser::Node *> arguments) {
+        auto globalContext = localContext->runtime->comptime->globalContext;
+        bacteria::nodes::VectorReduce::Operation operation;
+        auto vector_type = reduce_operands(location, localContext, arguments, operation);
+        auto vector_context = globalContext->gc.gcnew<LocalContext>(localContext, vector_type.get());
+        return std::make_unique<bacteria::nodes::VectorReduce>(location, operation,
+                                                               make_cast(vector_context, borrow(arguments[1])),
+                                                               vector_type->get_cached_type(
+                                                                       globalContext->global_receiver.get()));
+    }
+
+    gcref<Type>
+    reduce_type(Coordinate location, LocalContext *localContext, std::vector<parser::Node *> arguments) {
+        bacteria::nodes::VectorReduce::Operation operation;
+        auto vector_type = reduce_operands(location, localContext, arguments, operation);
+        return {localContext->runtime->comptime->globalContext->gc,
+                dynamic_cast<VectorType *>(vector_type.get())->subtype};
+    }
+
+    BUILTIN2("reduce", reduce_builtin, reduce_type)
+
+    // The layout builtins only make sense inside a comptime block in the body of a structure
+    static Structure *layout_target(Coordinate location, const std::string &name, ComptimeContext *cctx) {
+        if (!cctx->currentStructure) {
+            throw LocalizedCurdleError("Attempting to use $" + name + " outside of a structure", location,
+                                       error::ErrorCode::BadBuiltinCall);
+        }
+        return cctx->currentStructure;
+    }
+
+    static gcref<ComptimeValue> layout_done(ComptimeContext *cctx) {
+        auto gctx = cctx->globalContext;
+        return gctx->gc.gcnew<ComptimeVoid>(VoidType::get(gctx));
+    }
+
+    gcref<ComptimeValue>
+    packed_builtin(Coordinate location, std::vector<parser::Node *> arguments, ComptimeContext *cctx,
+                   RuntimeContext *rctx) {
+        if (!arguments.empty()) {
+            throw LocalizedCurdleError("Attempting to use $packed w/ arguments, it takes none", location,
+                                       error::ErrorCode::BadBuiltinCall);
+        }
+        layout_target(location, "packed", cctx)->packed = true;
+        return layout_done(cctx);
+    }
+
+    BUILTIN("packed", packed_builtin)
+
+    gcref<ComptimeValue>
+    reorder_fields_builtin(Coordinate location, std::vector<parser::Node *> arguments, ComptimeContext *cctx,
+                           RuntimeContext *rctx) {
+        if (!arguments.empty()) {
+            throw LocalizedCurdleError("Attempting to use $reorderFields w/ arguments, it takes none", location,
+                                       error::ErrorCode::BadBuiltinCall);
+        }
+        layout_target(location, "reorderFields", cctx)->reorder_fields = true;
+        return layout_done(cctx);
+    }
+
+    BUILTIN("reorderFields", reorder_fields_builtin)
+
+    gcref<ComptimeValue>
+    align_builtin(Coordinate location, std::vector<parser::Node *> arguments, ComptimeContext *cctx,
+                  RuntimeContext *rctx) {
+        if (arguments.empty() || arguments.size() > 2) {
+            throw LocalizedCurdleError(
+                    "Attempting to use $align w/ the wrong number of arguments, it takes an alignment and optionally a field",
+                    location, error::ErrorCode::BadBuiltinCall);
+        }
+        auto structure = layout_target(location, "align", cctx);
+        auto alignment = cctx->exec(arguments[0], rctx);
+        auto as_integer = dynamic_cast<ComptimeInteger *>(alignment.get());
+        if (!as_integer || as_integer->value <= 0 || as_integer->value > 4096) {
+            throw LocalizedCurdleError("Attempting to use $align w/ an alignment that is not between 1 and 4096",
+                                       arguments[0]->location, error::ErrorCode::BadBuiltinCall);
+        }
+        auto value = static_cast<std::uint64_t>(as_integer->value);
+        if ((value & (value - 1)) != 0) {
+            throw LocalizedCurdleError("Attempting to use $align w/ an alignment that is not a power of 2",
+                                       arguments[0]->location, error::ErrorCode::BadBuiltinCall);
+        }
+        if (arguments.size() == 1) {
+            structure->alignment = value;
+            return layout_done(cctx);
+        }
+        // Fields are only known once the comptime blocks have run, so the name is checked when the structure is done
+        auto field = cctx->exec(arguments[1], rctx);
+        auto as_literal = dynamic_cast<ComptimeEnumLiteral *>(field.get());
+        if (!as_literal) {
+            throw LocalizedCurdleError("Attempting to use $align w/ a field that is not an enum literal",
+                                       arguments[1]->location, error::ErrorCode::BadBuiltinCall);
+        }
+        structure->field_alignments[as_literal->value] = value;
+        return layout_done(cctx);
+    }
+
+    BUILTIN("align", align_builtin)
+
+    gcref<ComptimeValue>
+    layout_builtin(Coordinate location, std::vector<parser::Node *> arguments, ComptimeContext *cctx,
+                   RuntimeContext *rctx) {
+        auto gctx = cctx->globalContext;
+        auto &gc = gctx->gc;
+        if (arguments.size() != 1) {
+            throw LocalizedCurdleError(
+                    "Attempting to use $layout w/ the wrong number of arguments, it only takes one argument", location,
+                    error::ErrorCode::BadBuiltinCall);
+        }
+        auto value = cctx->exec(arguments[0], rctx);
+        auto as_type = dynamic_cast<ComptimeType *>(value.get());
+        auto structure = as_type ? dynamic_cast<Structure *>(as_type->typeValue) : nullptr;
+        if (!structure || structure->get_comptimeness() == Comptimeness::Comptime) {
+            throw LocalizedCurdleError("Attempting to use $layout w/ an argument that is not a runtime structure type",
+                                       arguments[0]->location, error::ErrorCode::BadBuiltinCall);
+        }
+        auto bacteria_type = structure->get_cached_type(gctx->global_receiver.get());
+        auto &data_layout = gctx->machine.layout;
+        auto struct_layout = data_layout.getStructLayout(
+                llvm::cast<llvm::StructType>(bacteria_type->get_llvm_type(gctx)));
+        auto usize = IntegerType::get(gctx, false, gctx->machine.data_pointer_size * 8);
+
+        auto offsets_type = gc.gcnew<Structure>(gctx->verify_name("::offsets"), cctx, gc);
+        auto offsets = gc.gcnew<ComptimeObject>(offsets_type);
+        std::uint64_t used = 0;
+        for (std::size_t i = 0; i < structure->fields.size(); i++) {
+            auto &name = structure->fields[i].name;
+            auto offset = struct_layout->getElementOffset(bacteria_type->get_field_index(gctx, i));
+            offsets->fields[name] = gc.gcnew<ComptimeInteger>(math::BigInteger{offset}, usize);
+            offsets_type->fields.push_back(StructureField{name, usize, true});
+            used += data_layout.getTypeAllocSize(bacteria_type->child_types[i]->get_llvm_type(gctx));
+        }
+
+        auto size = static_cast<std::uint64_t>(struct_layout->getSizeInBytes());
+        auto layout_type = gc.gcnew<Structure>(gctx->verify_name("::layout"), cctx, gc);
+        auto layout = gc.gcnew<ComptimeObject>(layout_type);
+        layout->fields["size"] = gc.gcnew<ComptimeInteger>(math::BigInteger{size}, usize);
+        layout->fields["alignment"] = gc.gcnew<ComptimeInteger>(
+                math::BigInteger{static_cast<std::uint64_t>(bacteria_type->get_llvm_alignment(gctx).value())}, usize);
+        layout->fields["padding"] = gc.gcnew<ComptimeInteger>(math::BigInteger{size - used}, usize);
+        layout->fields["offsets"] = offsets;
+        layout_type->fields.push_back(StructureField{"size", usize, true});
+        layout_type->fields.push_back(StructureField{"alignment", usize, true});
+        layout_type->fields.push_back(StructureField{"padding", usize, true});
+        layout_type->fields.push_back(StructureField{"offsets", offsets_type.get(), true});
+        return layout;
+    }
+
+    BUILTIN("layout", layout_builtin)
+
     BadBuiltinCall::BadBuiltinCall(const std::string &message) : runtime_error(message) {}
 }
\ No newline at end of file
@@ -32,6 +32,7 @@
 #include "curdle/types/ComptimeEnumType.h"
 #include "curdle/types/ArrayType.h"
 #include "curdle/types/PointerType.h"
+#include "curdle/types/SliceType.h"
 #include "curdle/types/ComptimeStringType.h"
 
 
@@ -41,6 +42,10 @@ namespace cheese::curdle {
         mark_value();
     }
 
+    std::size_t ComptimeValue::hash() {
+        return 0;
+    }
+
 #define OPERATOR_NOT_DEFINED_FOR(operator_name) throw CurdleError("Invalid Comptime Operation: " operator_name " cannot be used on a value of type " + type->to_string() + " at compile time", error::ErrorCode::NotComptime)
 
     gcref<ComptimeValue>
@@ -268,10 +273,10 @@ namespace cheese::curdle {
                     for (std::ptrdiff_t i = pArrayType->dimensions.size() - 1; i >= 0; i--) {
                         if (auto as_unknown = dynamic_cast<parser::nodes::UnknownSize *>(pArrayType->dimensions[i].get()); as_unknown) {
                             if (!current_dimensions.empty()) {
-                                subtype = gc.gcnew<ArrayType>(subtype.get(), current_dimensions, constant);
+                                subtype = {gc, ArrayType::get(globalContext, subtype.get(), current_dimensions, constant)};
                                 current_dimensions = {};
                             }
-                            subtype = gc.gcnew<PointerType>(subtype.get(), constant);
+                            subtype = {gc, PointerType::get(globalContext, subtype.get(), constant)};
                         } else {
                             auto result = exec(pArrayType->dimensions[i], rtime);
                             if (auto as_integer = dynamic_cast<ComptimeInteger *>(result.get()); as_integer) {
@@ -294,7 +299,7 @@ namespace cheese::curdle {
                         }
                     }
                     if (!current_dimensions.empty()) {
-                        subtype = gc.gcnew<ArrayType>(subtype.get(), current_dimensions, constant);
+                        subtype = {gc, ArrayType::get(globalContext, subtype.get(), current_dimensions, constant)};
                     }
 
                     return create_from_type(globalContext, subtype.get());
@@ -306,6 +311,19 @@ namespace cheese::curdle {
                     };
                 }
             }
+            WHEN_NODE_IS(parser::nodes::Slice, pSlice) {
+                auto subtype_value = exec(pSlice->child.get(), rtime);
+                if (auto child_type = dynamic_cast<ComptimeType *>(subtype_value.get()); child_type) {
+                    return create_from_type(globalContext,
+                                            SliceType::get(globalContext, child_type->typeValue, pSlice->constant));
+                } else {
+                    throw LocalizedCurdleError{
+                            "Expected Type: Expected a value convertible to a type",
+                            pSlice->child->location,
+                            error::ErrorCode::ExpectedType
+                    };
+                }
+            }
             WHEN_NODE_IS(parser::nodes::ValueReference, pValueReference) {
                 // Do the same as below but throw errors on an invalid value reference
                 auto gotten = get(pValueReference->name);
@@ -490,6 +508,16 @@ namespace cheese::curdle {
                         } else {
                             return {gc, as_object->fields[field_name]};
                         }
+                    } else if (auto as_array = dynamic_cast<ComptimeArray *>(lhs.get()); as_array) {
+                        // Only the element asked for gets boxed, the rest of a packed tuple stays as it is
+                        auto index = static_cast<std::uint64_t>(pIntegerLiteral->value);
+                        if (index >= as_array->size()) {
+                            throw LocalizedCurdleError("Invalid Subscript: " + as_array->type->to_string() +
+                                                       " does not contain a field by the name of: " +
+                                                       static_cast<std::string>(pIntegerLiteral->value),
+                                                       pSubscription->location, error::ErrorCode::InvalidSubscript);
+                        }
+                        return as_array->get(gc, index);
                     } else {
                         NOT_IMPL_FOR("Non-objects");
                     }
@@ -534,24 +562,48 @@ namespace cheese::curdle {
             }
             WHEN_NODE_IS(parser::nodes::TupleLiteral, pTupleLiteral) {
                 // Here we should have an implied type specifier inside the structure object, as that makes conversion easier
-                auto vec = std::vector<gcref<ComptimeValue>>();
-                auto actual = std::vector<ComptimeValue *>();
                 auto ty = gc.gcnew<Structure>(globalContext->verify_name("::lit"), this, gc);
                 ty->is_tuple = true;
                 ty->implicit_type = true;
+                // Elements are packed as they are evaluated when they all have the same integer or float type
+                ComptimeArray::Builder builder{gc};
                 size_t i = 0;
                 for (auto &child: pTupleLiteral->children) {
                     auto value = exec(child, rtime);
-                    actual.push_back(value);
                     ty->fields.push_back(StructureField{
                             "_" + std::to_string(i),
                             value->type,
                             true
                     });
-                    vec.push_back(std::move(value));
+                    builder.push(std::move(value));
                     i++;
                 }
-                return gc.gcnew<ComptimeArray>(ty, std::move(actual));
+                return builder.finish(ty);
+            }
+            WHEN_NODE_IS(parser::nodes::ArrayLiteral, pArrayLiteral) {
+                // Until it gets cast to an array type, an array literal is a tuple of its elements, nested literals are
+                // flattened in row major order so that they fill out each dimension of the array
+                auto ty = gc.gcnew<Structure>(globalContext->verify_name("::lit"), this, gc);
+                ty->is_tuple = true;
+                ty->implicit_type = true;
+                ComptimeArray::Builder builder{gc};
+                std::function<void(parser::nodes::ArrayLiteral *)> flatten = [&](parser::nodes::ArrayLiteral *literal) {
+                    for (auto &child: literal->children) {
+                        if (auto as_literal = dynamic_cast<parser::nodes::ArrayLiteral *>(child.get()); as_literal) {
+                            flatten(as_literal);
+                            continue;
+                        }
+                        auto value = exec(child, rtime);
+                        ty->fields.push_back(StructureField{
+                                "_" + std::to_string(ty->fields.size()),
+                                value->type,
+                                true
+                        });
+                        builder.push(std::move(value));
+                    }
+                };
+                flatten(pArrayLiteral);
+                return builder.finish(ty);
             }
             // Ah fun, tuple calling at compile time this is going to be fun
             WHEN_NODE_IS(parser::nodes::TupleCall, pTupleCall) {
@@ -603,6 +655,10 @@ namespace cheese::curdle {
                 throw CurdleError("Not Compile Time: can't do a while loop at compile time",
                                   error::ErrorCode::NotComptime);
             }
+            WHEN_NODE_IS(parser::nodes::For, pFor) {
+                throw CurdleError("Not Compile Time: can't do a for loop at compile time",
+                                  error::ErrorCode::NotComptime);
+            }
             WHEN_NODE_IS(parser::nodes::VariableDefinition, pVariableDefinition) {
                 throw CurdleError("Not Compile Time: can't do a variable definition at compile time",
                                   error::ErrorCode::NotComptime);
@@ -618,6 +674,54 @@ namespace cheese::curdle {
         }
     }
 
+    std::optional<gcref<ComptimeValue>>
+    ComptimeContext::try_exec_literal(parser::Node *node, RuntimeContext *rtime, Type *target_type) {
+        std::vector<parser::Node *> elements;
+        auto as_array = dynamic_cast<ArrayType *>(target_type);
+        auto as_tuple = dynamic_cast<Structure *>(target_type);
+        if (auto as_tuple_literal = dynamic_cast<parser::nodes::TupleLiteral *>(node); as_tuple_literal) {
+            for (auto &child: as_tuple_literal->children) elements.push_back(child.get());
+        } else if (auto as_array_literal = dynamic_cast<parser::nodes::ArrayLiteral *>(node); as_array_literal) {
+            // Only an array type has dimensions for nested literals to fill out
+            std::function<void(parser::nodes::ArrayLiteral *)> flatten = [&](parser::nodes::ArrayLiteral *literal) {
+                for (auto &child: literal->children) {
+                    auto nested = dynamic_cast<parser::nodes::ArrayLiteral *>(child.get());
+                    if (nested && as_array) {
+                        flatten(nested);
+                    } else {
+                        elements.push_back(child.get());
+                    }
+                }
+            };
+            flatten(as_array_literal);
+        } else {
+            return {};
+        }
+        std::size_t count = 1;
+        if (as_array) {
+            for (auto dimension: as_array->dimensions) count *= dimension;
+        } else if (as_tuple && as_tuple->is_tuple) {
+            count = as_tuple->fields.size();
+        } else {
+            return {};
+        }
+        // Anything that doesn't line up is left to the usual path, which reports it properly
+        if (elements.size() != count) return {};
+        try {
+            auto &gc = globalContext->gc;
+            ComptimeArray::Builder builder{gc};
+            for (std::size_t i = 0; i < elements.size(); i++) {
+                auto element_type = as_array ? as_array->subtype : as_tuple->fields[i].type;
+                builder.push(exec(elements[i], rtime)->cast(element_type, gc));
+            }
+            return builder.finish(target_type);
+        } catch (const CurdleError &e) {
+            return {};
+        } catch (const LocalizedCurdleError &e) {
+            return {};
+        }
+    }
+
     std::optional<gcref<ComptimeValue>> ComptimeContext::try_exec(parser::Node *node, RuntimeContext *rtime) {
         try {
             return exec(node, rtime);
@@ -628,18 +732,18 @@ namespace cheese::curdle {
         }
     }
 
-    std::optional<gcref<ComptimeValue>> ComptimeContext::get(const std::string &name) {
-        if (comptimeVariables.contains(name)) {
-            return gcref<ComptimeValue>(globalContext->gc, comptimeVariables[name]->value);
+    std::optional<gcref<ComptimeValue>> ComptimeContext::get(Symbol name) {
+        if (auto it = comptimeVariables.find(name); it != comptimeVariables.end()) {
+            return gcref<ComptimeValue>(globalContext->gc, it->second->value);
         }
         if (currentStructure) {
             currentStructure->resolve_by_name(name);
-            if (currentStructure->comptime_variables.contains(name)) {
-                return gcref<ComptimeValue>(globalContext->gc, currentStructure->comptime_variables[name].value);
+            if (auto it = currentStructure->comptime_variables.find(name); it != currentStructure->comptime_variables.end()) {
+                return gcref<ComptimeValue>(globalContext->gc, it->second.value);
             }
-            if (currentStructure->function_sets.contains(name)) {
+            if (auto it = currentStructure->function_sets.find(name); it != currentStructure->function_sets.end()) {
                 // At some point we have to combine function sets...
-                auto function_set = currentStructure->function_sets[name];
+                auto function_set = it->second;
                 auto new_function_set = new ComptimeFunctionSet(function_set,
                                                                 globalContext);
                 return gcref<ComptimeValue>(globalContext->gc, new_function_set);
@@ -2,6 +2,8 @@
 // Created by Lexi Allen on 3/20/2023.
 //
 #include <utility>
+#include <unordered_set>
+#include <algorithm>
 
 #include "curdle/curdle.h"
 
@@ -31,6 +33,8 @@
 #include "curdle/types/VoidType.h"
 #include "curdle/types/NoReturnType.h"
 #include "curdle/values/ComptimeArray.h"
+#include "curdle/values/ComptimeVector.h"
+#include "curdle/types/VectorType.h"
 #include "curdle/values/ComptimeObject.h"
 #include "curdle/types/Float64Type.h"
 #include "curdle/values/ComptimeComplex.h"
@@ -43,6 +47,8 @@
 #include "curdle/types/PointerType.h"
 #include "curdle/values/ComptimeVoid.h"
 #include "curdle/types/ArrayType.h"
+#include "curdle/types/SliceType.h"
+#include "curdle/types/ComptimeIntegerType.h"
 
 using namespace cheese::memory::garbage_collection;
 
@@ -124,17 +130,17 @@ namespace cheese::curdle {
                     fields.push_back(as_field);
                 } else if (auto as_decl = dynamic_cast<parser::nodes::VariableDeclaration *>(ptr); as_decl) {
                     auto def = dynamic_cast<parser::nodes::VariableDefinition *>(as_decl->def.get());
-                    structure_ref->lazies.push_back(new LazyValue{def->name, child});
+                    structure_ref->add_lazy(def->name, child);
                 } else if (auto as_def = dynamic_cast<parser::nodes::VariableDefinition *>(ptr); as_def) {
-                    structure_ref->lazies.push_back(new LazyValue{as_def->name, child});
+                    structure_ref->add_lazy(as_def->name, child);
                 } else if (auto as_import = dynamic_cast<parser::nodes::Import *>(ptr); as_import) {
-                    structure_ref->lazies.push_back(new LazyValue{as_import->name, child});
+                    structure_ref->add_lazy(as_import->name, child);
                 } else if (auto as_op = dynamic_cast<parser::nodes::Operator *>(ptr); as_op) {
                     auto temp = gc.gcnew<FunctionTemplate>(localCtx, child);
                     if (!structure_ref->function_sets.contains(as_op->op)) {
                         structure_ref->function_sets[as_op->op] = gc.gcnew<FunctionSet>();
                     }
-                    structure_ref->function_sets[as_op->op]->templates.push_back(temp.get());
+                    structure_ref->function_sets[as_op->op]->add_template(temp.get());
                 } else if (auto as_fn = dynamic_cast<parser::nodes::Function *>(ptr); as_fn) {
                     auto temp = gc.gcnew<FunctionTemplate>(localCtx, child);
                     auto tptr = temp.get();
@@ -142,15 +148,15 @@ namespace cheese::curdle {
                     if (!structure_ref->function_sets.contains(as_fn->name)) {
                         structure_ref->function_sets[as_fn->name] = gc.gcnew<FunctionSet>();
                     }
-                    structure_ref->function_sets[as_fn->name]->templates.push_back(tptr);
+                    structure_ref->function_sets[as_fn->name]->add_template(tptr);
                 } else if (auto as_gen = dynamic_cast<parser::nodes::Generator *>(ptr); as_gen) {
                     auto temp = gc.gcnew<FunctionTemplate>(localCtx, child);
                     if (!structure_ref->function_sets.contains(as_gen->name)) {
                         structure_ref->function_sets[as_gen->name] = gc.gcnew<FunctionSet>();
                     }
-                    structure_ref->function_sets[as_gen->name]->templates.push_back(temp.get());
+                    structure_ref->function_sets[as_gen->name]->add_template(temp.get());
                 } else if (auto as_fn_import = dynamic_cast<parser::nodes::FunctionImport *>(ptr); as_fn_import) {
-                    structure_ref->lazies.push_back(new LazyValue{as_fn_import->name, child});
+                    structure_ref->add_lazy(as_fn_import->name, child);
                 }
             }
 
@@ -175,6 +181,15 @@ namespace cheese::curdle {
                 }
             }
 
+            // Alignments given to fields by $align can only be checked now that the fields are known
+            for (auto &[field_name, field_alignment]: structure_ref->field_alignments) {
+                if (std::none_of(structure_ref->fields.begin(), structure_ref->fields.end(),
+                                 [&](const StructureField &field) { return field.name == field_name; })) {
+                    global->raise("Attempting to align a field named " + field_name + " which does not exist",
+                                  structure_node->location, error::ErrorCode::BadBuiltinCall);
+                }
+            }
+
             // Resolve mixins
             for (auto mixin: mixins) {
                 resolve_mixin(localCtx, mixin);
@@ -220,6 +235,26 @@ namespace cheese::curdle {
                     location,
                     std::move(castee), from));
         }
+        // The array decays to a pointer to its first item, and its length comes straight from its type
+        if (auto as_slice = dynamic_cast<SliceType *>(lctx->expected_type); as_slice) {
+            if (auto as_array = dynamic_cast<ArrayType *>(from); as_array) {
+                auto gctx = lctx->runtime->comptime->globalContext;
+                auto receiver = gctx->global_receiver.get();
+                auto usize = IntegerType::get(gctx, false, gctx->machine.data_pointer_size * 8);
+                return std::make_unique<bacteria::nodes::SliceNode>(location, std::move(castee),
+                                                                    std::make_unique<bacteria::nodes::IntegerLiteral>(
+                                                                            location,
+                                                                            math::BigInteger{as_array->dimensions[0]},
+                                                                            usize->get_cached_type(receiver)),
+                                                                    as_slice->get_cached_type(receiver));
+            }
+        }
+        // Scalars are first converted to the lane type, and then broadcast to every lane
+        if (auto as_vector = dynamic_cast<VectorType *>(lctx->expected_type);
+                as_vector && !dynamic_cast<VectorType *>(from)) {
+            castee = make_cast(lctx->runtime->comptime->globalContext->gc.gcnew<LocalContext>(lctx, as_vector->subtype),
+                               location, std::move(castee), from);
+        }
         return std::make_unique<bacteria::nodes::CastNode>(location, std::move(castee),
                                                            lctx->expected_type->get_cached_type(
                                                                    lctx->runtime->comptime->globalContext->global_receiver.get()));
@@ -386,6 +421,50 @@ namespace cheese::curdle {
         NOT_IMPL_FOR("non compile time deductible functions of type " + typeid(*fn_ty.get()).name());
     }
 
+    // Whether an index into a dimension of the given size can never be out of bounds, either by being known at compile
+    // time, or by being a loop counter that stays within the dimension, known out of bounds indices are an error here
+    static bool index_in_bounds(RuntimeContext *rctx, parser::Node *index, std::uint64_t size) {
+        if (auto execed = rctx->comptime->try_exec(index, rctx); execed.has_value()) {
+            auto as_integer = dynamic_cast<ComptimeInteger *>(execed.value().get());
+            if (!as_integer) return false;
+            if (as_integer->value < 0 || as_integer->value >= size) {
+                throw LocalizedCurdleError{
+                        "Invalid Index: " + static_cast<std::string>(as_integer->value) +
+                        " is out of bounds for a dimension of size " + std::to_string(size),
+                        index->location,
+                        error::ErrorCode::InvalidIndex
+                };
+            }
+            return true;
+        }
+        if (auto reference = dynamic_cast<parser::nodes::ValueReference *>(index); reference) {
+            if (auto info = rctx->get(reference->name); info.has_value() && info->range.has_value()) {
+                return info->range->first >= 0 && info->range->second < size;
+            }
+        }
+        return false;
+    }
+
+    static RuntimeContext *get_declaring_context(RuntimeContext *rctx, const std::string &name) {
+        for (auto current = rctx; current != nullptr; current = current->parent) {
+            if (current->variables.contains(name)) return current;
+        }
+        return nullptr;
+    }
+
+    // Slices only have a length at runtime, so the only indices known to be in bounds are the counters of loops over
+    // that very same slice
+    static bool index_in_slice_bounds(RuntimeContext *rctx, parser::Node *index, bacteria::BacteriaNode *slice) {
+        auto reference = dynamic_cast<parser::nodes::ValueReference *>(index);
+        auto slice_reference = dynamic_cast<bacteria::nodes::ValueReference *>(slice);
+        if (!reference || !slice_reference) return false;
+        auto info = rctx->get(reference->name);
+        if (!info.has_value() || !info->index_of.has_value()) return false;
+        auto &[declaring_context, slice_name] = info->index_of.value();
+        return slice_name == slice_reference->name &&
+               get_declaring_context(rctx, slice_reference->name) == declaring_context;
+    }
+
     bacteria::BacteriaPtr
     translate_array_index(LocalContext *lctx, bacteria::BacteriaPtr indexed_object, Type *indexed_type,
                           parser::NodeList &all_indices, size_t start_index) {
@@ -402,28 +481,49 @@ namespace cheese::curdle {
             args.push_back(make_cast(index_lctx, all_indices[start_index]));
             return translate_array_index(lctx, std::make_unique<bacteria::nodes::ArrayIndexNode>(
                                                  all_indices[start_index]->location, std::move(indexed_object), std::move(args)),
-                                         get_true_subtype(gc, indexed_type, (all_indices.size() - start_index) - 1),
+                                         get_true_subtype(gctx, indexed_type, (all_indices.size() - start_index) - 1),
                                          all_indices, start_index + 1);
         }
         WHEN_TY_IS(ArrayType, pArrayType) {
             bacteria::BacteriaList args;
+            bool checked = false;
             if ((all_indices.size() - start_index) >= pArrayType->dimensions.size()) {
                 for (int i = 0; i < pArrayType->dimensions.size(); i++) {
                     args.push_back(make_cast(index_lctx, all_indices[start_index + i]));
+                    checked |= !index_in_bounds(rctx, all_indices[start_index + i].get(), pArrayType->dimensions[i]);
                 }
                 return translate_array_index(lctx, std::make_unique<bacteria::nodes::ArrayIndexNode>(
-                                                     all_indices[start_index]->location, std::move(indexed_object), std::move(args)),
-                                             get_true_subtype(gc, indexed_type, (all_indices.size() - start_index) -
+                                                     all_indices[start_index]->location, std::move(indexed_object), std::move(args),
+                                                     checked),
+                                             get_true_subtype(gctx, indexed_type, (all_indices.size() - start_index) -
                                                                                 pArrayType->dimensions.size()),
                                              all_indices, start_index + pArrayType->dimensions.size());
             } else {
                 for (int i = start_index; i < all_indices.size(); i++) {
                     args.push_back(make_cast(index_lctx, all_indices[i]));
+                    checked |= !index_in_bounds(rctx, all_indices[i].get(), pArrayType->dimensions[i - start_index]);
                 }
                 return std::make_unique<bacteria::nodes::ArrayIndexNode>(all_indices[start_index]->location,
-                                                                         std::move(indexed_object), std::move(args));
+                                                                         std::move(indexed_object), std::move(args),
+                                                                         checked);
             }
         }
+        WHEN_TY_IS(SliceType, pSliceType) {
+            bacteria::BacteriaList args;
+            args.push_back(make_cast(index_lctx, all_indices[start_index]));
+            bool checked = !index_in_slice_bounds(rctx, all_indices[start_index].get(), indexed_object.get());
+            return translate_array_index(lctx, std::make_unique<bacteria::nodes::ArrayIndexNode>(
+                                                 all_indices[start_index]->location, std::move(indexed_object), std::move(args),
+                                                 checked),
+                                         pSliceType->subtype, all_indices, start_index + 1);
+        }
+        WHEN_TY_IS(VectorType, pVectorType) {
+            bacteria::BacteriaList args;
+            args.push_back(make_cast(index_lctx, all_indices[start_index]));
+            return translate_array_index(lctx, std::make_unique<bacteria::nodes::ArrayIndexNode>(
+                                                 all_indices[start_index]->location, std::move(indexed_object), std::move(args)),
+                                         pVectorType->subtype, all_indices, start_index + 1);
+        }
 #undef WHEN_TY_IS
         throw CurdleError{
                 "Cannot index: " + std::string(typeid(*indexed_type).name()),
@@ -447,6 +547,12 @@ namespace cheese::curdle {
         WHEN_ARR_IS(ArrayType, pArrayType) {
             return translate_array_index(lctx, translate_expression(lctx, call->object), arr_ty, call->args, 0);
         }
+        WHEN_ARR_IS(VectorType, pVectorType) {
+            return translate_array_index(lctx, translate_expression(lctx, call->object), arr_ty, call->args, 0);
+        }
+        WHEN_ARR_IS(SliceType, pSliceType) {
+            return translate_array_index(lctx, translate_expression(lctx, call->object), arr_ty, call->args, 0);
+        }
 #undef WHEN_ARR_IS
 
         NOT_IMPL_FOR("non compile time deductible functions of type " + typeid(*arr_ty.get()).name());
@@ -693,6 +799,79 @@ namespace cheese::curdle {
         NOT_IMPL_FOR(typeid(*match).name());
     }
 
+    // Translates a match into a switch if every arm matches against compile time integer constants
+    // Returns nothing when that isn't the case, so that the match can fall back to a chain of ifs
+    // Only integer subjects (sized or pointer sized) are handled, enums have no runtime representation yet, so any match
+    // on one is fully evaluated at compile time and never gets here
+    bacteria::BacteriaPtr
+    try_translate_switch(LocalContext *lctx, LocalContext *peer_ctx, Type *value_type, parser::nodes::Match *pMatch) {
+        auto rctx = lctx->runtime;
+        auto cctx = rctx->comptime;
+        auto gctx = cctx->globalContext;
+        auto &gc = gctx->gc;
+        if (value_type->get_comptimeness() == Comptimeness::Comptime) return {};
+        auto switched_type = value_type->get_cached_type(gctx->global_receiver.get());
+        switch (switched_type->type) {
+            case bacteria::BacteriaType::Type::UnsignedInteger:
+            case bacteria::BacteriaType::Type::UnsignedSize:
+            case bacteria::BacteriaType::Type::SignedInteger:
+            case bacteria::BacteriaType::Type::SignedSize:
+                break;
+            default:
+                return {};
+        }
+        auto value_ctx = gc.gcnew<LocalContext>(rctx, value_type);
+        std::vector<std::vector<bacteria::BacteriaPtr>> arm_values;
+        for (std::size_t i = 0; i < pMatch->arms.size(); i++) {
+            auto arm = (parser::nodes::MatchArm *) pMatch->arms[i].get();
+            if (single_catch_all(arm)) {
+                // A misplaced catchall gets reported by the if chain
+                if (i != pMatch->arms.size() - 1) return {};
+                continue;
+            }
+            std::vector<bacteria::BacteriaPtr> values;
+            for (auto &match: arm->matches) {
+                auto pMatchValue = dynamic_cast<parser::nodes::MatchValue *>(match.get());
+                if (!pMatchValue) return {};
+                auto comptime_value = cctx->try_exec(pMatchValue->value.get(), rctx);
+                if (!comptime_value.has_value()) return {};
+                auto literal = translate_comptime(value_ctx, match->location, comptime_value.value().get());
+                if (!dynamic_cast<bacteria::nodes::IntegerLiteral *>(literal.get())) return {};
+                values.push_back(std::move(literal));
+            }
+            arm_values.push_back(std::move(values));
+        }
+        auto result = std::make_unique<bacteria::nodes::Switch>(pMatch->location,
+                                                                translate_expression(value_ctx, pMatch->value),
+                                                                switched_type);
+        // Only the first arm to match a value can ever run, so later duplicates are dropped, as a switch needs its
+        // case values to be unique
+        std::unordered_set<std::string> seen;
+        auto next_values = arm_values.begin();
+        for (auto &arm_ptr: pMatch->arms) {
+            auto arm = (parser::nodes::MatchArm *) arm_ptr.get();
+            if (single_catch_all(arm)) {
+                result->default_case = make_cast(peer_ctx, arm->body->location,
+                                                 translate_expression(peer_ctx, arm->body),
+                                                 peer_ctx->get_type(arm->body.get()));
+                continue;
+            }
+            std::vector<bacteria::BacteriaPtr> values;
+            for (auto &value: *next_values++) {
+                auto literal = dynamic_cast<bacteria::nodes::IntegerLiteral *>(value.get());
+                if (seen.insert(static_cast<std::string>(literal->value)).second) {
+                    values.push_back(std::move(value));
+                }
+            }
+            // An arm left with no values of its own can never run, so its body isn't translated at all
+            if (values.empty()) continue;
+            result->cases.push_back(
+                    std::make_unique<bacteria::nodes::SwitchCase>(arm->location, std::move(values),
+                                                                  make_cast(peer_ctx, arm->body)));
+        }
+        return result;
+    }
+
     bacteria::BacteriaPtr translate_match_statement(LocalContext *lctx, parser::nodes::Match *pMatch) {
         bool trivial = trivial_read_node(pMatch->value.get());
         auto rctx = lctx->runtime;
@@ -711,6 +890,9 @@ namespace cheese::curdle {
         if (!trivial) {
             NOT_IMPL_FOR("Non trivial copy match statements");
         }
+        if (auto as_switch = try_translate_switch(lctx, peer_ctx, value_type, pMatch); as_switch) {
+            return as_switch;
+        }
         // We have to start from the top going to the bottom which is going to be pain
         bacteria::nodes::If *parent = nullptr;
         bacteria::BacteriaPtr top_level_if;
@@ -833,12 +1015,32 @@ namespace cheese::curdle {
                                                                            lctx->runtime->comptime->globalContext->global_receiver.get()));
         }
         WHEN_COMPTIME_IS(ComptimeArray, pComptimeArray) {
-            if (auto as_structure = dynamic_cast<Structure *>(pComptimeArray->type); as_structure) {
-                auto t = as_structure->get_cached_type(lctx->runtime->comptime->globalContext->global_receiver.get());
+            auto as_structure = dynamic_cast<Structure *>(pComptimeArray->type);
+            auto as_array = dynamic_cast<ArrayType *>(pComptimeArray->type);
+            // Arrays lower to a flat list of their elements in row major order, which ends up as a constant in .rodata
+            if (as_structure || as_array) {
+                auto receiver = lctx->runtime->comptime->globalContext->global_receiver.get();
+                auto t = pComptimeArray->type->get_cached_type(receiver);
                 std::vector<bacteria::BacteriaPtr> values;
+                // Packed elements go straight to literals rather than getting boxed first
+                if (pComptimeArray->is_packed()) {
+                    auto element_type = pComptimeArray->element_type->get_cached_type(receiver);
+                    auto is_integer = dynamic_cast<IntegerType *>(pComptimeArray->element_type) != nullptr;
+                    for (std::size_t i = 0; i < pComptimeArray->size(); i++) {
+                        if (is_integer) {
+                            values.push_back(std::make_unique<bacteria::nodes::IntegerLiteral>(
+                                    location, pComptimeArray->integer_at(i), element_type));
+                        } else {
+                            values.push_back(std::make_unique<bacteria::nodes::FloatLiteral>(
+                                    location, pComptimeArray->float_at(i), element_type));
+                        }
+                    }
+                    return std::make_unique<bacteria::nodes::AggregrateObject>(location, t, std::move(values));
+                }
                 for (int i = 0; i < pComptimeArray->values.size(); i++) {
                     auto field = pComptimeArray->values[i];
-                    auto lower_context = gc.gcnew<LocalContext>(lctx, as_structure->fields[i].type);
+                    auto lower_context = gc.gcnew<LocalContext>(lctx, as_array ? as_array->subtype
+                                                                               : as_structure->fields[i].type);
                     values.push_back(translate_comptime(lower_context, location, field));
                 }
                 return std::make_unique<bacteria::nodes::AggregrateObject>(location, t, std::move(values));
@@ -855,6 +1057,16 @@ namespace cheese::curdle {
                 return std::make_unique<bacteria::nodes::AggregrateObject>(location, t, std::move(values));
             }
         }
+        WHEN_COMPTIME_IS(ComptimeVector, pComptimeVector) {
+            auto as_vector = dynamic_cast<VectorType *>(pComptimeVector->type);
+            auto t = as_vector->get_cached_type(lctx->runtime->comptime->globalContext->global_receiver.get());
+            auto lane_context = gc.gcnew<LocalContext>(lctx, as_vector->subtype);
+            std::vector<bacteria::BacteriaPtr> values;
+            for (auto lane: pComptimeVector->values) {
+                values.push_back(translate_comptime(lane_context, location, lane));
+            }
+            return std::make_unique<bacteria::nodes::AggregrateObject>(location, t, std::move(values));
+        }
         WHEN_COMPTIME_IS(ComptimeComplex, pComptimeComplex) {
             return std::make_unique<bacteria::nodes::ComplexLiteral>(location, pComptimeComplex->a, pComptimeComplex->b,
                                                                      result_type->get_cached_type(
@@ -886,7 +1098,6 @@ namespace cheese::curdle {
         auto rctx = lctx->runtime;
         auto cctx = rctx->comptime;
         auto gctx = cctx->globalContext;
-        auto &gc = gctx->gc;
         auto subscript_type = rctx->get_type(subscription->lhs.get());
         auto subscript_ptr = subscript_type.get();
         bool reference = false;
@@ -962,6 +1173,29 @@ namespace cheese::curdle {
 
             }
         }
+        WHEN_SUBSCRIPT_IS(SliceType, pSliceType) {
+            WHEN_KEY_IS(parser::nodes::ValueReference, pValueReference) {
+                if (pValueReference->name == "len") {
+                    return std::make_unique<bacteria::nodes::SliceLengthNode>(subscription->location,
+                                                                              translate_expression(lctx,
+                                                                                                   subscription->lhs));
+                }
+                if (pValueReference->name == "ptr") {
+                    return std::make_unique<bacteria::nodes::SlicePointerNode>(subscription->location,
+                                                                               translate_expression(lctx,
+                                                                                                    subscription->lhs));
+                }
+                throw LocalizedCurdleError{
+                        pValueReference->name + " is not a field of " + pSliceType->to_string(),
+                        pValueReference->location,
+                        error::ErrorCode::InvalidSubscript
+                };
+            }
+            throw LocalizedCurdleError{
+                    "Attempting to use a subscript of type " + std::string(typeid(*subscription->rhs.get()).name()) +
+                    " for a slice", subscription->rhs->location, error::ErrorCode::InvalidSubscript
+            };
+        }
         WHEN_SUBSCRIPT_IS(ComposedFunctionType, pComposedFunctionType) {
             WHEN_KEY_IS(parser::nodes::IntegerLiteral, pIntegerLiteral) {
                 if (pIntegerLiteral->value < 0) {
@@ -1020,6 +1254,168 @@ namespace cheese::curdle {
 
     void translate_statement(RuntimeContext *rctx, parser::NodePtr stmnt);
 
+    // Ranges, arrays and slices all become counted loops, the capture is either the induction variable itself, or the
+    // element that gets read at the start of every iteration
+    bacteria::BacteriaPtr translate_for_loop(LocalContext *lctx, parser::nodes::For *pFor) {
+        auto rctx = lctx->runtime;
+        auto cctx = rctx->comptime;
+        auto gctx = cctx->globalContext;
+        auto &gc = gctx->gc;
+        auto receiver = gctx->global_receiver.get();
+        auto capture = dynamic_cast<parser::nodes::CopyCapture *>(pFor->capture.get());
+        if (!capture) {
+            NOT_IMPL_FOR("for loops with reference captures");
+        }
+        if (!pFor->transformations.empty()) {
+            NOT_IMPL_FOR("for loop transformations");
+        }
+        std::optional<std::string> index_name;
+        if (pFor->index.has_value()) {
+            if (auto index = dynamic_cast<parser::nodes::ValueReference *>(pFor->index.value().get());
+                    index && index->name != "_") {
+                index_name = index->name;
+            }
+        }
+        auto usize = IntegerType::get(gctx, false, gctx->machine.data_pointer_size * 8);
+        // Anything that must only be evaluated once goes in here, so it is scoped to the loop
+        auto outer_block = new bacteria::nodes::UnnamedBlock(pFor->location);
+        auto outer = outer_block->get();
+        auto body_rctx = gc.gcnew<RuntimeContext>(rctx, cctx, rctx->structure);
+        auto body_block = new bacteria::nodes::UnnamedBlock(pFor->body->location);
+        auto body = body_block->get();
+        body_rctx->local_reciever = body_block;
+        body_rctx->functionReturnType = rctx->functionReturnType;
+        std::unique_ptr<bacteria::nodes::CountedLoop> loop;
+        if (auto range = dynamic_cast<parser::nodes::Range *>(pFor->iterable.get()); range) {
+            auto bounds = lctx->get_binary_type(range->lhs.get(), range->rhs.get());
+            gcref<Type> induction_type = peer_type({bounds.first, bounds.second}, gctx);
+            if (dynamic_cast<ComptimeIntegerType *>(induction_type.get())) {
+                // A range between two literals has nothing to take its type from, so it counts in the index type
+                induction_type = gcref<Type>{gc, usize};
+            } else if (!dynamic_cast<IntegerType *>(induction_type.get())) {
+                throw LocalizedCurdleError{
+                        "Invalid For Loop: can't loop over a range of " + induction_type->to_string(),
+                        range->location,
+                        error::ErrorCode::InvalidForLoop
+                };
+            }
+            auto bound_ctx = gc.gcnew<LocalContext>(lctx, induction_type);
+            auto cached_type = induction_type->get_cached_type(receiver);
+            // When both ends are known, so is every value the counter takes, which lets indexing with it skip checks
+            std::optional<std::pair<math::BigInteger, math::BigInteger>> known_range;
+            auto known_begin = cctx->try_exec(range->lhs.get(), rctx);
+            auto known_end = cctx->try_exec(range->rhs.get(), rctx);
+            if (known_begin.has_value() && known_end.has_value()) {
+                auto begin_integer = dynamic_cast<ComptimeInteger *>(known_begin.value().get());
+                auto end_integer = dynamic_cast<ComptimeInteger *>(known_end.value().get());
+                if (begin_integer && end_integer) {
+                    known_range = std::make_pair(begin_integer->value, end_integer->value);
+                }
+            }
+            auto begin = make_cast(bound_ctx, range->lhs);
+            if (index_name.has_value()) {
+                // The index counts up from 0, so the start of the range has to be kept around to subtract
+                outer_block->receive(std::make_unique<bacteria::nodes::VariableInitializationNode>(
+                        range->lhs->location, ".for-begin", cached_type, std::move(begin), true));
+                begin = std::make_unique<bacteria::nodes::ValueReference>(range->lhs->location, ".for-begin");
+                body_block->receive(std::make_unique<bacteria::nodes::VariableInitializationNode>(
+                        pFor->location, index_name.value(), cached_type, std::make_unique<bacteria::nodes::SubtractNode>(
+                                pFor->location,
+                                std::make_unique<bacteria::nodes::ValueReference>(pFor->location, capture->name),
+                                std::make_unique<bacteria::nodes::ValueReference>(pFor->location, ".for-begin")),
+                        true));
+                body_rctx->variables[index_name.value()] = RuntimeVariableInfo{true, index_name.value(),
+                                                                               induction_type};
+                if (known_range.has_value()) {
+                    body_rctx->variables[index_name.value()].range = std::make_pair(
+                            math::BigInteger{0}, known_range->second - known_range->first);
+                }
+            }
+            body_rctx->variables[capture->name] = RuntimeVariableInfo{true, capture->name, induction_type, known_range};
+            // Ranges are inclusive of both ends, the same as range constraints in a match
+            loop = std::make_unique<bacteria::nodes::CountedLoop>(pFor->location, capture->name, cached_type,
+                                                                  std::move(begin), make_cast(bound_ctx, range->rhs),
+                                                                  true, std::move(body));
+        } else {
+            auto iterable_type = rctx->get_type(pFor->iterable.get());
+            auto array_type = dynamic_cast<ArrayType *>(iterable_type.get());
+            auto slice_type = dynamic_cast<SliceType *>(iterable_type.get());
+            if (!array_type && !slice_type) {
+                throw LocalizedCurdleError{
+                        "Invalid For Loop: can't loop over a value of type " + iterable_type->to_string(),
+                        pFor->iterable->location,
+                        error::ErrorCode::InvalidForLoop
+                };
+            }
+            if (array_type && array_type->dimensions.size() != 1) {
+                NOT_IMPL_FOR("for loops over multidimensional arrays");
+            }
+            auto element_type = array_type ? array_type->subtype : slice_type->subtype;
+            std::string array_name = array_type ? ".for-array" : ".for-slice";
+            std::optional<std::pair<RuntimeContext *, std::string>> index_of;
+            auto reference = dynamic_cast<parser::nodes::ValueReference *>(pFor->iterable.get());
+            auto runtime = reference ? rctx->get(reference->name) : std::nullopt;
+            // The length of a slice is only read once, so a slice that could be reassigned in the body is copied
+            if (runtime.has_value() && (array_type || runtime.value().constant)) {
+                array_name = runtime.value().runtime_name;
+                if (auto declaring_context = get_declaring_context(rctx, reference->name); slice_type &&
+                                                                                          declaring_context) {
+                    index_of = std::make_pair(declaring_context, array_name);
+                }
+            } else {
+                outer_block->receive(std::make_unique<bacteria::nodes::VariableInitializationNode>(
+                        pFor->iterable->location, array_name, iterable_type->get_cached_type(receiver),
+                        translate_expression(gc.gcnew<LocalContext>(lctx, iterable_type), pFor->iterable), true));
+            }
+            auto induction = index_name.value_or(".for-index");
+            bacteria::BacteriaList indices;
+            indices.push_back(std::make_unique<bacteria::nodes::ValueReference>(pFor->location, induction));
+            // The counter never leaves the bounds of what it is counting over, so reading the element is never checked
+            body_block->receive(std::make_unique<bacteria::nodes::VariableInitializationNode>(
+                    pFor->location, capture->name, element_type->get_cached_type(receiver),
+                    std::make_unique<bacteria::nodes::ArrayIndexNode>(pFor->location,
+                                                                      std::make_unique<bacteria::nodes::ValueReference>(
+                                                                              pFor->iterable->location, array_name),
+                                                                      std::move(indices), false), true));
+            if (index_name.has_value()) {
+                auto &index_info = body_rctx->variables[index_name.value()] = RuntimeVariableInfo{
+                        true, index_name.value(), usize};
+                if (array_type) {
+                    index_info.range = std::make_pair(math::BigInteger{0},
+                                                      math::BigInteger{array_type->dimensions[0] - 1});
+                } else {
+                    index_info.index_of = index_of;
+                }
+            }
+            body_rctx->variables[capture->name] = RuntimeVariableInfo{true, capture->name, element_type};
+            auto cached_usize = usize->get_cached_type(receiver);
+            bacteria::BacteriaPtr end;
+            if (array_type) {
+                end = std::make_unique<bacteria::nodes::IntegerLiteral>(pFor->location,
+                                                                        math::BigInteger{array_type->dimensions[0]},
+                                                                        cached_usize);
+            } else {
+                end = std::make_unique<bacteria::nodes::SliceLengthNode>(
+                        pFor->location,
+                        std::make_unique<bacteria::nodes::ValueReference>(pFor->iterable->location, array_name));
+            }
+            loop = std::make_unique<bacteria::nodes::CountedLoop>(
+                    pFor->location, induction, cached_usize,
+                    std::make_unique<bacteria::nodes::IntegerLiteral>(pFor->location, math::BigInteger{0},
+                                                                      cached_usize),
+                    std::move(end),                     false, std::move(body));
+        }
+        translate_statement(body_rctx, pFor->body);
+        if (pFor->els.has_value()) {
+            loop->els = translate_expression(gc.gcnew<LocalContext>(rctx), pFor->els.value());
+        }
+        if (outer_block->children.empty()) {
+            return loop;
+        }
+        outer_block->receive(std::move(loop));
+        return outer;
+    }
+
     bacteria::BacteriaPtr translate_expression(LocalContext *lctx, parser::NodePtr expr) {
         auto rctx = lctx->runtime;
         auto cctx = rctx->comptime;
@@ -1027,6 +1423,11 @@ namespace cheese::curdle {
         auto &gc = gctx->gc;
         auto true_expr = expr.get();
         try {
+            if (lctx->expected_type) {
+                if (auto literal = cctx->try_exec_literal(expr.get(), rctx, lctx->expected_type); literal.has_value()) {
+                    return translate_comptime(lctx, expr->location, literal.value().get());
+                }
+            }
             auto execed = cctx->try_exec(expr.get(), rctx);
             if (execed.has_value()) {
                 return translate_comptime(lctx, expr->location, execed.value().get());
@@ -1330,6 +1731,9 @@ namespace cheese::curdle {
                                                                     translate_expression(empty_ctx, pWhile->body));
                 }
             }
+            WHEN_EXPR_IS(parser::nodes::For, pFor) {
+                return translate_for_loop(lctx, pFor);
+            }
             WHEN_EXPR_IS(parser::nodes::Assignment, pAssignment) {
                 // TODO: Semantic analysis and the like to make sure we aren't emitting a mutation for a constant value, but thats not necessary just yet
                 auto lhs_ty = rctx->get_type(pAssignment->lhs.get());
@@ -1507,9 +1911,13 @@ namespace cheese::curdle {
                         } else {
                             auto ty = cctx->exec(definition->type.value(), rctx);
                             if (auto as_type = dynamic_cast<ComptimeType *>(ty.get()); as_type) {
+                                auto value = cctx->try_exec_literal(pVariableDeclaration->value.get(), rctx,
+                                                                    as_type->typeValue);
                                 cctx->comptimeVariables[definition->name] = gc.gcnew<ComptimeVariable>(
                                         as_type->typeValue,
-                                        cctx->exec(pVariableDeclaration->value, rctx)->cast(as_type->typeValue, gc));
+                                        value.has_value() ? std::move(value.value())
+                                                          : cctx->exec(pVariableDeclaration->value, rctx)->cast(
+                                                                  as_type->typeValue, gc));
                             } else {
                                 gctx->raise("Expected a type: found " + ty->type->to_string(),
                                             definition->type.value()->location, error::ErrorCode::ExpectedType);
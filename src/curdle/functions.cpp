@@ -75,7 +75,7 @@ namespace cheese::curdle {
             auto a2 = args_list->at(i).get();
             if (auto as_self = dynamic_cast<parser::nodes::Self *>(a2); as_self) {
                 auto ref = ctx->currentStructure;
-                auto ref_type = gc.gcnew<ReferenceType>(static_cast<Type *>(ref), false);
+                auto ref_type = gcref<Type>{gc, ReferenceType::get(ctx->globalContext, ref, false)};
                 if (ref_type->get_comptimeness() == Comptimeness::Comptime || force_comptime) {
                     if (arguments[i].is_type) return no_match;
                     fctx->comptimeVariables["self"] = gc.gcnew<ComptimeVariable>(ref, arguments[i].value);
@@ -100,7 +100,7 @@ namespace cheese::curdle {
                 args.push_back(std::move(arg));
             } else if (auto as_const_self = dynamic_cast<parser::nodes::ConstSelf *>(a2); as_const_self) {
                 auto ref = ctx->currentStructure;
-                auto ref_type = gc.gcnew<ReferenceType>(static_cast<Type *>(ref), true);
+                auto ref_type = gcref<Type>{gc, ReferenceType::get(ctx->globalContext, ref, true)};
                 if (ref_type->get_comptimeness() == Comptimeness::Comptime || force_comptime) {
                     if (arguments[i].is_type) return no_match;
                     fctx->comptimeVariables["self"] = gc.gcnew<ComptimeVariable>(ref, arguments[i].value);
@@ -268,6 +268,7 @@ namespace cheese::curdle {
         bool force_comptime;
         bool external;
         bool entry;
+        bool is_inline{false};
         bool generator{false};
         std::string name;
         auto true_ptr = ptr.get();
@@ -275,6 +276,7 @@ namespace cheese::curdle {
             force_comptime = as_fn->flags.comptime;
             external = as_fn->flags.exter || as_fn->flags.entry;
             entry = as_fn->flags.entry;
+            is_inline = as_fn->flags.inlin;
             name = as_fn->name;
             body_ptr = as_fn->body;
         } else if (auto as_gen = dynamic_cast<parser::nodes::Generator *>(true_ptr); as_gen) {
@@ -286,6 +288,7 @@ namespace cheese::curdle {
         } else if (auto as_op = dynamic_cast<parser::nodes::Operator *>(true_ptr); as_op) {
             force_comptime = as_op->flags.comptime;
             external = false;
+            is_inline = as_op->flags.inlin;
             name = "operator" + as_op->op;
             body_ptr = as_op->body;
         }
@@ -311,7 +314,7 @@ namespace cheese::curdle {
         auto new_function = gc.gcnew<ConcreteFunction>(name, true_arguments, ret_type, comptime_only, external, entry);
         concrete_functions.push_back(new_function);
         new_function->generate_code(fctx, rctx,
-                                    external, std::move(body_ptr), generator, rtime_names);
+                                    external, is_inline, std::move(body_ptr), generator, rtime_names);
 
         return new_function;
     }
@@ -332,6 +335,7 @@ namespace cheese::curdle {
             bool force_comptime;
             bool external;
             bool entry;
+            bool is_inline{false};
             bool generator{false};
             std::string name;
             auto true_ptr = ptr.get();
@@ -339,6 +343,7 @@ namespace cheese::curdle {
                 force_comptime = as_fn->flags.comptime;
                 external = as_fn->flags.exter || as_fn->flags.entry;
                 entry = as_fn->flags.entry;
+                is_inline = as_fn->flags.inlin;
                 name = as_fn->name;
                 body_ptr = as_fn->body;
                 args_list = as_fn->arguments;
@@ -355,6 +360,7 @@ namespace cheese::curdle {
             } else if (auto as_op = dynamic_cast<parser::nodes::Operator *>(true_ptr); as_op) {
                 force_comptime = as_op->flags.comptime;
                 external = false;
+                is_inline = as_op->flags.inlin;
                 name = "operator" + as_op->op;
                 body_ptr = as_op->body;
                 args_list = as_fn->arguments;
@@ -402,7 +408,7 @@ namespace cheese::curdle {
                                                            entry);
             concrete_functions.push_back(new_function);
             new_function->generate_code(fctx, rctx,
-                                        external, std::move(body_ptr), generator, rtime_names);
+                                        external, is_inline, std::move(body_ptr), generator, rtime_names);
             return new_function;
         } else if (concrete_functions.size() == 1) {
             return concrete_functions[0];
@@ -418,6 +424,52 @@ namespace cheese::curdle {
         for (auto &temp: templates) {
             temp->mark();
         }
+        for (auto &bucket: resolved_calls) {
+            for (auto &call: bucket.second) {
+                for (auto &argument: call.arguments) {
+                    argument.type->mark();
+                    if (!argument.is_type) {
+                        argument.value->mark();
+                    }
+                }
+                call.function->mark();
+            }
+        }
+    }
+
+    void FunctionSet::add_template(FunctionTemplate *function_template) {
+        templates.push_back(function_template);
+        resolved_calls.clear();
+    }
+
+    static std::size_t hash_arguments(const std::vector<PassedFunctionArgument> &arguments) {
+        std::size_t hash = arguments.size();
+        auto combine = [&hash](std::size_t value) {
+            hash ^= value + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+        };
+        // Types are interned, so the pointer is enough to tell them apart
+        std::hash<Type *> type_hash;
+        for (auto &argument: arguments) {
+            combine(argument.is_type);
+            combine(type_hash(argument.type));
+            if (!argument.is_type) {
+                combine(argument.value->hash());
+            }
+        }
+        return hash;
+    }
+
+    static bool same_arguments(const std::vector<PassedFunctionArgument> &a,
+                               const std::vector<PassedFunctionArgument> &b) {
+        if (a.size() != b.size()) return false;
+        for (std::size_t i = 0; i < a.size(); i++) {
+            if (a[i].is_type != b[i].is_type) return false;
+            // compare() == 0 also holds for distinct types that merely convert for free, which would pick the wrong
+            // instantiation, so this has to be the exact same type
+            if (a[i].type != b[i].type) return false;
+            if (!a[i].is_type && !a[i].value->is_same_as(b[i].value)) return false;
+        }
+        return true;
     }
 
     std::string get_arg_name_list(const std::vector<PassedFunctionArgument> &arguments) {
@@ -439,6 +491,12 @@ namespace cheese::curdle {
     }
 
     ConcreteFunction *FunctionSet::get(const std::vector<PassedFunctionArgument> &arguments) {
+        auto key = hash_arguments(arguments);
+        if (auto it = resolved_calls.find(key); it != resolved_calls.end()) {
+            for (auto &call: it->second) {
+                if (same_arguments(call.arguments, arguments)) return call.function;
+            }
+        }
         int closest_closeness = std::numeric_limits<int>::max();
         FunctionTemplate *closest_function = nullptr;
         for (auto templ: templates) {
@@ -453,7 +511,10 @@ namespace cheese::curdle {
                     error::ErrorCode::NoOverloadFound
             };
         }
-        return closest_function->get(arguments);
+        auto function = closest_function->get(arguments);
+        // Resolving can recurse back into this set, so only index into the table now
+        resolved_calls[key].push_back(ResolvedCall{arguments, function});
+        return function;
     }
 
     ConcreteFunction *FunctionSet::get() {
@@ -509,7 +570,7 @@ namespace cheese::curdle {
         }
     }
 
-    void ConcreteFunction::generate_code(ComptimeContext *cctx, RuntimeContext *rctx, bool external,
+    void ConcreteFunction::generate_code(ComptimeContext *cctx, RuntimeContext *rctx, bool external, bool is_inline,
                                          parser::NodePtr body_ptr, bool is_generator,
                                          const std::vector<std::string> &rtime_names) {
 
@@ -532,7 +593,8 @@ namespace cheese::curdle {
                 }
                 auto node = (new bacteria::nodes::Function{body_ptr->location, mangled_name, bacteria_args,
                                                            returnType->get_cached_type(
-                                                                   cctx->globalContext->global_receiver.get())})->get();
+                                                                   cctx->globalContext->global_receiver.get()),
+                                                           external, is_inline})->get();
                 rctx->local_reciever = dynamic_cast<bacteria::BacteriaReceiver *>(node.get());
                 cctx->globalContext->global_receiver->receive(std::move(node));
             }
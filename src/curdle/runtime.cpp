@@ -25,6 +25,8 @@
 #include "curdle/types/ImportedFunctionType.h"
 #include "curdle/types/PointerType.h"
 #include "curdle/types/ArrayType.h"
+#include "curdle/types/SliceType.h"
+#include "curdle/types/VectorType.h"
 
 
 namespace cheese::curdle {
@@ -38,10 +40,10 @@ namespace cheese::curdle {
 
     }
 
-    std::optional<RuntimeVariableInfo> RuntimeContext::get(const std::string &name) {
+    std::optional<RuntimeVariableInfo> RuntimeContext::get(Symbol name) {
         // This thing is only runtime, comptime is done in the stage before;
-        if (variables.contains(name)) {
-            return variables[name];
+        if (auto it = variables.find(name); it != variables.end()) {
+            return it->second;
         }
         if (parent) {
             auto v = parent->get(name);
@@ -50,8 +52,8 @@ namespace cheese::curdle {
             }
         }
         if (structure) {
-            if (structure->top_level_variables.contains(name)) {
-                auto &v = structure->top_level_variables[name];
+            if (auto it = structure->top_level_variables.find(name); it != structure->top_level_variables.end()) {
+                auto &v = it->second;
                 return RuntimeVariableInfo{v.constant, v.mangled_name, v.type};
             }
         }
@@ -148,14 +150,19 @@ namespace cheese::curdle {
         auto rctx = lctx->runtime;
         auto cctx = rctx->comptime;
         auto gctx = cctx->globalContext;
-        auto &gc = gctx->gc;
         auto arr_ty = lctx->get_type(call->object.get());
 #define WHEN_ARR_IS(ty, name) if (auto name = dynamic_cast<ty*>(arr_ty.get()); name)
         WHEN_ARR_IS(PointerType, pPointerType) {
-            return get_true_subtype(gc, pPointerType, call->args.size());
+            return get_true_subtype(gctx, pPointerType, call->args.size());
         }
         WHEN_ARR_IS(ArrayType, pArrayType) {
-            return get_true_subtype(gc, pArrayType, call->args.size());
+            return get_true_subtype(gctx, pArrayType, call->args.size());
+        }
+        WHEN_ARR_IS(VectorType, pVectorType) {
+            return get_true_subtype(gctx, pVectorType, call->args.size());
+        }
+        WHEN_ARR_IS(SliceType, pSliceType) {
+            return get_true_subtype(gctx, pSliceType, call->args.size());
         }
 #undef WHEN_ARR_IS
         NOT_IMPL_FOR("non compile time deductible arrays of type " + typeid(*arr_ty.get()).name());
@@ -214,16 +221,17 @@ namespace cheese::curdle {
 //        }
 //    }
 
-    std::pair<gcref<Type>, std::string> get_capture_type(garbage_collector &gc, Type *t, parser::Node *capture) {
+    std::pair<gcref<Type>, std::string> get_capture_type(GlobalContext *gctx, Type *t, parser::Node *capture) {
+        auto &gc = gctx->gc;
 #define WHEN_CAPTURE_IS(type, name) if (auto name = dynamic_cast<type*>(capture); name)
         WHEN_CAPTURE_IS(parser::nodes::CopyCapture, pCopyCapture) {
             return {{gc, t}, pCopyCapture->name};
         }
         WHEN_CAPTURE_IS(parser::nodes::RefCapture, pRefCapture) {
-            return {gc.gcnew<ReferenceType>(t, false), pRefCapture->name};
+            return {gcref<Type>{gc, ReferenceType::get(gctx, t, false)}, pRefCapture->name};
         }
         WHEN_CAPTURE_IS(parser::nodes::ConstRefCapture, pConstRefCapture) {
-            return {gc.gcnew<ReferenceType>(t, true), pConstRefCapture->name};
+            return {gcref<Type>{gc, ReferenceType::get(gctx, t, true)}, pConstRefCapture->name};
         }
 #undef WHEN_CAPTURE_IS
         NOT_IMPL_FOR(typeid(*capture).name());
@@ -249,7 +257,7 @@ namespace cheese::curdle {
         auto new_rctx = gc.gcnew<RuntimeContext>(lctx->runtime, lctx->runtime->comptime, lctx->runtime->structure);
         auto &arm_matches = arm->matches;
         if (arm->store) {
-            auto info = get_capture_type(gc, value_type, arm->store.value().get());
+            auto info = get_capture_type(lctx->runtime->comptime->globalContext, value_type, arm->store.value().get());
             new_rctx->variables[info.second] = RuntimeVariableInfo{true, info.second, info.first.get()};
         }
         for (auto &match: arm_matches) {
@@ -352,6 +360,25 @@ namespace cheese::curdle {
                     " for a structure", subscription->rhs->location, error::ErrorCode::InvalidSubscript
             };
         }
+        WHEN_SUBSCRIPT_IS(SliceType, pSliceType) {
+            WHEN_KEY_IS(parser::nodes::ValueReference, pValueReference) {
+                if (pValueReference->name == "len") {
+                    return {gc, IntegerType::get(gctx, false, gctx->machine.data_pointer_size * 8)};
+                }
+                if (pValueReference->name == "ptr") {
+                    return {gc, PointerType::get(gctx, pSliceType->subtype, pSliceType->constant)};
+                }
+                throw LocalizedCurdleError{
+                        pValueReference->name + " is not a field of " + pSliceType->to_string(),
+                        pValueReference->location,
+                        error::ErrorCode::InvalidSubscript
+                };
+            }
+            throw LocalizedCurdleError{
+                    "Attempting to use a subscript of type " + std::string(typeid(*subscription->rhs.get()).name()) +
+                    " for a slice", subscription->rhs->location, error::ErrorCode::InvalidSubscript
+            };
+        }
         WHEN_SUBSCRIPT_IS(ComposedFunctionType, pComposedFunctionType) {
             WHEN_KEY_IS(parser::nodes::IntegerLiteral, pIntegerLiteral) {
                 if (pIntegerLiteral->value < 0) {
@@ -382,6 +409,9 @@ namespace cheese::curdle {
         auto gctx = runtime->comptime->globalContext;
         auto &gc = gctx->gc;
         try {
+            if (expected_type && runtime->comptime->try_exec_literal(node, runtime, expected_type).has_value()) {
+                return {gc, expected_type};
+            }
             auto execed = runtime->comptime->try_exec(node, runtime);
             if (execed.has_value()) {
                 auto etype = execed.value()->type;
@@ -576,7 +606,8 @@ namespace cheese::curdle {
                 // Now we have to do a "get l-value type" function
                 auto lvalue_type = runtime->get_lvalue_type(pAddressOf->child.get());
                 // We have to ma
-                return gc.gcnew<ReferenceType>(lvalue_type.first, lvalue_type.second);
+                return {gc, ReferenceType::get(runtime->comptime->globalContext, lvalue_type.first,
+                                               lvalue_type.second)};
             }
             WHEN_NODE_IS(parser::nodes::Block, pBlock) {
                 return {gc, VoidType::get(gctx)};
@@ -594,6 +625,9 @@ namespace cheese::curdle {
                 //TODO: while loop body analysis
                 return {gc, VoidType::get(gctx)};
             }
+            WHEN_NODE_IS(parser::nodes::For, pFor) {
+                return {gc, VoidType::get(gctx)};
+            }
             NOT_IMPL_FOR(typeid(*node).name());
 #undef WHEN_NODE_IS
         } catch (const CurdleError &e) {
@@ -18,12 +18,7 @@ namespace cheese::curdle {
 
 
     AnyType *AnyType::get(cheese::project::GlobalContext *gctx) {
-        if (!gctx->cached_objects.contains("type: any")) {
-            auto ref = gctx->gc.gcnew<AnyType>();
-            gctx->cached_objects["type: any"] = ref;
-            return ref;
-        }
-        return dynamic_cast<AnyType *>(gctx->cached_objects["type: any"]);
+        return gctx->get_singleton<AnyType>();
     }
 
     Comptimeness AnyType::get_comptimeness() {
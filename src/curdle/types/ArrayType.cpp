@@ -40,6 +40,15 @@ namespace cheese::curdle {
 
     }
 
+    ArrayType *ArrayType::get(GlobalContext *gctx, Type *subtype, const std::vector<std::size_t> &dimensions,
+                              bool constant) {
+        auto key = std::make_tuple(subtype, dimensions, constant);
+        if (auto it = gctx->array_types.find(key); it != gctx->array_types.end()) return it->second;
+        auto ref = gctx->gc.gcnew<ArrayType>(subtype, dimensions, constant);
+        gctx->array_types[key] = ref;
+        return ref;
+    }
+
     Comptimeness ArrayType::get_comptimeness() {
         return subtype->get_comptimeness();
     }
@@ -57,6 +66,17 @@ namespace cheese::curdle {
                 return 1;
             }
         }
+        // A tuple literal with one value per element, in row major order
+        if (auto as_structure = dynamic_cast<Structure *>(other); as_structure && as_structure->is_tuple &&
+                                                                   as_structure->implicit_type) {
+            std::size_t count = 1;
+            for (auto dimension: dimensions) count *= dimension;
+            if (as_structure->fields.size() != count) return -1;
+            for (auto &field: as_structure->fields) {
+                if (subtype->compare(field.type) == -1) return -1;
+            }
+            return 1;
+        }
         return -1;
     }
 
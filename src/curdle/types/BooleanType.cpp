@@ -20,12 +20,7 @@ namespace cheese::curdle {
     }
 
     BooleanType *BooleanType::get(cheese::project::GlobalContext *gctx) {
-        if (!gctx->cached_objects.contains("type: boolean")) {
-            auto ref = gctx->gc.gcnew<BooleanType>();
-            gctx->cached_objects["type: boolean"] = ref;
-            return ref;
-        }
-        return dynamic_cast<BooleanType *>(gctx->cached_objects["type: boolean"]);
+        return gctx->get_singleton<BooleanType>();
     }
 
     Comptimeness BooleanType::get_comptimeness() {
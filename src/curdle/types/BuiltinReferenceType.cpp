@@ -20,12 +20,7 @@ namespace cheese::curdle {
     }
 
     BuiltinReferenceType *BuiltinReferenceType::get(cheese::project::GlobalContext *gctx) {
-        if (!gctx->cached_objects.contains("type: builtin_reference")) {
-            auto ref = gctx->gc.gcnew<BuiltinReferenceType>();
-            gctx->cached_objects["type: builtin_reference"] = ref;
-            return ref;
-        }
-        return dynamic_cast<BuiltinReferenceType *>(gctx->cached_objects["type: builtin_reference"]);
+        return gctx->get_singleton<BuiltinReferenceType>();
     }
 
 
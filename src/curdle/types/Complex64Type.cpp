@@ -29,12 +29,7 @@ namespace cheese::curdle {
     }
 
     Complex64Type *Complex64Type::get(cheese::project::GlobalContext *gctx) {
-        if (!gctx->cached_objects.contains("type: c64")) {
-            auto ref = gctx->gc.gcnew<Complex64Type>();
-            gctx->cached_objects["type: c64"] = ref;
-            return ref;
-        }
-        return dynamic_cast<Complex64Type *>(gctx->cached_objects["type: c64"]);
+        return gctx->get_singleton<Complex64Type>();
     }
 
     Comptimeness Complex64Type::get_comptimeness() {
@@ -64,13 +64,13 @@ namespace cheese::curdle {
     ComposedFunctionType *
     ComposedFunctionType::get(GlobalContext *gctx, enums::SimpleOperation operation,
                               const std::vector<Type *> &operand_types) {
-        auto cached_name = "type: " + get_name(operation, operand_types);
-        if (!gctx->cached_objects.contains(cached_name)) {
-            auto ref = gctx->gc.gcnew<ComposedFunctionType>(operation, operand_types);
-            gctx->cached_objects[cached_name] = ref;
-            return ref;
+        auto key = std::make_pair(operation, operand_types);
+        if (auto it = gctx->composed_function_types.find(key); it != gctx->composed_function_types.end()) {
+            return it->second;
         }
-        return dynamic_cast<ComposedFunctionType *>(gctx->cached_objects[cached_name]);
+        auto ref = gctx->gc.gcnew<ComposedFunctionType>(operation, operand_types);
+        gctx->composed_function_types[key] = ref;
+        return ref;
     }
 
     bacteria::TypePtr ComposedFunctionType::get_bacteria_type(bacteria::nodes::BacteriaProgram *program) {
@@ -148,7 +148,7 @@ namespace cheese::curdle {
         auto gctx = cctx->globalContext;
         auto rctx = gctx->gc.gcnew<RuntimeContext>(cctx, cctx->currentStructure);
         auto arg_types = get_argument_types(gctx);
-        auto ref = gctx->gc.gcnew<ReferenceType>(this, true);
+        auto ref = ReferenceType::get(gctx, this, true);
         // Let's now set up the arguments
         rctx->functionReturnType = get_return_type(gctx);
         rctx->variables["state"] = RuntimeVariableInfo{
@@ -157,7 +157,7 @@ namespace cheese::curdle {
                 ref
         };
         // This will be treated as a tuple
-        auto state_value_reference = (new parser::nodes::ValueReference(Coordinate{0, 0, 0}, "state"))->get();
+        auto state_value_reference = (new parser::nodes::ValueReference(Coordinate{}, "state"))->get();
         parser::NodeList argument_references;
         for (int i = 0; i < arg_types.size(); i++) {
             rctx->variables["_" + std::to_string(i)] = RuntimeVariableInfo{
@@ -166,87 +166,87 @@ namespace cheese::curdle {
                     arg_types[i]
             };
             argument_references.push_back(
-                    (new parser::nodes::ValueReference(Coordinate{0, 0, 0}, "_" + std::to_string(i)))->get());
+                    (new parser::nodes::ValueReference(Coordinate{}, "_" + std::to_string(i)))->get());
         }
         auto lctx = gctx->gc.gcnew<LocalContext>(rctx);
         parser::NodePtr full_operation;
-        auto first = (new parser::nodes::Subscription(Coordinate{0, 0, 0}, state_value_reference,
-                                                      (new parser::nodes::IntegerLiteral({0, 0, 0}, 0))->get()))->get();
+        auto first = (new parser::nodes::Subscription(Coordinate{}, state_value_reference,
+                                                      (new parser::nodes::IntegerLiteral(Coordinate{}, 0))->get()))->get();
         if (is_functional_type(operand_types[0])) {
-            first = (new parser::nodes::TupleCall({0, 0, 0}, first, argument_references))->get();
+            first = (new parser::nodes::TupleCall(Coordinate{}, first, argument_references))->get();
         }
         parser::NodePtr second;
         if (enums::is_binary_op(operation)) {
-            second = (new parser::nodes::Subscription(Coordinate{0, 0, 0}, state_value_reference,
-                                                      (new parser::nodes::IntegerLiteral({0, 0, 0},
+            second = (new parser::nodes::Subscription(Coordinate{}, state_value_reference,
+                                                      (new parser::nodes::IntegerLiteral(Coordinate{},
                                                                                          1))->get()))->get();
             if (is_functional_type(operand_types[1])) {
-                second = (new parser::nodes::TupleCall({0, 0, 0}, second, argument_references))->get();
+                second = (new parser::nodes::TupleCall(Coordinate{}, second, argument_references))->get();
             }
         }
         switch (operation) {
             case enums::SimpleOperation::UnaryPlus:
-                full_operation = (new parser::nodes::UnaryPlus({0, 0, 0}, first))->get();
+                full_operation = (new parser::nodes::UnaryPlus(Coordinate{}, first))->get();
                 break;
             case enums::SimpleOperation::UnaryMinus:
-                full_operation = (new parser::nodes::UnaryMinus({0, 0, 0}, first))->get();
+                full_operation = (new parser::nodes::UnaryMinus(Coordinate{}, first))->get();
                 break;
             case enums::SimpleOperation::Not:
-                full_operation = (new parser::nodes::Not({0, 0, 0}, first))->get();
+                full_operation = (new parser::nodes::Not(Coordinate{}, first))->get();
                 break;
             case enums::SimpleOperation::Multiplication:
-                full_operation = (new parser::nodes::Multiplication({0, 0, 0}, first, second))->get();
+                full_operation = (new parser::nodes::Multiplication(Coordinate{}, first, second))->get();
                 break;
             case enums::SimpleOperation::Division:
-                full_operation = (new parser::nodes::Division({0, 0, 0}, first, second))->get();
+                full_operation = (new parser::nodes::Division(Coordinate{}, first, second))->get();
                 break;
             case enums::SimpleOperation::Remainder:
-                full_operation = (new parser::nodes::Modulus({0, 0, 0}, first, second))->get();
+                full_operation = (new parser::nodes::Modulus(Coordinate{}, first, second))->get();
                 break;
             case enums::SimpleOperation::Addition:
-                full_operation = (new parser::nodes::Addition({0, 0, 0}, first, second))->get();
+                full_operation = (new parser::nodes::Addition(Coordinate{}, first, second))->get();
                 break;
             case enums::SimpleOperation::Subtraction:
-                full_operation = (new parser::nodes::Subtraction({0, 0, 0}, first, second))->get();
+                full_operation = (new parser::nodes::Subtraction(Coordinate{}, first, second))->get();
                 break;
             case enums::SimpleOperation::LeftShift:
-                full_operation = (new parser::nodes::LeftShift({0, 0, 0}, first, second))->get();
+                full_operation = (new parser::nodes::LeftShift(Coordinate{}, first, second))->get();
                 break;
             case enums::SimpleOperation::RightShift:
-                full_operation = (new parser::nodes::RightShift({0, 0, 0}, first, second))->get();
+                full_operation = (new parser::nodes::RightShift(Coordinate{}, first, second))->get();
                 break;
             case enums::SimpleOperation::LesserThan:
-                full_operation = (new parser::nodes::LesserThan({0, 0, 0}, first, second))->get();
+                full_operation = (new parser::nodes::LesserThan(Coordinate{}, first, second))->get();
                 break;
             case enums::SimpleOperation::GreaterThan:
-                full_operation = (new parser::nodes::GreaterThan({0, 0, 0}, first, second))->get();
+                full_operation = (new parser::nodes::GreaterThan(Coordinate{}, first, second))->get();
                 break;
             case enums::SimpleOperation::LesserThanOrEqualTo:
-                full_operation = (new parser::nodes::LesserEqual({0, 0, 0}, first, second))->get();
+                full_operation = (new parser::nodes::LesserEqual(Coordinate{}, first, second))->get();
                 break;
             case enums::SimpleOperation::GreaterThanOrEqualTo:
-                full_operation = (new parser::nodes::GreaterEqual({0, 0, 0}, first, second))->get();
+                full_operation = (new parser::nodes::GreaterEqual(Coordinate{}, first, second))->get();
                 break;
             case enums::SimpleOperation::EqualTo:
-                full_operation = (new parser::nodes::EqualTo({0, 0, 0}, first, second))->get();
+                full_operation = (new parser::nodes::EqualTo(Coordinate{}, first, second))->get();
                 break;
             case enums::SimpleOperation::NotEqualTo:
-                full_operation = (new parser::nodes::NotEqualTo({0, 0, 0}, first, second))->get();
+                full_operation = (new parser::nodes::NotEqualTo(Coordinate{}, first, second))->get();
                 break;
             case enums::SimpleOperation::And:
-                full_operation = (new parser::nodes::And({0, 0, 0}, first, second))->get();
+                full_operation = (new parser::nodes::And(Coordinate{}, first, second))->get();
                 break;
             case enums::SimpleOperation::Or:
-                full_operation = (new parser::nodes::Or({0, 0, 0}, first, second))->get();
+                full_operation = (new parser::nodes::Or(Coordinate{}, first, second))->get();
                 break;
             case enums::SimpleOperation::Xor:
-                full_operation = (new parser::nodes::Xor({0, 0, 0}, first, second))->get();
+                full_operation = (new parser::nodes::Xor(Coordinate{}, first, second))->get();
                 break;
             case enums::SimpleOperation::Combine:
-                full_operation = (new parser::nodes::Combination({0, 0, 0}, first, second))->get();
+                full_operation = (new parser::nodes::Combination(Coordinate{}, first, second))->get();
                 break;
             case enums::SimpleOperation::Compose:
-                full_operation = (new parser::nodes::TupleCall({0, 0, 0}, first, {second}))->get();
+                full_operation = (new parser::nodes::TupleCall(Coordinate{}, first, {second}))->get();
         }
         std::vector<bacteria::FunctionArgument> arguments = {};
         arguments.emplace_back(gctx->global_receiver->get_type(bacteria::BacteriaType::Type::Reference, 0,
@@ -255,11 +255,12 @@ namespace cheese::curdle {
             arguments.emplace_back(arg_types[i]->get_cached_type(gctx->global_receiver.get()), "_" + std::to_string(i));
         }
 
-        auto fn = new bacteria::nodes::Function({0, 0, 0}, cached_function_name, arguments,
+        // These only ever forward to the composed functions, so they are always worth inlining
+        auto fn = new bacteria::nodes::Function(Coordinate{}, cached_function_name, arguments,
                                                 get_return_type(gctx)->get_cached_type(
-                                                        gctx->global_receiver.get()));
+                                                        gctx->global_receiver.get()), false, true);
         gctx->global_receiver->receive(fn->get());
-        fn->receive((new bacteria::nodes::Return({0, 0, 0}, translate_expression(lctx, full_operation)))->get());
+        fn->receive((new bacteria::nodes::Return(Coordinate{}, translate_expression(lctx, full_operation)))->get());
         return cached_function_name;
     }
 }
\ No newline at end of file
@@ -28,12 +28,7 @@ namespace cheese::curdle {
     }
 
     ComptimeComplexType *ComptimeComplexType::get(cheese::project::GlobalContext *gctx) {
-        if (!gctx->cached_objects.contains("type: comptime_complex")) {
-            auto ref = gctx->gc.gcnew<ComptimeComplexType>();
-            gctx->cached_objects["type: c64"] = ref;
-            return ref;
-        }
-        return dynamic_cast<ComptimeComplexType *>(gctx->cached_objects["type: comptime_complex"]);
+        return gctx->get_singleton<ComptimeComplexType>();
     }
 
     Comptimeness ComptimeComplexType::get_comptimeness() {
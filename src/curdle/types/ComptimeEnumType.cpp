@@ -20,12 +20,7 @@ namespace cheese::curdle {
     }
 
     ComptimeEnumType *ComptimeEnumType::get(cheese::project::GlobalContext *gctx) {
-        if (!gctx->cached_objects.contains("type: $ComptimeEnum")) {
-            auto ref = gctx->gc.gcnew<ComptimeEnumType>();
-            gctx->cached_objects["type: $ComptimeEnum"] = ref;
-            return ref;
-        }
-        return dynamic_cast<ComptimeEnumType *>(gctx->cached_objects["type: $ComptimeEnum"]);
+        return gctx->get_singleton<ComptimeEnumType>();
     }
 
     Comptimeness ComptimeEnumType::get_comptimeness() {
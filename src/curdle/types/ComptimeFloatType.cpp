@@ -24,12 +24,7 @@ namespace cheese::curdle {
     }
 
     ComptimeFloatType *ComptimeFloatType::get(cheese::project::GlobalContext *gctx) {
-        if (!gctx->cached_objects.contains("type: comptime_float")) {
-            auto ref = gctx->gc.gcnew<ComptimeFloatType>();
-            gctx->cached_objects["type: comptime_float"] = ref;
-            return ref;
-        }
-        return dynamic_cast<ComptimeFloatType *>(gctx->cached_objects["type: comptime_float"]);
+        return gctx->get_singleton<ComptimeFloatType>();
     }
 
 
@@ -20,12 +20,7 @@ namespace cheese::curdle {
     }
 
     ComptimeIntegerType *ComptimeIntegerType::get(cheese::project::GlobalContext *gctx) {
-        if (!gctx->cached_objects.contains("type: comptime_int")) {
-            auto ref = gctx->gc.gcnew<ComptimeIntegerType>();
-            gctx->cached_objects["type: comptime_int"] = ref;
-            return ref;
-        }
-        return dynamic_cast<ComptimeIntegerType *>(gctx->cached_objects["type: comptime_int"]);
+        return gctx->get_singleton<ComptimeIntegerType>();
     }
 
     Comptimeness ComptimeIntegerType::get_comptimeness() {
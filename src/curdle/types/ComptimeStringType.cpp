@@ -19,12 +19,7 @@ namespace cheese::curdle {
     }
 
     ComptimeStringType *ComptimeStringType::get(GlobalContext *gctx) {
-        if (!gctx->cached_objects.contains("type: comptime_string")) {
-            auto ref = gctx->gc.gcnew<ComptimeStringType>();
-            gctx->cached_objects["type: comptime_string"] = ref;
-            return ref;
-        }
-        return dynamic_cast<ComptimeStringType *>(gctx->cached_objects["type: comptime_string"]);
+        return gctx->get_singleton<ComptimeStringType>();
     }
 
     Comptimeness ComptimeStringType::get_comptimeness() {
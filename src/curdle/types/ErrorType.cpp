@@ -40,12 +40,7 @@ namespace cheese::curdle {
 
 
     ErrorType *ErrorType::get(cheese::project::GlobalContext *gctx) {
-        if (!gctx->cached_objects.contains("type: error")) {
-            auto ref = gctx->gc.gcnew<ErrorType>();
-            gctx->cached_objects["type: error"] = ref;
-            return ref;
-        }
-        return dynamic_cast<ErrorType *>(gctx->cached_objects["type: error"]);
+        return gctx->get_singleton<ErrorType>();
     }
 
     gcref<ComptimeValue> ErrorType::get_child_comptime(std::string key, cheese::project::GlobalContext *gctx) {
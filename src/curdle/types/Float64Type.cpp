@@ -28,12 +28,7 @@ namespace cheese::curdle {
     }
 
     Float64Type *Float64Type::get(cheese::project::GlobalContext *gctx) {
-        if (!gctx->cached_objects.contains("type: f64")) {
-            auto ref = gctx->gc.gcnew<Float64Type>();
-            gctx->cached_objects["type: f64"] = ref;
-            return ref;
-        }
-        return dynamic_cast<Float64Type *>(gctx->cached_objects["type: f64"]);
+        return gctx->get_singleton<Float64Type>();
     }
 
     Comptimeness Float64Type::get_comptimeness() {
@@ -23,6 +23,22 @@ namespace cheese::curdle {
                                  return_type->get_cached_type(program), {}, child_types);
     }
 
+    FunctionPointerType::FunctionPointerType(Type *return_type, std::vector<Type *> argument_types)
+            : return_type(return_type), argument_types(std::move(argument_types)) {
+
+    }
+
+    FunctionPointerType *
+    FunctionPointerType::get(cheese::project::GlobalContext *gctx, Type *return_type,
+                             const std::vector<Type *> &argument_types) {
+        auto key = std::make_pair(return_type, argument_types);
+        if (auto it = gctx->function_pointer_types.find(key); it != gctx->function_pointer_types.end())
+            return it->second;
+        auto ref = gctx->gc.gcnew<FunctionPointerType>(return_type, argument_types);
+        gctx->function_pointer_types[key] = ref;
+        return ref;
+    }
+
     void FunctionPointerType::mark_type_references() {
         return_type->mark();
         for (const auto child: argument_types) {
@@ -19,12 +19,7 @@ namespace cheese::curdle {
 
 
     FunctionTemplateType *FunctionTemplateType::get(cheese::project::GlobalContext *gctx) {
-        if (!gctx->cached_objects.contains("type: function_template")) {
-            auto ref = gctx->gc.gcnew<FunctionTemplateType>();
-            gctx->cached_objects["type: function_template"] = ref;
-            return ref;
-        }
-        return dynamic_cast<FunctionTemplateType *>(gctx->cached_objects["type: function_template"]);
+        return gctx->get_singleton<FunctionTemplateType>();
     }
 
     Comptimeness FunctionTemplateType::get_comptimeness() {
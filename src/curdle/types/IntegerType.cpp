@@ -17,13 +17,14 @@
 
 namespace cheese::curdle {
     IntegerType *IntegerType::get(cheese::project::GlobalContext *gctx, bool sign, std::uint16_t size) {
-        std::string name = std::string("type: ") + (sign ? "i" : "u") + std::to_string(size);
-        if (!gctx->cached_objects.contains(name)) {
-            auto ref = gctx->gc.gcnew<IntegerType>(sign, size);
-            gctx->cached_objects[name] = ref;
-            return ref;
+        auto index = static_cast<std::size_t>(size) * 2 + (sign ? 1 : 0);
+        if (index < gctx->integer_types.size() && gctx->integer_types[index] != nullptr) {
+            return gctx->integer_types[index];
         }
-        return dynamic_cast<IntegerType *>(gctx->cached_objects[name]);
+        auto ref = gctx->gc.gcnew<IntegerType>(sign, size);
+        if (index >= gctx->integer_types.size()) gctx->integer_types.resize(index + 1, nullptr);
+        gctx->integer_types[index] = ref;
+        return ref;
     }
 
     bacteria::TypePtr IntegerType::get_bacteria_type(bacteria::nodes::BacteriaProgram *program) {
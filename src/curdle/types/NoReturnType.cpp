@@ -12,12 +12,7 @@
 
 namespace cheese::curdle {
     NoReturnType *NoReturnType::get(cheese::project::GlobalContext *gctx) {
-        if (!gctx->cached_objects.contains("type: noreturn")) {
-            auto ref = gctx->gc.gcnew<NoReturnType>();
-            gctx->cached_objects["type: noreturn"] = ref;
-            return ref;
-        }
-        return dynamic_cast<NoReturnType *>(gctx->cached_objects["type: noreturn"]);
+        return gctx->get_singleton<NoReturnType>();
     }
 
     bacteria::TypePtr NoReturnType::get_bacteria_type(bacteria::nodes::BacteriaProgram *program) {
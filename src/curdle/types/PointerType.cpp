@@ -34,6 +34,14 @@ namespace cheese::curdle {
 
     }
 
+    PointerType *PointerType::get(GlobalContext *gctx, Type *subtype, bool constant) {
+        auto key = std::make_pair(subtype, constant);
+        if (auto it = gctx->pointer_types.find(key); it != gctx->pointer_types.end()) return it->second;
+        auto ref = gctx->gc.gcnew<PointerType>(subtype, constant);
+        gctx->pointer_types[key] = ref;
+        return ref;
+    }
+
     Comptimeness PointerType::get_comptimeness() {
         return subtype->get_comptimeness();
     }
@@ -13,6 +13,14 @@
 #include "curdle/types/TypeType.h"
 
 namespace cheese::curdle {
+    ReferenceType *ReferenceType::get(GlobalContext *gctx, Type *child, bool constant) {
+        auto key = std::make_pair(child, constant);
+        if (auto it = gctx->reference_types.find(key); it != gctx->reference_types.end()) return it->second;
+        auto ref = gctx->gc.gcnew<ReferenceType>(child, constant);
+        gctx->reference_types[key] = ref;
+        return ref;
+    }
+
     bacteria::TypePtr ReferenceType::get_bacteria_type(bacteria::nodes::BacteriaProgram *program) {
         auto child_type = child->get_cached_type(program);
         return program->get_type(bacteria::BacteriaType::Type::Reference, {}, child_type, {}, {}, {}, constant);
@@ -30,6 +38,7 @@ namespace cheese::curdle {
     // Rather than a regular address of operator which is &value
     // But on a known lvalue the possible rvalue address gets converted into an lvalue in second stage lowering
     int32_t ReferenceType::compare(Type *other, bool implicit) {
+        if (other == this) return 0;
         if (auto other_r = dynamic_cast<ReferenceType *>(other); other_r && child->compare(other_r->child) == 0) {
             return 0;
         }
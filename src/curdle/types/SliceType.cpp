@@ -0,0 +1,87 @@
+#include "curdle/types/SliceType.h"
+#include "curdle/types/ArrayType.h"
+#include "curdle/comptime.h"
+#include "curdle/types/ComptimeStringType.h"
+#include "curdle/types/IntegerType.h"
+#include "curdle/values/ComptimeInteger.h"
+#include "curdle/values/ComptimeString.h"
+#include "curdle/values/ComptimeType.h"
+#include "curdle/curdle.h"
+#include "curdle/types/AnyType.h"
+
+namespace cheese::curdle {
+
+    memory::garbage_collection::gcref<ComptimeValue>
+    SliceType::get_child_comptime(std::string key, cheese::project::GlobalContext *gctx) {
+        CATCH_DUNDER_NAME;
+        CATCH_DUNDER_SIZE;
+        if (key == "subtype") {
+            return {gctx->gc, new ComptimeType{gctx, subtype}};
+        }
+        INVALID_CHILD;
+    }
+
+    bacteria::TypePtr SliceType::get_bacteria_type(bacteria::nodes::BacteriaProgram *program) {
+        return program->get_type(bacteria::BacteriaType::Type::Slice, 0, subtype->get_cached_type(program), {}, {},
+                                 {}, constant);
+    }
+
+    void SliceType::mark_type_references() {
+        subtype->mark();
+    }
+
+    SliceType::SliceType(Type *subtype, bool constant) : subtype(subtype), constant(constant) {
+
+    }
+
+    SliceType *SliceType::get(GlobalContext *gctx, Type *subtype, bool constant) {
+        auto key = std::make_pair(subtype, constant);
+        if (auto it = gctx->slice_types.find(key); it != gctx->slice_types.end()) return it->second;
+        auto ref = gctx->gc.gcnew<SliceType>(subtype, constant);
+        gctx->slice_types[key] = ref;
+        return ref;
+    }
+
+    Comptimeness SliceType::get_comptimeness() {
+        return subtype->get_comptimeness();
+    }
+
+    // Slices can always be made constant, but never the other way around
+    int32_t SliceType::compare(Type *other, bool implicit) {
+        if (other == this) return 0;
+        if (auto as_slice = dynamic_cast<SliceType *>(other); as_slice) {
+            if ((constant || !as_slice->constant) && as_slice->subtype->compare(subtype) == 0) {
+                return (constant == as_slice->constant) ? 0 : 1;
+            }
+        }
+        if (auto as_array = dynamic_cast<ArrayType *>(other); as_array && as_array->dimensions.size() == 1) {
+            if ((constant || !as_array->constant) && as_array->subtype->compare(subtype) == 0) {
+                return 1;
+            }
+        }
+        if (auto as_str = dynamic_cast<ComptimeStringType *>(other); as_str) {
+            return constant ? 1 : -1;
+        }
+        return -1;
+    }
+
+    std::string SliceType::to_string() {
+        return (constant ? "<>~" : "<>") + subtype->to_string();
+    }
+
+    memory::garbage_collection::gcref<Type> SliceType::peer(Type *other, cheese::project::GlobalContext *gctx) {
+        PEER_TYPE_CATCH_ANY();
+        if (other == this) return REF(this);
+        if (auto as_slice = dynamic_cast<SliceType *>(other); as_slice) {
+            if (as_slice->subtype->compare(subtype) == 0) {
+                return REF(SliceType::get(gctx, subtype, constant || as_slice->constant));
+            }
+        }
+        if (auto as_array = dynamic_cast<ArrayType *>(other); as_array && as_array->dimensions.size() == 1) {
+            if ((constant || !as_array->constant) && as_array->subtype->compare(subtype) == 0) {
+                return REF(this);
+            }
+        }
+        NO_PEER;
+    }
+}
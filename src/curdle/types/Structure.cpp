@@ -24,8 +24,16 @@ namespace cheese::curdle {
 
     bacteria::TypePtr Structure::get_bacteria_type(bacteria::nodes::BacteriaProgram *program) {
         cached_type = program->get_type(bacteria::BacteriaType::Type::Object, {}, {}, {}, {}, mangle(name));
+        cached_type->packed = packed;
+        cached_type->reorder_fields = reorder_fields;
+        cached_type->alignment = alignment;
         for (auto &child: fields) {
             cached_type->child_types.push_back(child.type->get_cached_type(program));
+            if (field_alignments.contains(child.name)) {
+                cached_type->field_alignments.push_back(field_alignments[child.name]);
+            } else {
+                cached_type->field_alignments.push_back(0);
+            }
         }
         return cached_type;
     }
@@ -182,8 +190,12 @@ namespace cheese::curdle {
             bool ctime = result_type->get_comptimeness() != Comptimeness::Runtime || definition->flags.comptime;
             if (ctime) {
                 try {
-                    containedContext->push_structure_name(name.empty() ? lazy->name : name + "." + lazy->name);
-                    auto value = containedContext->exec(pVariableDeclaration->value);
+                    containedContext->push_structure_name(name.empty() ? lazy->name.str() : name + "." + lazy->name);
+                    // A declared type lets a literal be built as that type directly
+                    auto literal = definition->type.has_value() ? containedContext->try_exec_literal(
+                            pVariableDeclaration->value.get(), nullptr, result_type) : std::nullopt;
+                    auto value = literal.has_value() ? std::move(literal.value())
+                                                     : containedContext->exec(pVariableDeclaration->value);
                     containedContext->pop_structure_name();
                     comptime_variables.insert({lazy->name, ComptimeVariableInfo{
                             definition->flags.pub != 0,
@@ -203,8 +215,8 @@ namespace cheese::curdle {
             } else {
                 auto lctx = gc.gcnew<LocalContext>(rctx);
                 lctx->expected_type = result_type;
-                auto varName = definition->flags.exter ? lazy->name : mangle(
-                        name.empty() ? lazy->name : name + "." + lazy->name);
+                auto varName = definition->flags.exter ? lazy->name.str() : mangle(
+                        name.empty() ? lazy->name.str() : name + "." + lazy->name);
                 gctx->global_receiver->receive(
                         std::make_unique<bacteria::nodes::VariableInitializationNode>(lazy->node->location, varName,
                                                                                       result_type->get_cached_type(
@@ -277,11 +289,28 @@ namespace cheese::curdle {
         }
     }
 
-    void Structure::resolve_by_name(const std::string &name) {
-        for (auto &lazy: lazies) {
-            if (lazy != nullptr && lazy->name == name) {
+    void Structure::add_lazy(Symbol lazy_name, parser::NodePtr node) {
+        unresolved_lazies[lazy_name].push_back(lazies.size());
+        lazies.push_back(new LazyValue{lazy_name, std::move(node)});
+    }
+
+    void Structure::resolve_by_name(Symbol name) {
+        auto it = unresolved_lazies.find(name);
+        if (it == unresolved_lazies.end()) return;
+        // Copied as resolving a lazy can recurse back into here and drop the entry
+        auto indices = it->second;
+        bool all_resolved = true;
+        for (auto index: indices) {
+            auto &lazy = lazies[index];
+            if (lazy != nullptr) {
                 resolve_lazy(lazy);
             }
+            if (lazy != nullptr) {
+                all_resolved = false;
+            }
+        }
+        if (all_resolved) {
+            unresolved_lazies.erase(name);
         }
     }
 
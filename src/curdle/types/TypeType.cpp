@@ -20,12 +20,7 @@ namespace cheese::curdle {
 
 
     TypeType *TypeType::get(cheese::project::GlobalContext *gctx) {
-        if (!gctx->cached_objects.contains("type: type")) {
-            auto ref = gctx->gc.gcnew<TypeType>();
-            gctx->cached_objects["type: type"] = ref;
-            return ref;
-        }
-        return dynamic_cast<TypeType *>(gctx->cached_objects["type: type"]);
+        return gctx->get_singleton<TypeType>();
     }
 
     Comptimeness TypeType::get_comptimeness() {
@@ -0,0 +1,82 @@
+#include "curdle/types/VectorType.h"
+#include "curdle/comptime.h"
+#include "curdle/types/ComptimeStringType.h"
+#include "curdle/types/IntegerType.h"
+#include "curdle/values/ComptimeInteger.h"
+#include "curdle/values/ComptimeString.h"
+#include "curdle/values/ComptimeType.h"
+#include "curdle/curdle.h"
+#include "curdle/types/AnyType.h"
+
+namespace cheese::curdle {
+
+    memory::garbage_collection::gcref<ComptimeValue>
+    VectorType::get_child_comptime(std::string key, cheese::project::GlobalContext *gctx) {
+        CATCH_DUNDER_NAME;
+        CATCH_DUNDER_SIZE;
+        if (key == "lanes") {
+            return gctx->gc.gcnew<ComptimeInteger>(math::BigInteger(lanes),
+                                                   IntegerType::get(gctx, false, gctx->machine.data_pointer_size * 8));
+        }
+        if (key == "subtype") {
+            return gctx->gc.gcnew<ComptimeType>(gctx, subtype);
+        }
+        INVALID_CHILD;
+    }
+
+    bacteria::TypePtr VectorType::get_bacteria_type(bacteria::nodes::BacteriaProgram *program) {
+        return program->get_type(bacteria::BacteriaType::Type::Vector, 0, subtype->get_cached_type(program), {lanes});
+    }
+
+    void VectorType::mark_type_references() {
+        subtype->mark();
+    }
+
+    VectorType::VectorType(Type *subtype, std::uint64_t lanes) : subtype(subtype), lanes(lanes) {
+
+    }
+
+    VectorType *VectorType::get(GlobalContext *gctx, Type *subtype, std::uint64_t lanes) {
+        auto key = std::make_pair(subtype, lanes);
+        if (auto it = gctx->vector_types.find(key); it != gctx->vector_types.end()) return it->second;
+        auto ref = gctx->gc.gcnew<VectorType>(subtype, lanes);
+        gctx->vector_types[key] = ref;
+        return ref;
+    }
+
+    Comptimeness VectorType::get_comptimeness() {
+        return subtype->get_comptimeness();
+    }
+
+    int32_t VectorType::compare(Type *other, bool implicit) {
+        if (other == this) return 0;
+        if (auto as_vector = dynamic_cast<VectorType *>(other); as_vector) {
+            if (as_vector->lanes != lanes) return -1;
+            return subtype->compare(as_vector->subtype) == 0 ? 0 : -1;
+        }
+        // A scalar gets broadcast to every lane, which costs a bit more than the cast to the lane type itself
+        if (!implicit) return -1;
+        auto lane_cost = subtype->compare(other);
+        if (lane_cost < 0) return -1;
+        return lane_cost + 1;
+    }
+
+    std::string VectorType::to_string() {
+        return "Vector(" + subtype->to_string() + ", " + std::to_string(lanes) + ")";
+    }
+
+    memory::garbage_collection::gcref<Type> VectorType::peer(Type *other, cheese::project::GlobalContext *gctx) {
+        if (other == this) return REF(this);
+        PEER_TYPE_CATCH_ANY();
+        if (auto as_vector = dynamic_cast<VectorType *>(other); as_vector) {
+            if (as_vector->lanes == lanes && subtype->compare(as_vector->subtype) == 0) {
+                return REF(this);
+            }
+            return NO_PEER;
+        }
+        if (subtype->compare(other) >= 0) {
+            return REF(this);
+        }
+        return NO_PEER;
+    }
+}
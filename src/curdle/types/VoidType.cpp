@@ -19,12 +19,7 @@ namespace cheese::curdle {
     }
 
     VoidType *VoidType::get(cheese::project::GlobalContext *gctx) {
-        if (!gctx->cached_objects.contains("type: void")) {
-            auto ref = gctx->gc.gcnew<VoidType>();
-            gctx->cached_objects["type: void"] = ref;
-            return ref;
-        }
-        return dynamic_cast<VoidType *>(gctx->cached_objects["type: void"]);
+        return gctx->get_singleton<VoidType>();
     }
 
     Comptimeness VoidType::get_comptimeness() {
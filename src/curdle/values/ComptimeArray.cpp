@@ -4,6 +4,17 @@
 #include "curdle/values/ComptimeArray.h"
 #include "error.h"
 #include "curdle/curdle.h"
+#include "curdle/types/IntegerType.h"
+#include "curdle/types/Float64Type.h"
+#include "curdle/types/ArrayType.h"
+#include "curdle/types/BooleanType.h"
+#include "curdle/types/ComptimeIntegerType.h"
+#include "curdle/values/ComptimeInteger.h"
+#include "curdle/values/ComptimeFloat.h"
+#include "curdle/values/ComptimeBool.h"
+#include "project/GlobalContext.h"
+#include <cstring>
+#include <limits>
 
 namespace cheese::curdle {
     void ComptimeArray::mark_value() {
@@ -12,12 +23,161 @@ namespace cheese::curdle {
         }
     }
 
+    static bool can_pack(Type *element_type) {
+        if (auto as_integer = dynamic_cast<IntegerType *>(element_type); as_integer) {
+            return as_integer->size != 0 && as_integer->size <= 64;
+        }
+        return dynamic_cast<ComptimeIntegerType *>(element_type) != nullptr ||
+               dynamic_cast<Float64Type *>(element_type) != nullptr;
+    }
+
+    // Appends a value that already has the element type to packed data, false if it doesn't fit
+    static bool pack(std::vector<std::uint8_t> &data, Type *element_type, ComptimeValue *value) {
+        auto element_size = ComptimeArray::get_element_size(element_type);
+        std::uint64_t raw;
+        if (auto as_integer = dynamic_cast<ComptimeInteger *>(value); as_integer) {
+            // A comptime_int has no size of its own, so it only gets packed if it fits in 64 bits
+            if (dynamic_cast<ComptimeIntegerType *>(element_type) &&
+                (as_integer->value < std::numeric_limits<std::int64_t>::min() ||
+                 as_integer->value > std::numeric_limits<std::int64_t>::max())) {
+                return false;
+            }
+            raw = static_cast<std::uint64_t>(as_integer->value);
+        } else if (auto as_float = dynamic_cast<ComptimeFloat *>(value); as_float) {
+            std::memcpy(&raw, &as_float->value, sizeof(double));
+        } else {
+            return false;
+        }
+        for (std::size_t i = 0; i < element_size; i++) {
+            data.push_back(static_cast<std::uint8_t>(raw >> (i * 8)));
+        }
+        return true;
+    }
+
+    Type *ComptimeArray::get_packed_element_type(Type *type) {
+        if (auto as_array = dynamic_cast<ArrayType *>(type); as_array) {
+            return can_pack(as_array->subtype) ? as_array->subtype : nullptr;
+        }
+        auto as_structure = dynamic_cast<Structure *>(type);
+        if (!as_structure || !as_structure->is_tuple || as_structure->fields.empty()) return nullptr;
+        auto element_type = as_structure->fields[0].type;
+        if (!can_pack(element_type)) return nullptr;
+        for (auto &field: as_structure->fields) {
+            if (field.type != element_type) return nullptr;
+        }
+        return element_type;
+    }
+
+    std::size_t ComptimeArray::get_element_size(Type *element_type) {
+        if (auto as_integer = dynamic_cast<IntegerType *>(element_type); as_integer) {
+            return (as_integer->size + 7) / 8;
+        }
+        return sizeof(std::uint64_t);
+    }
+
+    bool ComptimeArray::is_integer_element() {
+        return dynamic_cast<IntegerType *>(element_type) || dynamic_cast<ComptimeIntegerType *>(element_type);
+    }
+
+    std::size_t ComptimeArray::size() {
+        if (is_packed()) return packed_data.size() / get_element_size(element_type);
+        return values.size();
+    }
+
+    static math::BigInteger read_integer(Type *element_type, const std::vector<std::uint8_t> &data, std::size_t index) {
+        auto as_integer = dynamic_cast<IntegerType *>(element_type);
+        auto element_size = ComptimeArray::get_element_size(element_type);
+        std::uint64_t raw = 0;
+        for (std::size_t i = 0; i < element_size; i++) {
+            raw |= static_cast<std::uint64_t>(data[index * element_size + i]) << (i * 8);
+        }
+        if (!as_integer) return {static_cast<std::int64_t>(raw)};
+        if (!as_integer->sign) return {raw};
+        // Sign extend from however many bits the type has
+        auto unused_bits = 64 - as_integer->size;
+        return {static_cast<std::int64_t>(raw << unused_bits) >> unused_bits};
+    }
+
+    static double read_float(const std::vector<std::uint8_t> &data, std::size_t index) {
+        double value;
+        std::memcpy(&value, data.data() + index * sizeof(double), sizeof(double));
+        return value;
+    }
+
+    static gcref<ComptimeValue> box(garbage_collector &garbageCollector, Type *element_type,
+                                    const std::vector<std::uint8_t> &data, std::size_t index) {
+        if (dynamic_cast<Float64Type *>(element_type)) {
+            return garbageCollector.gcnew<ComptimeFloat>(read_float(data, index), element_type);
+        }
+        return garbageCollector.gcnew<ComptimeInteger>(read_integer(element_type, data, index), element_type);
+    }
+
+    math::BigInteger ComptimeArray::integer_at(std::size_t index) {
+        return read_integer(element_type, packed_data, index);
+    }
+
+    double ComptimeArray::float_at(std::size_t index) {
+        return read_float(packed_data, index);
+    }
+
+    gcref<ComptimeValue> ComptimeArray::get(garbage_collector &garbageCollector, std::size_t index) {
+        if (!is_packed()) return {garbageCollector, values[index]};
+        return box(garbageCollector, element_type, packed_data, index);
+    }
+
+    void ComptimeArray::Builder::push(gcref<ComptimeValue> value) {
+        if (packing) {
+            if (values.empty() && packed_data.empty() && can_pack(value->type)) element_type = value->type;
+            if (element_type && value->type == element_type && pack(packed_data, element_type, value.get())) return;
+            unpack();
+        }
+        values.push_back(value.get());
+        refs.push_back(std::move(value));
+    }
+
+    void ComptimeArray::Builder::unpack() {
+        packing = false;
+        if (!element_type) return;
+        for (std::size_t i = 0; i < packed_data.size() / get_element_size(element_type); i++) {
+            auto value = box(garbageCollector, element_type, packed_data, i);
+            values.push_back(value.get());
+            refs.push_back(std::move(value));
+        }
+        packed_data.clear();
+        element_type = nullptr;
+    }
+
+    gcref<ComptimeValue> ComptimeArray::Builder::finish(Type *type) {
+        if (packing && element_type) {
+            return garbageCollector.gcnew<ComptimeArray>(type, element_type, std::move(packed_data));
+        }
+        return garbageCollector.gcnew<ComptimeArray>(type, std::move(values));
+    }
+
+    bool ComptimeArray::element_is(std::size_t index, ComptimeValue *value) {
+        if (value->type != element_type) return false;
+        if (auto as_integer = dynamic_cast<ComptimeInteger *>(value); as_integer) {
+            return integer_at(index) == as_integer->value;
+        }
+        if (auto as_float = dynamic_cast<ComptimeFloat *>(value); as_float) return float_at(index) == as_float->value;
+        return false;
+    }
+
     bool ComptimeArray::is_same_as(ComptimeValue *other) {
         if (other->type->compare(type) != 0) return false;
         if (auto as_array = dynamic_cast<ComptimeArray *>(other); as_array) {
-            if (as_array->values.size() != values.size()) return false;
-            for (int i = 0; i < values.size(); i++) {
-                if (!values[i]->is_same_as(as_array->values[i])) return false;
+            if (as_array->size() != size()) return false;
+            if (is_packed() && as_array->is_packed()) {
+                return element_type == as_array->element_type && packed_data == as_array->packed_data;
+            }
+            for (std::size_t i = 0; i < size(); i++) {
+                if (is_packed()) {
+                    if (!element_is(i, as_array->values[i])) return false;
+                } else if (as_array->is_packed()) {
+                    if (!as_array->element_is(i, values[i])) return false;
+                } else if (!values[i]->is_same_as(as_array->values[i])) {
+                    return false;
+                }
             }
             return true;
         } else {
@@ -25,19 +185,53 @@ namespace cheese::curdle {
         }
     }
 
+    gcref<ComptimeValue> ComptimeArray::op_equal(GlobalContext *gctx, ComptimeValue *other) {
+        auto rhs = other->type->compare(type) == 0 ? gcref<ComptimeValue>{gctx->gc, other} : other->cast(type, gctx->gc);
+        return gctx->gc.gcnew<ComptimeBool>(is_same_as(rhs.get()), BooleanType::get(gctx));
+    }
+
+    gcref<ComptimeValue> ComptimeArray::op_not_equal(GlobalContext *gctx, ComptimeValue *other) {
+        auto rhs = other->type->compare(type) == 0 ? gcref<ComptimeValue>{gctx->gc, other} : other->cast(type, gctx->gc);
+        return gctx->gc.gcnew<ComptimeBool>(!is_same_as(rhs.get()), BooleanType::get(gctx));
+    }
+
+    gcref<ComptimeValue> ComptimeArray::cast_elements(Type *target_type, garbage_collector &garbageCollector,
+                                                      const std::function<Type *(std::size_t)> &element_type_at) {
+        // Going between the same element type is just a copy of the data
+        if (is_packed() && get_packed_element_type(target_type) == element_type) {
+            return garbageCollector.gcnew<ComptimeArray>(target_type, element_type, packed_data);
+        }
+        Builder builder{garbageCollector};
+        for (std::size_t i = 0; i < size(); i++) {
+            builder.push(get(garbageCollector, i)->cast(element_type_at(i), garbageCollector));
+        }
+        return builder.finish(target_type);
+    }
+
     gcref<ComptimeValue> ComptimeArray::cast(Type *target_type, garbage_collector &garbageCollector) {
+        // Tuples and arrays with as many elements become arrays element by element, in row major order for arrays with
+        // more than one dimension
+        if (auto as_array = dynamic_cast<ArrayType *>(target_type); as_array) {
+            auto cur_struct = dynamic_cast<Structure *>(type);
+            auto cur_array = dynamic_cast<ArrayType *>(type);
+            std::size_t count = 1;
+            for (auto dimension: as_array->dimensions) count *= dimension;
+            if ((!cur_array && (!cur_struct || !cur_struct->is_tuple)) || size() != count) {
+                throw CurdleError(
+                        "Cannot cast " + type->to_string() + " to " + target_type->to_string() + " at compile time",
+                        error::ErrorCode::InvalidCast);
+            }
+            return cast_elements(target_type, garbageCollector, [as_array](std::size_t) {
+                return as_array->subtype;
+            });
+        }
         if (auto cur_struct = dynamic_cast<Structure *>(type); cur_struct) {
             if (auto other_struct = dynamic_cast<Structure *>(target_type); other_struct) {
                 if (cur_struct->is_tuple == other_struct->is_tuple) {
                     if (cur_struct->is_tuple) {
-                        auto new_values = std::vector<ComptimeValue *>();
-                        auto refs = std::vector<gcref<ComptimeValue>>();
-                        for (int i = 0; i < values.size(); i++) {
-                            auto value = values[i]->cast(other_struct->fields[i].type, garbageCollector);
-                            new_values.push_back(value);
-                            refs.push_back(std::move(value));
-                        }
-                        return garbageCollector.gcnew<ComptimeArray>(target_type, std::move(new_values));
+                        return cast_elements(target_type, garbageCollector, [other_struct](std::size_t i) {
+                            return other_struct->fields[i].type;
+                        });
                     } else {
                         NOT_IMPL_FOR("struct casting");
                     }
@@ -64,9 +258,15 @@ namespace cheese::curdle {
         } else {
             result += '[';
         }
-        for (int i = 0; i < values.size(); i++) {
-            result += values[i]->to_string();
-            if (i != values.size() - 1) {
+        for (std::size_t i = 0; i < size(); i++) {
+            if (!is_packed()) {
+                result += values[i]->to_string();
+            } else if (is_integer_element()) {
+                result += static_cast<std::string>(integer_at(i));
+            } else {
+                result += std::to_string(float_at(i));
+            }
+            if (i != size() - 1) {
                 result += ',';
             }
         }
@@ -15,7 +15,15 @@ namespace cheese::curdle {
     }
 
     bool ComptimeBool::is_same_as(ComptimeValue *other) {
-        return false;
+        if (auto as_bool = dynamic_cast<ComptimeBool *>(other); as_bool) {
+            return type == as_bool->type && value == as_bool->value;
+        } else {
+            return false;
+        }
+    }
+
+    std::size_t ComptimeBool::hash() {
+        return value;
     }
 
     static gcref<ComptimeValue> new_value(garbage_collector &garbageCollector, ComptimeValue *value) {
@@ -34,6 +34,10 @@ namespace cheese::curdle {
         }
     }
 
+    std::size_t ComptimeEnumLiteral::hash() {
+        return std::hash<std::string>{}(value);
+    }
+
     std::string ComptimeEnumLiteral::to_string() {
         std::stringstream ss;
         ss << "." << value;
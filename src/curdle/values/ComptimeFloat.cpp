@@ -11,6 +11,8 @@
 #include "curdle/types/BooleanType.h"
 #include "curdle/values/ComptimeBool.h"
 #include "curdle/types/ComptimeComplexType.h"
+#include "curdle/types/VectorType.h"
+#include "curdle/values/ComptimeVector.h"
 
 namespace cheese::curdle {
     void ComptimeFloat::mark_value() {
@@ -26,6 +28,10 @@ namespace cheese::curdle {
         }
     }
 
+    std::size_t ComptimeFloat::hash() {
+        return std::hash<double>{}(value);
+    }
+
     std::string ComptimeFloat::to_string() {
         return std::to_string(value);
     }
@@ -41,6 +47,9 @@ namespace cheese::curdle {
         if (auto as_comptime_complex = dynamic_cast<ComptimeComplexType *>(target_type); as_comptime_complex) {
             return garbageCollector.gcnew<ComptimeComplex>(value, 0.0, target_type);
         }
+        if (auto as_vector = dynamic_cast<VectorType *>(target_type); as_vector) {
+            return ComptimeVector::splat(this, as_vector, garbageCollector);
+        }
         throw CurdleError{"Cannot cast " + type->to_string() + " to " + target_type->to_string() + " at compile time",
                           error::ErrorCode::InvalidCast};
     }
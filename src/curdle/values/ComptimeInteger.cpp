@@ -16,6 +16,8 @@
 #include "curdle/types/Complex64Type.h"
 #include "curdle/types/BooleanType.h"
 #include "curdle/values/ComptimeBool.h"
+#include "curdle/types/VectorType.h"
+#include "curdle/values/ComptimeVector.h"
 
 namespace cheese::curdle {
     void ComptimeInteger::mark_value() {
@@ -31,6 +33,10 @@ namespace cheese::curdle {
         }
     }
 
+    std::size_t ComptimeInteger::hash() {
+        return value.words.empty() ? 0 : std::hash<std::uint32_t>{}(value.words[0]);
+    }
+
     std::string ComptimeInteger::to_string() {
         return static_cast<std::string>(value);
     }
@@ -78,6 +84,9 @@ namespace cheese::curdle {
         WHEN_TYPE_IS(BooleanType, pBooleanType) {
             return new_value(garbageCollector, new ComptimeBool(value != 0, pBooleanType));
         }
+        WHEN_TYPE_IS(VectorType, pVectorType) {
+            return ComptimeVector::splat(this, pVectorType, garbageCollector);
+        }
         throw CurdleError(
                 "Bad Compile Time Cast: Cannot convert value of type: " + type->to_string() + " to type: " +
                 target_type->to_string(), error::ErrorCode::BadComptimeCast);
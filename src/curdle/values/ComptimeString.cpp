@@ -8,6 +8,7 @@
 #include "curdle/types/ComptimeStringType.h"
 #include "curdle/types/ArrayType.h"
 #include "curdle/types/PointerType.h"
+#include "curdle/types/SliceType.h"
 #include "curdle/curdle.h"
 #include "stringutil.h"
 #include "curdle/types/IntegerType.h"
@@ -26,6 +27,10 @@ namespace cheese::curdle {
         }
     }
 
+    std::size_t ComptimeString::hash() {
+        return std::hash<std::string>{}(value);
+    }
+
     std::string ComptimeString::to_string() {
         return '"' + stringutil::escape(value) + '"';
     }
@@ -47,6 +52,12 @@ namespace cheese::curdle {
                 return garbageCollector.gcnew<ComptimeString>(value, pPointerType);
             }
         }
+        WHEN_TARGET_IS(SliceType, pSliceType) {
+            if (auto subtype = dynamic_cast<IntegerType *>(pSliceType->subtype);
+                    subtype && subtype->size == 8 && !subtype->sign) {
+                return garbageCollector.gcnew<ComptimeString>(value, pSliceType);
+            }
+        }
 #undef WHEN_TARGET_IS
         throw CurdleError{
                 "Bad compile time cast: cannot convert " + type->to_string() + " to " + target_type->to_string(),
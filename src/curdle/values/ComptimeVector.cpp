@@ -0,0 +1,96 @@
+#include "curdle/values/ComptimeVector.h"
+#include "curdle/types/VectorType.h"
+#include "curdle/curdle.h"
+#include "error.h"
+
+namespace cheese::curdle {
+    gcref<ComptimeValue>
+    ComptimeVector::splat(ComptimeValue *scalar, VectorType *type, garbage_collector &garbageCollector) {
+        auto lane = scalar->cast(type->subtype, garbageCollector);
+        // Comptime values are never mutated in place, so every lane can share the one value
+        return garbageCollector.gcnew<ComptimeVector>(type, std::vector<ComptimeValue *>(type->lanes, lane.get()));
+    }
+
+    void ComptimeVector::mark_value() {
+        for (auto value: values) {
+            value->mark();
+        }
+    }
+
+    bool ComptimeVector::is_same_as(ComptimeValue *other) {
+        if (other->type->compare(type) != 0) return false;
+        if (auto as_vector = dynamic_cast<ComptimeVector *>(other); as_vector) {
+            if (as_vector->values.size() != values.size()) return false;
+            for (std::size_t i = 0; i < values.size(); i++) {
+                if (!values[i]->is_same_as(as_vector->values[i])) return false;
+            }
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    std::string ComptimeVector::to_string() {
+        std::string result = type->to_string() + "{";
+        for (std::size_t i = 0; i < values.size(); i++) {
+            result += values[i]->to_string();
+            if (i != values.size() - 1) {
+                result += ',';
+            }
+        }
+        result += '}';
+        return result;
+    }
+
+    gcref<ComptimeValue> ComptimeVector::cast(Type *target_type, garbage_collector &garbageCollector) {
+        if (type->compare(target_type) == 0) return gcref{garbageCollector, this};
+        if (auto as_vector = dynamic_cast<VectorType *>(target_type); as_vector && as_vector->lanes == values.size()) {
+            auto new_values = std::vector<ComptimeValue *>();
+            auto refs = std::vector<gcref<ComptimeValue>>();
+            for (auto value: values) {
+                auto lane = value->cast(as_vector->subtype, garbageCollector);
+                new_values.push_back(lane);
+                refs.push_back(std::move(lane));
+            }
+            return garbageCollector.gcnew<ComptimeVector>(target_type, std::move(new_values));
+        }
+        throw CurdleError{"Cannot cast " + type->to_string() + " to " + target_type->to_string() + " at compile time",
+                          error::ErrorCode::InvalidCast};
+    }
+
+#define LANEWISE(OP) \
+    bool cast_self; \
+    auto peer = binary_peer_lhs(other->type, cast_self, gctx); \
+    if (cast_self) return cast(peer, gctx->gc)->OP(gctx, other); \
+    auto rhs = binary_peer_rhs<ComptimeVector>(other, peer, gctx); \
+    auto new_values = std::vector<ComptimeValue *>(); \
+    auto refs = std::vector<gcref<ComptimeValue>>(); \
+    for (std::size_t i = 0; i < values.size(); i++) { \
+        auto lane = values[i]->OP(gctx, rhs->values[i]); \
+        new_values.push_back(lane); \
+        refs.push_back(std::move(lane)); \
+    } \
+    return gctx->gc.gcnew<ComptimeVector>(peer, std::move(new_values))
+
+    gcref<ComptimeValue> ComptimeVector::op_multiply(cheese::project::GlobalContext *gctx, ComptimeValue *other) {
+        LANEWISE(op_multiply);
+    }
+
+    gcref<ComptimeValue> ComptimeVector::op_divide(cheese::project::GlobalContext *gctx, ComptimeValue *other) {
+        LANEWISE(op_divide);
+    }
+
+    gcref<ComptimeValue> ComptimeVector::op_remainder(cheese::project::GlobalContext *gctx, ComptimeValue *other) {
+        LANEWISE(op_remainder);
+    }
+
+    gcref<ComptimeValue> ComptimeVector::op_add(cheese::project::GlobalContext *gctx, ComptimeValue *other) {
+        LANEWISE(op_add);
+    }
+
+    gcref<ComptimeValue> ComptimeVector::op_subtract(cheese::project::GlobalContext *gctx, ComptimeValue *other) {
+        LANEWISE(op_subtract);
+    }
+
+#undef LANEWISE
+}
@@ -8,7 +8,6 @@
 #include <cstdint>
 #include <sstream>
 #include <iostream>
-#include <fstream>
 #include <lexer/lexer.h>
 namespace cheese::error {
 
@@ -45,103 +44,105 @@ namespace cheese::error {
         return getError(static_cast<std::uint32_t>(code));
     }
 
-    void point_to(Coordinate location) {
-        std::ifstream infile{filenames[location.file_index]};
-        if (!infile)
-            return;
-        std::uint32_t l = 1;
-        for (std::string line; getline(infile,line);) {
-            //At somepoint highlight this;
-            if (l == location.line_number) {
-                configuration::error_output_handler(line);
-                if (line.empty() || line[line.size()-1] != '\n') {
-                    configuration::error_output_handler("\n");
-                }
+    // Diagnostics are assembled into a single buffer and handed to the output handler in one go, colours included
+    class DiagnosticBuffer {
+        std::string buffer;
+    public:
+        void color(io::Color color) {
+            if (configuration::use_escape_sequences) {
+                buffer += io::ESCAPE;
+                buffer += '[';
+                buffer += std::to_string(static_cast<std::uint16_t>(color));
+                buffer += 'm';
             }
-            ++l;
         }
-        if (configuration::use_escape_sequences) {
-            io::setForegroundColor(io::Color::Green);
+
+        void reset() {
+            color(io::Color::Gray);
+            if (configuration::use_escape_sequences) {
+                buffer += io::ESCAPE;
+                buffer += '[';
+                buffer += std::to_string(static_cast<std::uint16_t>(io::Color::Black) + 10);
+                buffer += 'm';
+            }
         }
-        for (int i = 1; i < location.column_number; i++) {
-            configuration::error_output_handler(" ");
+
+        DiagnosticBuffer& operator<<(std::string_view text) {
+            buffer += text;
+            return *this;
         }
-        configuration::error_output_handler("^\n");
-        if (configuration::use_escape_sequences) {
-            io::setForegroundColor(io::Color::Gray);
+
+        void flush() {
+            if (!buffer.empty()) {
+                configuration::error_output_handler(std::move(buffer));
+                buffer.clear();
+            }
         }
+    };
+
+    void point_to(DiagnosticBuffer& out, Coordinate location) {
+        auto line = source_manager.get_line(location);
+        if (!line.has_value())
+            return;
+        //At somepoint highlight this;
+        out << line.value() << "\n";
+        out.color(io::Color::Green);
+        auto column = location.decode().column_number;
+        if (column > 1) {
+            out << std::string(column - 1, ' ');
+        }
+        out << "^\n";
+        out.color(io::Color::Gray);
     }
 
-    void write_module(const char* module) {
-        if (configuration::use_escape_sequences) {
-            io::setForegroundColor(io::Color::Blue);
-        }
-        configuration::error_output_handler("[" + std::string{module} + "] ");
-        if (configuration::use_escape_sequences) {
-            io::setForegroundColor(io::Color::Gray);
-        }
+    void write_module(DiagnosticBuffer& out, const char* module) {
+        out.color(io::Color::Blue);
+        out << "[" << module << "] ";
+        out.color(io::Color::Gray);
     }
 
-    void write_err() {
-        if (configuration::use_escape_sequences) {
-            io::setForegroundColor(io::Color::Red);
-        }
-        configuration::error_output_handler("[ERROR] ");
-        if (configuration::use_escape_sequences) {
-            io::setForegroundColor(io::Color::Gray);
-        }
+    void write_err(DiagnosticBuffer& out) {
+        out.color(io::Color::Red);
+        out << "[ERROR] ";
+        out.color(io::Color::Gray);
     }
 
-    void write_warn() {
-        if (configuration::use_escape_sequences) {
-            io::setForegroundColor(io::Color::Red);
-        }
-        configuration::error_output_handler("[WARN] ");
-        if (configuration::use_escape_sequences) {
-            io::setForegroundColor(io::Color::Gray);
-        }
+    void write_warn(DiagnosticBuffer& out) {
+        out.color(io::Color::Red);
+        out << "[WARN] ";
+        out.color(io::Color::Gray);
     }
 
-    void write_note() {
-        if (configuration::use_escape_sequences) {
-            io::setForegroundColor(io::Color::DarkGray);
-        }
-        configuration::error_output_handler("[NOTE] ");
-        if (configuration::use_escape_sequences) {
-            io::setForegroundColor(io::Color::Gray);
-        }
+    void write_note(DiagnosticBuffer& out) {
+        out.color(io::Color::DarkGray);
+        out << "[NOTE] ";
+        out.color(io::Color::Gray);
     }
 
-    void write_code(ErrorCode code) {
-        if (configuration::use_escape_sequences) {
-            io::setForegroundColor(io::Color::DarkGray);
-        }
-        configuration::error_output_handler("(" + getError(code) +") ");
-        if (configuration::use_escape_sequences) {
-            io::setForegroundColor(io::Color::Gray);
-        }
+    void write_code(DiagnosticBuffer& out, ErrorCode code) {
+        out.color(io::Color::DarkGray);
+        out << "(" << getError(code) << ") ";
+        out.color(io::Color::Gray);
     }
 
-    void write_location(Coordinate location) {
-        if (configuration::use_escape_sequences) {
-            io::setForegroundColor(io::Color::White);
-        }
-        configuration::error_output_handler(location.toString());
-        if (configuration::use_escape_sequences) {
-            io::setForegroundColor(io::Color::Gray);
-        }
-        configuration::error_output_handler(": ");
+    void write_location(DiagnosticBuffer& out, Coordinate location) {
+        out.color(io::Color::White);
+        out << location.toString();
+        out.color(io::Color::Gray);
+        out << ": ";
     }
 
     [[noreturn]] void raise_exiting_error(const char* module, std::string message, Coordinate location, ErrorCode code) {
         if (configuration::log_errors) {
-            write_module(module);
-            write_err();
-            write_code(code);
-            write_location(location);
-            configuration::error_output_handler(message + "\n");
-            point_to(location);
-            io::reset();
+            DiagnosticBuffer out;
+            write_module(out, module);
+            write_err(out);
+            write_code(out, code);
+            write_location(out, location);
+            out << message << "\n";
+            point_to(out, location);
+            out.reset();
+            out.flush();
         }
         throw CompilerError(location, code, message);
     }
@@ -152,13 +153,15 @@ namespace cheese::error {
             return;
         }
         if (configuration::log_errors) {
-            write_module(module);
-            write_err();
-            write_code(code);
-            write_location(location);
-            configuration::error_output_handler(message + "\n");
-            point_to(location);
-            io::setForegroundColor(io::Color::White);
+            DiagnosticBuffer out;
+            write_module(out, module);
+            write_err(out);
+            write_code(out, code);
+            write_location(out, location);
+            out << message << "\n";
+            point_to(out, location);
+            out.color(io::Color::White);
+            out.flush();
         }
     }
 
@@ -168,24 +171,28 @@ namespace cheese::error {
             return;
         }
         if (configuration::log_errors) {
-            write_module(module);
-            write_warn();
-            write_code(code);
-            write_location(location);
-            configuration::error_output_handler(message + "\n");
-            point_to(location);
-        io::setForegroundColor(io::Color::White);
+            DiagnosticBuffer out;
+            write_module(out, module);
+            write_warn(out);
+            write_code(out, code);
+            write_location(out, location);
+            out << message << "\n";
+            point_to(out, location);
+            out.color(io::Color::White);
+            out.flush();
         }
     }
 
     void make_note(const char* module, std::string message, Coordinate location) {
         if (configuration::log_errors) {
-            write_module(module);
-            write_note();
-            write_location(location);
-            configuration::error_output_handler(message + "\n");
-            point_to(location);
-            io::setForegroundColor(io::Color::White);
+            DiagnosticBuffer out;
+            write_module(out, module);
+            write_note(out);
+            write_location(out, location);
+            out << message << "\n";
+            point_to(out, location);
+            out.color(io::Color::White);
+            out.flush();
         }
     }
 }
\ No newline at end of file
@@ -106,11 +106,9 @@ namespace cheese::lexer {
         return std::any_of(builtin_macros.begin(),builtin_macros.end(),[macro](std::string_view str){return str == macro;});
     }
     struct _lexerState {
-        std::string filename;
         std::string_view buffer;
         std::size_t buffer_position=0;
-        std::uint32_t column=1;
-        std::uint32_t line=1;
+        std::uint32_t base_offset=0;
         [[nodiscard]] char peek() const {
             if (buffer_position < buffer.size()) {
                 return buffer[buffer_position];
@@ -119,12 +117,6 @@ namespace cheese::lexer {
             }
         }
         void advance() {
-            if (peek() != '\n') {
-                column++;
-            } else {
-                column = 1;
-                line++;
-            }
             buffer_position++;
         }
 
@@ -133,7 +125,7 @@ namespace cheese::lexer {
         }
 
         Coordinate location() {
-            return Coordinate{line,column, getFileIndex(filename)};
+            return Coordinate{base_offset + static_cast<std::uint32_t>(buffer_position)};
         }
     };
     static inline bool validB(char c) {
@@ -170,8 +162,6 @@ namespace cheese::lexer {
     }
 #define PEEK __state.peek()
 #define ADVANCE __state.advance()
-#define LINE __state.line()
-#define COLUMN __state.column()
 #define POSITION __state.buffer_position
 #define LOCATION __state.location()
 #define VIEW buffer.substr(view_start,view_size)
@@ -179,7 +169,7 @@ namespace cheese::lexer {
 #define SINGLE(type) ADVANCE; view_size++; ADD(type)
 #define END __state.eof()
     std::vector<Token> lex(std::string_view buffer, std::string filename, bool errorInvalid, bool outputComments, bool warnComments) {
-        _lexerState __state = _lexerState{std::move(filename),buffer,0};
+        _lexerState __state = _lexerState{buffer, 0, source_manager.add_source(filename, buffer)};
         std::vector<Token> tokens{};
         std::function<Token(Coordinate,std::size_t)> skipComment = [&](Coordinate start_location, std::size_t view_start) -> Token {
             std::size_t view_size = 2; // '//'
@@ -471,7 +461,8 @@ namespace cheese::lexer {
 
             auto view = VIEW;
             auto opt = getKW(view);
-            return Token{start_location, validIntegerType(view) ? (view[0] == 'u'? TokenType::UnsignedIntType : TokenType::SignedIntType) : opt.value_or(isMacro(view)?TokenType::BuiltinReference:TokenType::Identifier), view};
+            auto ty = validIntegerType(view) ? (view[0] == 'u'? TokenType::UnsignedIntType : TokenType::SignedIntType) : opt.value_or(isMacro(view)?TokenType::BuiltinReference:TokenType::Identifier);
+            return Token{start_location, ty, view, ty == TokenType::Identifier ? Symbol{view} : Symbol{}};
         };
         std::function<Token()> builtin = [&]() -> Token {
             auto start_location = LOCATION;
@@ -840,8 +831,6 @@ namespace cheese::lexer {
 #undef VIEW
 #undef PEEK
 #undef ADVANCE
-#undef LINE
-#undef COLUMN
 #undef END
 #undef POSITION
 #undef LOCATION
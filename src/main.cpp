@@ -17,6 +17,7 @@ std::string usage =
         "   translate   -   translate a program to bacteria\n"
         "   lower       -   lower a program into llvm IR\n"
         "   build       -   compile a program into assembly\n"
+        "   serve       -   keep a build server running, or send builds to one with --send\n"
         "options:\n"
         "   --version   -   print the version and exit\n"
         "   --help      -   print a help string dependant on the tool and exit\n";
@@ -184,6 +184,11 @@ namespace cheese::parser {
         }
     }
 
+    template<>
+    void parser::build_json<Symbol>(nlohmann::json &object, std::string name, const Symbol &value) {
+        build_json(object, name, value.str());
+    }
+
     bool parser::implicit_compare_value(const math::BigInteger &value) {
         return value.zero();
     }
@@ -234,5 +239,74 @@ namespace cheese::parser {
         object[name]=lst;
     }
 
+    void stream_json(util::TreeWriter &writer, const std::string &name, const NodePtr &value) {
+        if (value.get() == nullptr) return;
+        writer.key(name);
+        value->write_json(writer);
+    }
+
+    void stream_json(util::TreeWriter &writer, const std::string &name, const NodeList &value) {
+        if (value.empty()) return;
+        writer.key(name);
+        writer.begin_array();
+        for (auto &n: value) {
+            n->write_json(writer);
+        }
+        writer.end_array();
+    }
 
-}
\ No newline at end of file
+    void stream_json(util::TreeWriter &writer, const std::string &name, const FlagSet &value) {
+        if (implicit_compare_value(value)) return;
+        writer.key(name);
+        writer.begin_array();
+        if (value.inlin) {
+            writer.value("inline");
+        }
+        if (value.exter) {
+            writer.value("extern");
+        }
+        if (value.exp) {
+            writer.value("export");
+        }
+        if (value.comptime) {
+            writer.value("comptime");
+        }
+        if (value.pub) {
+            writer.value("public");
+        }
+        if (value.priv) {
+            writer.value("private");
+        }
+        if (value.mut) {
+            writer.value("mutable");
+        }
+        if (value.entry) {
+            writer.value("entry");
+        }
+        writer.end_array();
+    }
+
+    void stream_json(util::TreeWriter &writer, const std::string &name, const math::BigInteger &value) {
+        if (implicit_compare_value(value)) return;
+        writer.key(name);
+        if (value.words.size() > 1) {
+            writer.value(static_cast<std::string>(value));
+        } else {
+            writer.value(static_cast<std::int64_t>(value));
+        }
+    }
+
+    void stream_json(util::TreeWriter &writer, const std::string &name, const Symbol &value) {
+        stream_json(writer, name, value.str());
+    }
+
+    void stream_json(util::TreeWriter &writer, const std::string &name, const NodeDict &value) {
+        if (implicit_compare_value(value)) return;
+        writer.key(name);
+        writer.begin_object();
+        for (const auto &kv: value) {
+            stream_json(writer, kv.first, kv.second);
+        }
+        writer.end_object();
+    }
+}
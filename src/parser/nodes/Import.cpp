@@ -21,4 +21,8 @@ namespace cheese::parser::nodes {
                 "name"
         }, path, name);
     }
-}
\ No newline at end of file
+
+    void Import::write_json(util::TreeWriter &writer) const {
+        stream_json_node(writer, "import", {"path", "name"}, path, name);
+    }
+}
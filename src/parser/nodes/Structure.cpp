@@ -44,5 +44,8 @@ namespace cheese::parser::nodes {
 
 
     }
-}
 
+    void Structure::write_json(util::TreeWriter &writer) const {
+        stream_json_node(writer, "struct", {"tuple", "interfaces", "children"}, is_tuple, interfaces, children);
+    }
+}
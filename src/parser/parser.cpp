@@ -2385,7 +2385,7 @@ namespace cheese::parser {
             }
             case Identifier: {
                 state.eatAny();
-                return (new nodes::ValueReference(location, static_cast<std::string>(front.value)))->get();
+                return (new nodes::ValueReference(location, front.symbol))->get();
             }
             case BuiltinReference: {
                 state.eatAny();
@@ -2610,7 +2610,7 @@ namespace cheese::parser {
         }
         front = state.peek_skip_nl();
         if (front.ty == Identifier || front.ty == Underscore) {
-            index = (new nodes::ValueReference(front.location,static_cast<std::string>(front.value)))->get();
+            index = (new nodes::ValueReference(front.location,Symbol{front.value}))->get();
             state.eatAny();
         } else if (front.ty != Colon) {
             index = state.unexpected(front, "an identifier or '_'",error::ErrorCode::ExpectedName);
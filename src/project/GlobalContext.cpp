@@ -4,6 +4,14 @@
 #include "project/GlobalContext.h"
 #include <algorithm>
 #include "curdle/curdle.h"
+#include "curdle/types/ArrayType.h"
+#include "curdle/types/PointerType.h"
+#include "curdle/types/ReferenceType.h"
+#include "curdle/types/SliceType.h"
+#include "curdle/types/VectorType.h"
+#include "curdle/types/FunctionPointerType.h"
+#include "curdle/types/IntegerType.h"
+#include "curdle/types/ComposedFunctionType.h"
 #include <fstream>
 #include <sstream>
 #include <string_view>
@@ -20,9 +28,38 @@ namespace cheese::project {
         for (auto &imp: imports) {
             imp.second->mark();
         }
-        for (auto &object: cached_objects) {
-            object.second->mark();
+        for (auto &type: singleton_types) {
+            type.second->mark();
         }
+        for (auto type: integer_types) {
+            if (type != nullptr) type->mark();
+        }
+        for (auto &type: composed_function_types) {
+            type.second->mark();
+        }
+        for (auto &type: array_types) {
+            type.second->mark();
+        }
+        for (auto &type: pointer_types) {
+            type.second->mark();
+        }
+        for (auto &type: reference_types) {
+            type.second->mark();
+        }
+        for (auto &type: slice_types) {
+            type.second->mark();
+        }
+        for (auto &type: vector_types) {
+            type.second->mark();
+        }
+        for (auto &type: function_pointer_types) {
+            type.second->mark();
+        }
+    }
+
+    parser::NodePtr GlobalContext::parse_import(const fs::path &path) {
+        read_files.insert(path);
+        return parse_file(path, parse_cache);
     }
 
     Structure *GlobalContext::import_structure(Coordinate location, std::string path, fs::path dir,
@@ -37,13 +74,7 @@ namespace cheese::project {
         }
         if (fs::exists(local_import)) {
             // Now we import this file :)
-            std::ifstream t(local_import);
-            std::stringstream buffer;
-            buffer << t.rdbuf();
-            t.close();
-            std::string sv = buffer.str();
-            auto lexed = lexer::lex(sv, local_import.string());
-            auto parsed = parser::parse(lexed);
+            auto parsed = parse_import(local_import);
             auto ctx = gc.gcnew<ComptimeContext>(this, local_import, pdir);
             ctx->push_structure_name(path);
             auto structure = translate_structure(ctx, dynamic_cast<parser::nodes::Structure *>(parsed.get()));
@@ -59,13 +90,7 @@ namespace cheese::project {
         }
 
         if (fs::exists(local_library)) {
-            std::ifstream t(local_library);
-            std::stringstream buffer;
-            buffer << t.rdbuf();
-            t.close();
-            std::string sv = buffer.str();
-            auto lexed = lexer::lex(sv, local_library.string());
-            auto parsed = parser::parse(lexed);
+            auto parsed = parse_import(local_library);
             auto ctx = gc.gcnew<ComptimeContext>(this, local_import, local_library.parent_path());
             ctx->push_structure_name(path);
             auto structure = translate_structure(ctx, dynamic_cast<parser::nodes::Structure *>(parsed.get()));
@@ -82,13 +107,7 @@ namespace cheese::project {
 
             if (fs::exists(lib_import)) {
                 // Now we import this file :)
-                std::ifstream t(lib_import);
-                std::stringstream buffer;
-                buffer << t.rdbuf();
-                t.close();
-                std::string sv = buffer.str();
-                auto lexed = lexer::lex(sv, lib_import.string());
-                auto parsed = parser::parse(lexed);
+                auto parsed = parse_import(lib_import);
                 auto ctx = gc.gcnew<ComptimeContext>(this, lib_import, lib_import.parent_path());
                 ctx->push_structure_name(path);
                 auto structure = translate_structure(ctx, dynamic_cast<parser::nodes::Structure *>(parsed.get()));
@@ -99,13 +118,7 @@ namespace cheese::project {
 
             auto lib_library = fs::absolute(l / path / "lib.chs");
             if (fs::exists(lib_library)) {
-                std::ifstream t(lib_library);
-                std::stringstream buffer;
-                buffer << t.rdbuf();
-                t.close();
-                std::string sv = buffer.str();
-                auto lexed = lexer::lex(sv, lib_library.string());
-                auto parsed = parser::parse(lexed);
+                auto parsed = parse_import(lib_library);
                 auto ctx = gc.gcnew<ComptimeContext>(this, local_import, lib_library.parent_path());
                 ctx->push_structure_name(path);
                 auto structure = translate_structure(ctx, dynamic_cast<parser::nodes::Structure *>(parsed.get()));
@@ -140,13 +153,4 @@ namespace cheese::project {
         all_struct_names.insert(struct_name);
         return struct_name;
     }
-
-    bool GlobalContext::try_get_cached_object(std::string key, managed_object *&out_value) {
-        out_value = nullptr;
-        if (cached_objects.contains(key)) {
-            out_value = cached_objects[key];
-            return true;
-        }
-        return false;
-    }
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "project/ParseCache.h"
+#include "configuration.h"
+#include "Coordinate.h"
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace cheese::project {
+    ParseCache::Stamp ParseCache::Stamp::of(const fs::path &path) {
+        return Stamp{fs::last_write_time(path), fs::file_size(path)};
+    }
+
+    ParseCache::Stamp ParseCache::Stamp::of(const fs::path &path, std::error_code &ec) {
+        auto write_time = fs::last_write_time(path, ec);
+        if (ec) return {};
+        auto size = fs::file_size(path, ec);
+        if (ec) return {};
+        return Stamp{write_time, size};
+    }
+
+    static std::vector<lexer::Token> lex_file(const fs::path &path) {
+        std::ifstream t(path);
+        std::stringstream buffer;
+        buffer << t.rdbuf();
+        t.close();
+        std::string sv = buffer.str();
+        return lexer::lex(sv, path.string());
+    }
+
+    parser::NodePtr ParseCache::parse(const fs::path &path) {
+        auto key = fs::absolute(path);
+        auto stamp = Stamp::of(key);
+        auto it = entries.find(key);
+        if (it != entries.end() && it->second.stamp == stamp) {
+            if (!it->second.diagnostics.empty()) configuration::error_output_handler(it->second.diagnostics);
+            return it->second.tree;
+        }
+        std::string diagnostics;
+        auto previous_handler = configuration::error_output_handler;
+        configuration::error_output_handler = [&diagnostics, &previous_handler](std::string message) {
+            diagnostics += message;
+            previous_handler(std::move(message));
+        };
+        Entry entry{stamp};
+        try {
+            auto lexed = lex_file(path);
+            entry.source_offset = lexed.back().location.offset; // The EoF token is always there
+            entry.tree = parser::parse(lexed);
+        } catch (...) {
+            configuration::error_output_handler = previous_handler;
+            throw;
+        }
+        configuration::error_output_handler = previous_handler;
+        entry.diagnostics = std::move(diagnostics);
+        if (it != entries.end()) {
+            source_manager.release_source(it->second.source_offset);
+            it->second = std::move(entry);
+        } else {
+            it = entries.emplace(key, std::move(entry)).first;
+        }
+        return it->second.tree;
+    }
+
+    const ParseCache::Stamp &ParseCache::get_stamp(const fs::path &path) const {
+        return entries.at(fs::absolute(path)).stamp;
+    }
+
+    void ParseCache::start_generation() {
+        if (source_manager.used_offsets() < std::numeric_limits<std::uint32_t>::max() / 2) return;
+        entries.clear();
+        source_manager.reset();
+    }
+
+    parser::NodePtr parse_file(const fs::path &path, ParseCache *cache) {
+        if (cache != nullptr) return cache->parse(path);
+        auto lexed = lex_file(path);
+        return parser::parse(lexed);
+    }
+}
@@ -12,8 +12,17 @@
 #include "parser/Node.h"
 #include "parser/parser.h"
 #include "curdle/curdle.h"
+#include "curdle/types/Structure.h"
+#include "curdle/values/ComptimeArray.h"
+#include "curdle/values/ComptimeBool.h"
 #include "util/json_template.h"
+#include "util/JsonWriter.h"
+#include "util/BinaryTree.h"
+#include "bacteria/BacteriaPass.h"
+#include "bacteria/nodes/receiver_nodes.h"
+#include "configuration.h"
 #include <iostream>
+#include <llvm/Support/raw_ostream.h>
 #ifndef CHEESE_NO_SELF_TESTS
 namespace cheese::tests::curdle_tests {
     struct TempFile {
@@ -26,6 +35,68 @@ namespace cheese::tests::curdle_tests {
             std::filesystem::remove(name);
         }
     };
+    // A test can have a 4th element of options, which set the configuration for only that test
+    // {"passes": run the default passes before comparing, "ssa": bool, "release": bool, "bounds_checks": "always"/"debug"/"never",
+    //  "llvm_contains": [strings the lowered module must contain], "llvm_excludes": [strings it must not contain],
+    //  "triple": the target to lower for, instead of the host}
+    // The expected bacteria can be null when a test only checks the lowered module
+    struct ConfigurationOverride {
+        configuration::ReleaseMode release_mode = configuration::release_mode;
+        configuration::BoundsChecks bounds_checks = configuration::bounds_checks;
+        bool ssa_lowering = configuration::ssa_lowering;
+        explicit ConfigurationOverride(const nlohmann::json& options) {
+            if (options.contains("release")) {
+                configuration::release_mode = options["release"].get<bool>() ? configuration::ReleaseMode::Release : configuration::ReleaseMode::Debug;
+            }
+            if (options.contains("bounds_checks")) {
+                auto mode = options["bounds_checks"].get<std::string>();
+                configuration::bounds_checks = mode == "always" ? configuration::BoundsChecks::Always : mode == "never" ? configuration::BoundsChecks::Never : configuration::BoundsChecks::Debug;
+            }
+            if (options.contains("ssa")) {
+                configuration::ssa_lowering = options["ssa"].get<bool>();
+            }
+        }
+        ~ConfigurationOverride() {
+            configuration::release_mode = release_mode;
+            configuration::bounds_checks = bounds_checks;
+            configuration::ssa_lowering = ssa_lowering;
+        }
+    };
+    // Curdles a source file and hands out its top level compile time variables, so tests can look at the values
+    struct ComptimeSource {
+        TempFile file;
+        std::shared_ptr<parser::Node> root;
+        cheese::project::Machine machine{};
+        cheese::memory::garbage_collection::garbage_collector gc{64};
+        cheese::project::GlobalContext *ctx{nullptr};
+
+        explicit ComptimeSource(const std::string &source) : file{"./__testing_temp_file__", source} {
+            auto tokens = lexer::lex(source, file.name);
+            root = parser::parse(tokens);
+            auto project = cheese::project::Project{
+                "./testenv_src/",
+                {"./testenv_imports/"},
+                file.name,
+                root,
+                cheese::project::ProjectType::Application
+            };
+            auto context = gc.gcnew<cheese::project::GlobalContext>(project, gc, machine);
+            ctx = context.get();
+            gc.add_root_object(ctx);
+            cheese::curdle::curdle(ctx);
+        }
+
+        curdle::ComptimeValue *get(const std::string &name) {
+            ctx->root_structure->resolve_by_name(name);
+            auto &variables = ctx->root_structure->comptime_variables;
+            auto found = variables.find(name);
+            return found == variables.end() ? nullptr : found->second.value;
+        }
+
+        curdle::ComptimeArray *get_array(const std::string &name) {
+            return dynamic_cast<curdle::ComptimeArray *>(get(name));
+        }
+    };
     TEST_SECTION("curdle", 3)
         TEST_SUBSECTION("generated tests")
             nlohmann::json generated_tests_json;
@@ -44,6 +115,8 @@ namespace cheese::tests::curdle_tests {
                                 configuration::error_output_handler = [__nesting](std::string msg) {
                                     test_output_message(__nesting,msg);
                                 };
+                                auto options = test.size() > 3 ? test[3] : nlohmann::json::object();
+                                ConfigurationOverride configuration_override{options};
                                 std::vector<lexer::Token> tokens;
                                 std::string fname;
                                 std::string str;
@@ -70,12 +143,41 @@ namespace cheese::tests::curdle_tests {
                                     root,
                                     cheese::project::ProjectType::Application
                                 };
-                                auto machine = cheese::project::Machine{};
+                                auto machine = options.contains("triple") ? cheese::project::Machine{options["triple"].get<std::string>()} : cheese::project::Machine{};
                                 auto gc = cheese::memory::garbage_collection::garbage_collector{64};
                                 auto ctx = gc.gcnew<cheese::project::GlobalContext>(project, gc, machine);
                                 gc.add_root_object(ctx);
                                 TEST_TRY(bact = cheese::curdle::curdle(ctx));
-                                TEST_ASSERT_MESSAGE(bact->compare_json(test[2]),"got:\n" + bact->as_json().dump(1) + "\nin text:\n" + bact->get_textual_representation() + "\nexpected:\n" + test[2].dump(1) + "\n");
+                                auto program = (bacteria::nodes::BacteriaProgram*)bact.get();
+                                if (options.value("passes", false)) {
+                                    TEST_TRY(bacteria::run_default_passes(program));
+                                }
+                                if (!test[2].is_null()) TEST_ASSERT_CONTINUE_MESSAGE(bact->compare_json(test[2]),"got:\n" + bact->as_json().dump(1) + "\nin text:\n" + bact->get_textual_representation() + "\nexpected:\n" + test[2].dump(1) + "\n");
+                                std::stringstream streamed;
+                                util::JsonWriter writer{streamed};
+                                bact->write_json(writer);
+                                TEST_ASSERT_CONTINUE_MESSAGE(nlohmann::json::parse(streamed.str()) == bact->as_json(),"streamed json differs from as_json:\n" + streamed.str() + "\n");
+                                std::stringstream binary;
+                                util::BinaryTreeWriter binary_writer{binary};
+                                bact->write_json(binary_writer);
+                                binary_writer.finish();
+                                auto loaded = util::BinaryTree{binary.str()}.root().to_json();
+                                TEST_ASSERT_CONTINUE_MESSAGE(loaded == bact->as_json(),"binary tree differs from as_json:\n" + loaded.dump(1) + "\n");
+                                if (options.contains("llvm_contains") || options.contains("llvm_excludes")) {
+                                    std::unique_ptr<llvm::Module> mod;
+                                    TEST_TRY(mod = program->lower_into_module(ctx));
+                                    std::string ir;
+                                    llvm::raw_string_ostream ir_stream{ir};
+                                    mod->print(ir_stream, nullptr);
+                                    ir_stream.flush();
+                                    for (const auto& needle : options.value("llvm_contains", nlohmann::json::array())) {
+                                        TEST_ASSERT_CONTINUE_MESSAGE(ir.find(needle.get<std::string>()) != std::string::npos,"expected the module to contain " + needle.dump() + ":\n" + ir);
+                                    }
+                                    for (const auto& needle : options.value("llvm_excludes", nlohmann::json::array())) {
+                                        TEST_ASSERT_CONTINUE_MESSAGE(ir.find(needle.get<std::string>()) == std::string::npos,"expected the module not to contain " + needle.dump() + ":\n" + ir);
+                                    }
+                                }
+                                TEST_PASS;
                             TEST_GEN_END
                         } catch (const std::exception& e) {
                             throw;
@@ -84,6 +186,57 @@ namespace cheese::tests::curdle_tests {
                 }
             TEST_END
         TEST_END
+        TEST_SUBSECTION("comptime arrays")
+            TEST_CASE("a literal with a known array type is packed as it is built") {
+                std::unique_ptr<ComptimeSource> source;
+                TEST_TRY(source = std::make_unique<ComptimeSource>(
+                        "let table: [4]u8 comptime = .[1, 2, 3, 250]\nfn main => void entry\n{\n}"));
+                curdle::ComptimeArray *table;
+                TEST_TRY(table = source->get_array("table"));
+                TEST_ASSERT_MESSAGE(table && table->is_packed() && table->packed_data.size() == 4 &&
+                                    table->integer_at(3) == 250,
+                                    table ? table->to_string() + '\n' : "table is not an array\n");
+            }
+            TEST_CASE("a tuple of comptime_int fields is packed without a cast") {
+                std::unique_ptr<ComptimeSource> source;
+                TEST_TRY(source = std::make_unique<ComptimeSource>(
+                        "let plain comptime = .(1, 2, -3)\nfn main => void entry\n{\n}"));
+                curdle::ComptimeArray *plain;
+                TEST_TRY(plain = source->get_array("plain"));
+                TEST_ASSERT_MESSAGE(plain && plain->is_packed() && plain->size() == 3 && plain->integer_at(2) == -3,
+                                    plain ? plain->to_string() + '\n' : "plain is not an array\n");
+            }
+            TEST_CASE("elements of different types fall back to boxed values") {
+                std::unique_ptr<ComptimeSource> source;
+                TEST_TRY(source = std::make_unique<ComptimeSource>(
+                        "let mixed comptime = .(1, 2.5, 3)\nfn main => void entry\n{\n}"));
+                curdle::ComptimeArray *mixed;
+                TEST_TRY(mixed = source->get_array("mixed"));
+                TEST_ASSERT_MESSAGE(mixed && !mixed->is_packed() && mixed->values.size() == 3,
+                                    mixed ? mixed->to_string() + '\n' : "mixed is not an array\n");
+            }
+            TEST_CASE("casting to a wider element type and back keeps every value") {
+                std::unique_ptr<ComptimeSource> source;
+                TEST_TRY(source = std::make_unique<ComptimeSource>(
+                        "let narrow: [4]u16 comptime = .[1, 2, 3, 65535]\n"
+                        "let wide comptime = narrow @ [4]i32\n"
+                        "let back comptime = wide @ [4]u16\n"
+                        "let same comptime = back == narrow\n"
+                        "fn main => void entry\n{\n}"));
+                curdle::ComptimeArray *narrow, *wide, *back;
+                curdle::ComptimeBool *same;
+                TEST_TRY(narrow = source->get_array("narrow"));
+                TEST_TRY(wide = source->get_array("wide"));
+                TEST_TRY(back = source->get_array("back"));
+                TEST_TRY(same = dynamic_cast<curdle::ComptimeBool *>(source->get("same")));
+                TEST_ASSERT_CONTINUE_MESSAGE(same && same->value, "back == narrow was not true\n");
+                TEST_ASSERT_CONTINUE_MESSAGE(wide && wide->is_packed() && wide->packed_data.size() == 16 &&
+                                             wide->integer_at(3) == 65535,
+                                             wide ? wide->to_string() + '\n' : "wide is not an array\n");
+                TEST_ASSERT_MESSAGE(narrow && back && back->is_packed() && back->is_same_as(narrow),
+                                    back ? back->to_string() + '\n' : "back is not an array\n");
+            }
+        TEST_END
     TEST_END
 }
 #endif
\ No newline at end of file
@@ -95,11 +95,12 @@ namespace cheese::tests::lexer_tests {
                     if (token.ty == cheese::lexer::TokenType::EoF) {
                         break;
                     }
+                    auto decoded = token.location.decode();
                     std::string loc_error_message  = "token #" + std::to_string(i+1) + "'s is " +
-                            std::to_string(token.location.line_number) + ':' +
-                            std::to_string(token.location.column_number) + ", expected: " +
+                            std::to_string(decoded.line_number) + ':' +
+                            std::to_string(decoded.column_number) + ", expected: " +
                             std::to_string(locations[i].first) + ':' + std::to_string(locations[i].second);
-                    TEST_ASSERT_CONTINUE_MESSAGE((token.location.line_number = locations[i].first) && (token.location.column_number == locations[i].second), loc_error_message);
+                    TEST_ASSERT_CONTINUE_MESSAGE((decoded.line_number == locations[i].first) && (decoded.column_number == locations[i].second), loc_error_message);
                     ++i;
                 }
                 TEST_PASS;
@@ -6,6 +6,8 @@
 #include "parser/parser.h"
 #include "lexer/lexer.h"
 #include "compression/base64.h"
+#include "util/JsonWriter.h"
+#include "util/BinaryTree.h"
 #include "error.h"
 #include "fstream"
 #include "sstream"
@@ -51,6 +53,16 @@ namespace cheese::tests::parser_tests {
                             TEST_TRY(root = parser::parse(tokens));
                             auto fail_message = "got:\n" + root->as_json().dump(1) + "\nexpected:\n" + test[2].dump(1) + "\n";
                             TEST_ASSERT_MESSAGE(root->compare_json(test[2]),fail_message);
+                            std::stringstream streamed;
+                            util::JsonWriter writer{streamed};
+                            root->write_json(writer);
+                            TEST_ASSERT_MESSAGE(nlohmann::json::parse(streamed.str()) == root->as_json(),"streamed json differs from as_json:\n" + streamed.str() + "\n");
+                            std::stringstream binary;
+                            util::BinaryTreeWriter binary_writer{binary};
+                            root->write_json(binary_writer);
+                            binary_writer.finish();
+                            auto loaded = util::BinaryTree{binary.str()}.root().to_json();
+                            TEST_ASSERT_MESSAGE(loaded == root->as_json(),"binary tree differs from as_json:\n" + loaded.dump(1) + "\n");
                         TEST_GEN_END
                     }
                 }
@@ -0,0 +1,136 @@
+#ifndef CHEESE_NO_SELF_TESTS
+#ifndef WIN32
+#include "tests/tests.h"
+#include "tools/serve.h"
+#include "configuration.h"
+#include <chrono>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+namespace cheese::tests::serve {
+    namespace fs = std::filesystem;
+
+    static void write_file(const fs::path &path, const std::string &contents) {
+        std::ofstream out(path, std::ios::trunc);
+        out << contents;
+    }
+
+    // The server creates its socket on another thread, so keep knocking until it answers
+    static nlohmann::json send_when_ready(const fs::path &socket_path, const std::vector<std::string> &args) {
+        for (int attempt = 0;; attempt++) {
+            try {
+                return tools::send_request(socket_path, args);
+            } catch (std::runtime_error &) {
+                if (attempt >= 100) throw;
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+        }
+    }
+
+    // Runs a server for as long as it takes to send it each request, returning the responses
+    static std::vector<nlohmann::json> serve_requests(const fs::path &socket_path,
+                                                      const std::vector<std::vector<std::string>> &requests,
+                                                      std::string &failure) {
+        auto die_on_first_error = configuration::die_on_first_error;
+        std::thread server{[&socket_path] {
+            try {
+                tools::run_server(socket_path);
+            } catch (std::exception &) {}
+        }};
+        std::vector<nlohmann::json> responses;
+        try {
+            for (auto &request: requests) {
+                responses.push_back(send_when_ready(socket_path, request));
+            }
+        } catch (std::exception &e) {
+            failure = e.what();
+        }
+        try {
+            send_when_ready(socket_path, {"shutdown"});
+        } catch (std::exception &) {}
+        server.join();
+        configuration::die_on_first_error = die_on_first_error;
+        return responses;
+    }
+
+    TEST_SECTION("serve", 4)
+        TEST_SUBSECTION("build server")
+            TEST_CASE("editing an input invalidates the cached build") {
+                auto dir = fs::temp_directory_path() / ("cheese_serve_test_" + std::to_string(::getpid()));
+                fs::create_directories(dir);
+                auto socket_path = dir / "cheese.sock";
+                auto source = dir / "main.chs";
+                write_file(source, "fn main => void entry\n{let x: i64=1+1}");
+                auto die_on_first_error = configuration::die_on_first_error;
+                std::thread server{[&socket_path] {
+                    try {
+                        tools::run_server(socket_path);
+                    } catch (std::exception &) {}
+                }};
+                std::vector<std::string> build = {"build", source.string(), "-o", (dir / "main.bact").string(),
+                                                  "--emit", "bacteria"};
+                std::vector<nlohmann::json> responses;
+                std::string failure;
+                try {
+                    responses.push_back(send_when_ready(socket_path, build));
+                    responses.push_back(tools::send_request(socket_path, build));
+                    // A different length, so the edit is seen even if the write lands within the clock's resolution
+                    write_file(source, "fn main => void entry\n{let x: i64=1+10}");
+                    responses.push_back(tools::send_request(socket_path, build));
+                } catch (std::exception &e) {
+                    failure = e.what();
+                }
+                try {
+                    tools::send_request(socket_path, {"shutdown"});
+                } catch (std::exception &) {}
+                server.join();
+                configuration::die_on_first_error = die_on_first_error;
+                fs::remove_all(dir);
+                TEST_ASSERT_CONTINUE_MESSAGE(failure.empty(), failure + '\n');
+                std::string dumped;
+                for (auto &response: responses) dumped += response.dump() + '\n';
+                TEST_ASSERT_MESSAGE(responses.size() == 3 &&
+                                    responses[0].value("status", 1) == 0 && !responses[0].value("cached", true) &&
+                                    responses[1].value("status", 1) == 0 && responses[1].value("cached", false) &&
+                                    responses[2].value("status", 1) == 0 && !responses[2].value("cached", true),
+                                    dumped);
+            }
+            TEST_CASE("finished builds outlive the server") {
+                auto dir = fs::temp_directory_path() / ("cheese_serve_test_" + std::to_string(::getpid()));
+                fs::create_directories(dir);
+                auto socket_path = dir / "cheese.sock";
+                auto source = dir / "main.chs";
+                write_file(source, "fn main => void entry\n{let x: i64=1+1}");
+                std::vector<std::string> build = {"build", source.string(), "-o", (dir / "main.bact").string(),
+                                                  "--emit", "bacteria"};
+                std::string failure;
+                auto first = serve_requests(socket_path, {build}, failure);
+                auto second = serve_requests(socket_path, {build}, failure);
+                fs::remove_all(dir);
+                TEST_ASSERT_CONTINUE_MESSAGE(failure.empty(), failure + '\n');
+                TEST_ASSERT_MESSAGE(first.size() == 1 && !first[0].value("cached", true) &&
+                                    second.size() == 1 && second[0].value("cached", false),
+                                    (first.empty() ? "" : first[0].dump()) + '\n' +
+                                    (second.empty() ? "" : second[0].dump()) + '\n');
+            }
+            TEST_CASE("a file that isn't a socket is never replaced") {
+                auto dir = fs::temp_directory_path() / ("cheese_serve_test_" + std::to_string(::getpid()));
+                fs::create_directories(dir);
+                auto socket_path = dir / "main.chs";
+                write_file(socket_path, "fn main => void entry\n{}");
+                bool refused = false;
+                try {
+                    tools::run_server(socket_path);
+                } catch (std::runtime_error &) {
+                    refused = true;
+                }
+                auto kept = fs::is_regular_file(socket_path);
+                fs::remove_all(dir);
+                TEST_ASSERT(refused && kept);
+            }
+        TEST_END
+    TEST_END
+}
+#endif
+#endif
@@ -4,78 +4,67 @@
 #include "tools/build.h"
 #include "configuration.h"
 #include <iostream>
-#include "lexer/lexer.h"
-#include <fstream>
-#include <sstream>
-#include <string_view>
 #include "parser/parser.h"
 #include "curdle/curdle.h"
 #include "project/Project.h"
 #include "project/Machine.h"
 #include "bacteria/nodes/receiver_nodes.h"
+#include "bacteria/BacteriaPass.h"
+#include "tools/emit.h"
 #include "tools/tools.h"
-#include "llvm/IR/LegacyPassManager.h"
 #include <filesystem>
-#include <llvm/Support/FileSystem.h>
 
 namespace cheese::tools {
     namespace fs = std::filesystem;
 
-    void output_module(std::string out, llvm::Module &mod, llvm::TargetMachine *machine) {
-        llvm::legacy::PassManager pass;
-        auto fileType = llvm::CodeGenFileType::CGFT_ObjectFile;
-        std::error_code errorCode;
-        llvm::raw_fd_ostream dest(out, errorCode, llvm::sys::fs::OF_None);
-        if (errorCode) {
-            llvm::errs() << "Could not open file: " << out << ": " << errorCode.message();
-        }
-        if (machine->addPassesToEmitFile(pass, dest, nullptr, fileType)) {
-            llvm::errs() << "TargetMachine can't emit a file of this type";
+    void add_build_arguments(argparse::ArgumentParser &parser) {
+        parser.add_argument("--output", "-o").help(
+                "The output file for the object").default_value(
+                "translated.o").nargs(1);
+        parser.add_argument("--library", "-l").help(
+                "The library folders to test translation from").default_value<std::vector<fs::path>>({}).append();
+        parser.add_argument("file").help("the file to parse");
+        add_machine_arguments(parser);
+        add_emit_arguments(parser, "obj");
+    }
+
+    BuildRecord run_build(argparse::ArgumentParser &parser, curdle::Machine &machine,
+                          project::ParseCache *parse_cache) {
+        auto file = parser.get("file");
+        auto out = parser.get("--output");
+        auto kinds = get_emit_kinds(parser);
+        configuration::die_on_first_error = false;
+        auto parsed = project::parse_file(file, parse_cache);
+        auto project = cheese::project::Project{
+                fs::path{file}.parent_path(),
+                parser.get<std::vector<fs::path>>("--library"),
+                fs::path{file},
+                parsed,
+                project::ProjectType::Application
+        };
+        auto gc = cheese::memory::garbage_collection::garbage_collector{64};
+        auto ctx = gc.gcnew<cheese::project::GlobalContext>(project, gc, machine);
+        ctx->parse_cache = parse_cache;
+        auto node = curdle::curdle(ctx);
+        auto prog = (bacteria::nodes::BacteriaProgram *) node.get();
+        bacteria::run_default_passes(prog);
+        emit(out, kinds, prog, ctx, machine.machine);
+        BuildRecord record{ctx->read_files};
+        record.inputs.insert(fs::absolute(file));
+        for (auto kind: kinds) {
+            record.outputs.push_back(get_emit_path(out, kind, kinds.size() == 1));
         }
-        pass.run(mod);
-        dest.flush();
-        dest.close();
+        return record;
     }
 
     int build(std::vector<std::string> args) {
         auto program = get_parser("translate");
-        program.add_argument("--output", "-o").help(
-                "The output file for the object").default_value(
-                "translated.o").nargs(1);
-        program.add_argument("--library", "-l").help(
-                "The library folders to test translation from").default_value<std::vector<fs::path>>({}).append();
-        program.add_argument("file").help("the file to parse");
+        add_build_arguments(program);
         program.parse_args(args);
         process_common_arguments(program);
         try {
-            auto file = program.get("file");
-            auto out = program.get("--output");
-            configuration::die_on_first_error = false;
-            std::ifstream t(file);
-            std::stringstream buffer;
-            buffer << t.rdbuf();
-            t.close();
-            std::string sv = buffer.str();
-            auto lexed = lexer::lex(sv, file);
-            auto parsed = parser::parse(lexed);
-            auto project = cheese::project::Project{
-                    fs::path{file}.parent_path(),
-                    program.get<std::vector<fs::path>>("--library"),
-                    fs::path{file},
-                    parsed,
-                    project::ProjectType::Application
-            };
-            auto machine = cheese::project::Machine{};
-            auto gc = cheese::memory::garbage_collection::garbage_collector{64};
-            auto ctx = gc.gcnew<cheese::project::GlobalContext>(project, gc, machine);
-            auto node = curdle::curdle(ctx);
-            std::cout << "Bacteria:\n";
-            std::cout << node->get_textual_representation();
-            auto prog = (bacteria::nodes::BacteriaProgram *) node.get();
-            auto mod = prog->lower_into_module(ctx);
-            std::cout << "LLVM:\n";
-            mod->dump();
-            output_module(out, *mod, machine.machine);
+            auto machine = get_machine(program);
+            run_build(program, machine);
             return 0;
         } catch (std::exception &e) {
             std::cout << e.what() << '\n';
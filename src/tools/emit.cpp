@@ -0,0 +1,161 @@
+#include "tools/emit.h"
+#include "util/JsonWriter.h"
+#include "util/BinaryTree.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+
+namespace cheese::tools {
+    namespace fs = std::filesystem;
+
+    static const std::vector<std::pair<std::string, EmitKind>> emit_names{
+            {"bacteria",      EmitKind::Bacteria},
+            {"bacteria-json", EmitKind::BacteriaJson},
+            {"bacteria-bin",  EmitKind::BacteriaBinary},
+            {"llvm",          EmitKind::LLVM},
+            {"bc",            EmitKind::Bitcode},
+            {"asm",           EmitKind::Assembly},
+            {"obj",           EmitKind::Object},
+    };
+
+    void add_emit_arguments(argparse::ArgumentParser &parser, const std::string &default_emit) {
+        parser.add_argument("--emit")
+                .help("a comma separated list of what to write out: bacteria, bacteria-json, bacteria-bin, llvm, bc, asm, or obj")
+                .default_value(default_emit)
+                .nargs(1);
+    }
+
+    std::vector<EmitKind> get_emit_kinds(argparse::ArgumentParser &parser) {
+        std::vector<EmitKind> kinds;
+        std::stringstream emit{parser.get("--emit")};
+        std::string name;
+        while (std::getline(emit, name, ',')) {
+            if (name.empty()) continue;
+            auto it = std::find_if(emit_names.begin(), emit_names.end(), [&](const auto &pair) {
+                return pair.first == name;
+            });
+            if (it == emit_names.end()) {
+                throw std::runtime_error("unknown emit kind: " + name);
+            }
+            if (std::find(kinds.begin(), kinds.end(), it->second) == kinds.end()) {
+                kinds.push_back(it->second);
+            }
+        }
+        return kinds;
+    }
+
+    bool needs_module(const std::vector<EmitKind> &kinds) {
+        return std::any_of(kinds.begin(), kinds.end(), [](EmitKind kind) {
+            return kind != EmitKind::Bacteria && kind != EmitKind::BacteriaJson && kind != EmitKind::BacteriaBinary;
+        });
+    }
+
+    std::string get_emit_path(const std::string &output, EmitKind kind, bool only_kind) {
+        if (only_kind) return output;
+        fs::path path{output};
+        switch (kind) {
+            case EmitKind::Bacteria:
+                return path.replace_extension(".bact").string();
+            case EmitKind::BacteriaJson:
+                return path.replace_extension(".bact.json").string();
+            case EmitKind::BacteriaBinary:
+                return path.replace_extension(".bact.bin").string();
+            case EmitKind::LLVM:
+                return path.replace_extension(".ll").string();
+            case EmitKind::Bitcode:
+                return path.replace_extension(".bc").string();
+            case EmitKind::Assembly:
+                return path.replace_extension(".s").string();
+            case EmitKind::Object:
+                return path.replace_extension(".o").string();
+        }
+        return output;
+    }
+
+    void emit_bacteria(const std::string &path, EmitKind kind, bacteria::BacteriaNode *program) {
+        std::ofstream out{path, kind == EmitKind::BacteriaBinary ? std::ios::binary : std::ios::out};
+        if (!out) {
+            throw std::runtime_error("could not open file: " + path);
+        }
+        if (kind == EmitKind::BacteriaJson) {
+            util::JsonWriter writer{out};
+            program->write_json(writer);
+        } else if (kind == EmitKind::BacteriaBinary) {
+            util::BinaryTreeWriter writer{out};
+            program->write_json(writer);
+            writer.finish();
+        } else {
+            program->write_textual_representation(out, 0);
+        }
+    }
+
+    void emit_module(const std::string &path, EmitKind kind, llvm::Module &mod, llvm::TargetMachine *machine) {
+        std::error_code errorCode;
+        auto flags = (kind == EmitKind::LLVM || kind == EmitKind::Assembly) ? llvm::sys::fs::OF_Text
+                                                                            : llvm::sys::fs::OF_None;
+        llvm::raw_fd_ostream dest(path, errorCode, flags);
+        if (errorCode) {
+            throw std::runtime_error("could not open file: " + path + ": " + errorCode.message());
+        }
+        switch (kind) {
+            case EmitKind::LLVM:
+                mod.print(dest, nullptr);
+                break;
+            case EmitKind::Bitcode:
+                llvm::WriteBitcodeToFile(mod, dest);
+                break;
+            case EmitKind::Assembly:
+            case EmitKind::Object: {
+                llvm::legacy::PassManager pass;
+                auto fileType = kind == EmitKind::Assembly ? llvm::CodeGenFileType::CGFT_AssemblyFile
+                                                           : llvm::CodeGenFileType::CGFT_ObjectFile;
+                if (machine->addPassesToEmitFile(pass, dest, nullptr, fileType)) {
+                    throw std::runtime_error("the target machine can't emit a file of this type");
+                }
+                pass.run(mod);
+                break;
+            }
+            default:
+                break;
+        }
+        dest.flush();
+    }
+
+    void emit(const std::string &output, const std::vector<EmitKind> &kinds, bacteria::nodes::BacteriaProgram *program,
+              project::GlobalContext *ctx, llvm::TargetMachine *machine) {
+        auto only_kind = kinds.size() == 1;
+        for (auto kind: kinds) {
+            if (!needs_module({kind})) {
+                emit_bacteria(get_emit_path(output, kind, only_kind), kind, program);
+            }
+        }
+        if (!needs_module(kinds)) return;
+        auto mod = program->lower_into_module(ctx);
+        // Code generation rewrites the module it runs on, so the IR gets written out before any of it runs, and every
+        // code generated kind but the last runs on a copy of the module
+        std::vector<EmitKind> generated_kinds;
+        for (auto kind: kinds) {
+            if (kind == EmitKind::Assembly || kind == EmitKind::Object) {
+                generated_kinds.push_back(kind);
+            } else if (needs_module({kind})) {
+                emit_module(get_emit_path(output, kind, only_kind), kind, *mod, machine);
+            }
+        }
+        for (std::size_t i = 0; i < generated_kinds.size(); i++) {
+            auto path = get_emit_path(output, generated_kinds[i], only_kind);
+            if (i + 1 < generated_kinds.size()) {
+                auto copy = llvm::CloneModule(*mod);
+                emit_module(path, generated_kinds[i], *copy, machine);
+            } else {
+                emit_module(path, generated_kinds[i], *mod, machine);
+            }
+        }
+    }
+}
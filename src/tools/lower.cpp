@@ -16,6 +16,8 @@
 #include "project/Project.h"
 #include "project/Machine.h"
 #include "bacteria/nodes/receiver_nodes.h"
+#include "bacteria/BacteriaPass.h"
+#include "tools/emit.h"
 #include <filesystem>
 
 namespace cheese::tools {
@@ -29,11 +31,14 @@ namespace cheese::tools {
         program.add_argument("--library", "-l").help(
                 "The library folders to test translation from").default_value<std::vector<fs::path>>({}).append();
         program.add_argument("file").help("the file to parse");
+        add_machine_arguments(program);
+        add_emit_arguments(program, "bacteria,llvm");
         program.parse_args(args);
         process_common_arguments(program);
         try {
             auto file = program.get("file");
             auto out = program.get("--output");
+            auto kinds = get_emit_kinds(program);
             configuration::die_on_first_error = false;
             std::ifstream t(file);
             std::stringstream buffer;
@@ -49,16 +54,13 @@ namespace cheese::tools {
                     parsed,
                     project::ProjectType::Application
             };
-            auto machine = cheese::project::Machine{};
+            auto machine = get_machine(program);
             auto gc = cheese::memory::garbage_collection::garbage_collector{64};
             auto ctx = gc.gcnew<cheese::project::GlobalContext>(project, gc, machine);
             auto node = curdle::curdle(ctx);
-            std::cout << "Bacteria:\n";
-            std::cout << node->get_textual_representation();
             auto prog = (bacteria::nodes::BacteriaProgram *) node.get();
-            auto mod = prog->lower_into_module(ctx);
-            std::cout << "LLVM:\n";
-            mod->dump();
+            bacteria::run_default_passes(prog);
+            emit(out, kinds, prog, ctx, machine.machine);
             return 0;
         } catch (std::exception &e) {
             std::cout << e.what() << '\n';
@@ -10,6 +10,8 @@
 #include <sstream>
 #include <string_view>
 #include "parser/parser.h"
+#include "util/JsonWriter.h"
+#include "util/BinaryTree.h"
 
 namespace cheese::tools {
 
@@ -17,6 +19,8 @@ namespace cheese::tools {
         auto program = get_parser("parse");
         program.add_argument("--output", "-o").help("The output file for the parsed program in JSON").default_value(
                 "parsed.json").nargs(1);
+        program.add_argument("--format").help("The format to write the parsed program in, json or binary").default_value(
+                "json").nargs(1);
         program.add_argument("file").help("the file to parse");
         program.parse_args(args);
         try {
@@ -30,11 +34,21 @@ namespace cheese::tools {
             std::string sv = buffer.str();
             auto lexed = lexer::lex(sv, file);
             auto parsed = parser::parse(lexed);
-            auto json = parsed->as_json();
-            auto dumped = json.dump(4, ' ');
-            std::ofstream t2(out);
-            t2 << dumped;
-            t2.close();
+            auto format = program.get("--format");
+            if (format == "json") {
+                std::ofstream t2(out);
+                util::JsonWriter writer{t2, 4};
+                parsed->write_json(writer);
+                t2.close();
+            } else if (format == "binary") {
+                std::ofstream t2(out, std::ios::binary);
+                util::BinaryTreeWriter writer{t2};
+                parsed->write_json(writer);
+                writer.finish();
+                t2.close();
+            } else {
+                throw std::runtime_error("unknown output format: " + format);
+            }
             return 0;
         } catch (std::exception &e) {
             std::cout << e.what() << '\n';
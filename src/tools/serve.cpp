@@ -0,0 +1,452 @@
+#include "tools/serve.h"
+#include "tools/build.h"
+#include "configuration.h"
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <map>
+#include <memory>
+#include <tuple>
+#include "project/Machine.h"
+#include "project/ParseCache.h"
+#include "util/BinaryTree.h"
+#include <filesystem>
+
+#ifndef WIN32
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// The protocol is a single line of json each way per connection
+// A request is {"cwd": <the directory of the client>, "args": [<tool>, <arguments>...]}, where the tool is either build,
+// taking the same arguments as the build tool, or shutdown, which stops the server
+// The response is {"status": <exit code>, "cached": <whether nothing had changed>, "diagnostics": <errors and warnings>,
+// "outputs": [<the files written>...]}
+//
+// Finished builds are also kept on disk next to the socket, in the binary tree format, so that a restarted server can
+// still hand back anything that hasn't changed since, parse trees aren't kept there as they can't be rebuilt from it
+namespace cheese::tools {
+    namespace fs = std::filesystem;
+
+    // A build that has already been done, kept around until any of the files it read change
+    struct CachedBuild {
+        // Stamped as they were when they were parsed, so a write during the build is caught by the next request
+        std::map<fs::path, project::ParseCache::Stamp> inputs;
+        std::vector<std::pair<std::string, std::string>> outputs;
+        std::string diagnostics;
+        int status;
+        std::uint64_t last_used; // The request that last asked for this build, the least recently used goes first
+
+        [[nodiscard]] bool up_to_date() const {
+            for (auto &input: inputs) {
+                std::error_code ec;
+                auto stamp = project::ParseCache::Stamp::of(input.first, ec);
+                if (ec || stamp != input.second) return false;
+            }
+            return true;
+        }
+    };
+
+    // Everything kept warm between builds, which is the parse trees of every file read and the results of finished
+    // builds, translated structures and lowered code are not reused, so any edit to an input redoes the whole build
+    // from curdling onwards
+    struct ServerState {
+        project::ParseCache parse_cache;
+        std::map<std::tuple<std::string, std::string, std::string>, std::unique_ptr<curdle::Machine>> machines;
+        // Keyed by the directory of the client followed by its arguments
+        std::map<std::vector<std::string>, CachedBuild> builds;
+        std::uint64_t requests = 0;
+        bool running = true;
+
+        static constexpr std::size_t max_builds = 64; // Each one holds on to the contents of all of its outputs
+
+        void remember(std::vector<std::string> key, CachedBuild build) {
+            builds[std::move(key)] = std::move(build);
+            if (builds.size() > max_builds) {
+                builds.erase(std::min_element(builds.begin(), builds.end(), [](auto &a, auto &b) {
+                    return a.second.last_used < b.second.last_used;
+                }));
+            }
+        }
+
+        curdle::Machine &get_machine(argparse::ArgumentParser &parser) {
+            auto key = std::make_tuple(parser.get("--target"), parser.get("--target-cpu"),
+                                       parser.get("--target-features"));
+            auto &machine = machines[key];
+            if (!machine) {
+                machine = std::make_unique<curdle::Machine>(std::get<0>(key), std::get<1>(key), std::get<2>(key));
+            }
+            return *machine;
+        }
+    };
+
+    static fs::path get_cache_path(const fs::path &socket_path) {
+        return fs::path{socket_path.string() + ".cache"};
+    }
+
+    static void save_builds(const ServerState &state, const fs::path &cache_path) {
+        // Written to the side and then moved over, so a server dying partway through never leaves half a cache behind
+        auto temporary_path = fs::path{cache_path.string() + ".tmp"};
+        {
+            std::ofstream out{temporary_path, std::ios::binary | std::ios::trunc};
+            if (!out) return;
+            util::BinaryTreeWriter writer{out};
+            writer.begin_object();
+            writer.key("builds");
+            writer.begin_array();
+            for (auto &[key, build]: state.builds) {
+                writer.begin_object();
+                writer.key("key");
+                writer.begin_array();
+                for (auto &part: key) writer.value(part);
+                writer.end_array();
+                writer.key("inputs");
+                writer.begin_array();
+                for (auto &[path, stamp]: build.inputs) {
+                    writer.begin_object();
+                    writer.key("path");
+                    writer.value(path.string());
+                    writer.key("write_time");
+                    writer.value(static_cast<std::int64_t>(stamp.write_time.time_since_epoch().count()));
+                    writer.key("size");
+                    writer.value(static_cast<std::uint64_t>(stamp.size));
+                    writer.end_object();
+                }
+                writer.end_array();
+                writer.key("outputs");
+                writer.begin_array();
+                for (auto &[path, contents]: build.outputs) {
+                    writer.begin_object();
+                    writer.key("path");
+                    writer.value(path);
+                    writer.key("contents");
+                    writer.value(contents);
+                    writer.end_object();
+                }
+                writer.end_array();
+                writer.key("diagnostics");
+                writer.value(build.diagnostics);
+                writer.key("status");
+                writer.value(build.status);
+                writer.end_object();
+            }
+            writer.end_array();
+            writer.end_object();
+            writer.finish();
+        }
+        std::error_code ec;
+        fs::rename(temporary_path, cache_path, ec);
+    }
+
+    static void load_builds(ServerState &state, const fs::path &cache_path) {
+        if (!fs::exists(cache_path)) return;
+        try {
+            auto tree = util::BinaryTree::open(cache_path);
+            auto builds = tree.root().get("builds").value();
+            for (std::size_t i = 0; i < builds.size(); i++) {
+                auto build = builds[i];
+                std::vector<std::string> key;
+                auto key_value = build.get("key").value();
+                for (std::size_t j = 0; j < key_value.size(); j++) {
+                    key.emplace_back(key_value[j].as_string());
+                }
+                CachedBuild cached{};
+                auto inputs = build.get("inputs").value();
+                for (std::size_t j = 0; j < inputs.size(); j++) {
+                    auto input = inputs[j];
+                    auto write_time = fs::file_time_type{
+                            fs::file_time_type::duration{input.get("write_time").value().as_int()}};
+                    cached.inputs[fs::path{input.get("path").value().as_string()}] = project::ParseCache::Stamp{
+                            write_time, input.get("size").value().as_uint()};
+                }
+                auto outputs = build.get("outputs").value();
+                for (std::size_t j = 0; j < outputs.size(); j++) {
+                    auto output = outputs[j];
+                    cached.outputs.emplace_back(output.get("path").value().as_string(),
+                                                output.get("contents").value().as_string());
+                }
+                cached.diagnostics = build.get("diagnostics").value().as_string();
+                cached.status = static_cast<int>(build.get("status").value().as_int());
+                cached.last_used = 0;
+                state.builds[std::move(key)] = std::move(cached);
+            }
+        } catch (std::exception &) {
+            // A cache written by another version, or one that got damaged, is as good as no cache at all
+            state.builds.clear();
+        }
+    }
+
+    static nlohmann::json build_response(const CachedBuild &build, bool cached) {
+        auto outputs = nlohmann::json::array();
+        for (auto &output: build.outputs) {
+            outputs.push_back(output.first);
+        }
+        return {
+                {"status",      build.status},
+                {"cached",      cached},
+                {"diagnostics", build.diagnostics},
+                {"outputs",     outputs}
+        };
+    }
+
+    static nlohmann::json serve_build(ServerState &state, std::vector<std::string> args, const std::string &cwd,
+                                      const fs::path &cache_path) {
+        auto key = args;
+        key.insert(key.begin(), cwd);
+        auto now = ++state.requests;
+        if (auto it = state.builds.find(key); it != state.builds.end()) {
+            if (it->second.up_to_date()) {
+                // Nothing it read has changed, so all that is left is putting the outputs back in case they were removed
+                it->second.last_used = now;
+                for (auto &output: it->second.outputs) {
+                    std::ofstream out{output.first, std::ios::binary};
+                    out << output.second;
+                }
+                return build_response(it->second, true);
+            }
+            state.builds.erase(it);
+        }
+        // Nothing refers to the cached trees in between builds, so this is the one place they can all be dropped
+        state.parse_cache.start_generation();
+        CachedBuild build{};
+        build.last_used = now;
+        auto previous_handler = configuration::error_output_handler;
+        configuration::error_output_handler = [&build](std::string message) {
+            build.diagnostics += message;
+        };
+        try {
+            // The default --help and --version would exit the whole server, so they are answered here instead
+            auto program = get_parser("build", argparse::default_arguments::none);
+            add_build_arguments(program);
+            if (std::find(args.begin(), args.end(), "--help") != args.end() ||
+                std::find(args.begin(), args.end(), "-h") != args.end()) {
+                configuration::error_output_handler = previous_handler;
+                build.diagnostics = program.help().str();
+                build.status = 0;
+                return build_response(build, false);
+            }
+            if (std::find(args.begin(), args.end(), "--version") != args.end() ||
+                std::find(args.begin(), args.end(), "-v") != args.end()) {
+                configuration::error_output_handler = previous_handler;
+                build.diagnostics = std::string{version} + '\n';
+                build.status = 0;
+                return build_response(build, false);
+            }
+            program.parse_args(args);
+            process_common_arguments(program);
+            auto record = run_build(program, state.get_machine(program), &state.parse_cache);
+            for (auto &input: record.inputs) {
+                build.inputs[input] = state.parse_cache.get_stamp(input);
+            }
+            for (auto &path: record.outputs) {
+                std::ifstream t(path, std::ios::binary);
+                std::stringstream buffer;
+                buffer << t.rdbuf();
+                build.outputs.emplace_back(path, buffer.str());
+            }
+            build.status = 0;
+            configuration::error_output_handler = previous_handler;
+            state.remember(key, build);
+            save_builds(state, cache_path);
+        } catch (std::exception &e) {
+            configuration::error_output_handler = previous_handler;
+            build.diagnostics += e.what();
+            build.diagnostics += '\n';
+            build.status = 1;
+        }
+        return build_response(build, false);
+    }
+
+    static nlohmann::json serve_request(ServerState &state, const nlohmann::json &request,
+                                        const fs::path &cache_path) {
+        if (!request.is_object() || !request.contains("args") || !request["args"].is_array() ||
+            request["args"].empty()) {
+            return {{"status", 1}, {"diagnostics", "malformed request\n"}};
+        }
+        auto args = request["args"].get<std::vector<std::string>>();
+        if (args[0] == "shutdown") {
+            state.running = false;
+            return {{"status", 0}};
+        }
+        if (args[0] != "build") {
+            return {{"status", 1}, {"diagnostics", "the server can only build, not " + args[0] + "\n"}};
+        }
+        // The working directory belongs to the whole process, so it is put back once the build is done
+        auto previous_cwd = fs::current_path();
+        auto cwd = request.value("cwd", previous_cwd.string());
+        fs::current_path(cwd);
+        try {
+            auto response = serve_build(state, args, cwd, cache_path);
+            fs::current_path(previous_cwd);
+            return response;
+        } catch (...) {
+            fs::current_path(previous_cwd);
+            throw;
+        }
+    }
+
+#ifndef WIN32
+
+    constexpr time_t request_timeout_seconds = 5; // How long a client gets to send its whole request
+    constexpr std::size_t max_request_size = 1 << 20;
+
+    static sockaddr_un get_address(const fs::path &socket_path) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        auto path = socket_path.string();
+        if (path.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("socket path too long: " + path);
+        }
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        return address;
+    }
+
+    // Each side sends exactly one line, so anything after the newline can be thrown away
+    static std::string read_line(int fd, std::size_t limit) {
+        std::string line;
+        char buffer[4096];
+        while (true) {
+            auto count = ::read(fd, buffer, sizeof(buffer));
+            if (count < 0 && errno == EINTR) continue;
+            if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                throw std::runtime_error("timed out waiting for a request");
+            }
+            if (count <= 0) return line;
+            auto newline = std::find(buffer, buffer + count, '\n');
+            line.append(buffer, newline);
+            if (newline != buffer + count) return line;
+            if (line.size() > limit) throw std::runtime_error("request too long");
+        }
+    }
+
+    static void write_all(int fd, const std::string &data) {
+        std::size_t written = 0;
+        while (written < data.size()) {
+            auto result = ::write(fd, data.data() + written, data.size() - written);
+            if (result <= 0) return;
+            written += result;
+        }
+    }
+
+    // Only a socket left behind by a server that is gone gets replaced, never a file that isn't a socket, nor the
+    // socket of a server that is still answering
+    static void remove_stale_socket(const sockaddr_un &address, const fs::path &socket_path) {
+        struct stat info{};
+        if (::lstat(address.sun_path, &info) != 0) return;
+        if (!S_ISSOCK(info.st_mode)) {
+            throw std::runtime_error("refusing to replace " + socket_path.string() + ", as it is not a socket");
+        }
+        auto probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (probe < 0) throw std::runtime_error("could not create socket");
+        auto live = connect(probe, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0;
+        ::close(probe);
+        if (live) throw std::runtime_error("a server is already running on " + socket_path.string());
+        ::unlink(address.sun_path);
+    }
+
+    int run_server(const fs::path &socket_path) {
+        // A client going away before reading its response shouldn't take the server down with it
+        std::signal(SIGPIPE, SIG_IGN);
+        auto address = get_address(socket_path);
+        remove_stale_socket(address, socket_path);
+        auto server = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (server < 0) throw std::runtime_error("could not create socket");
+        if (bind(server, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(server, 8) != 0) {
+            ::close(server);
+            throw std::runtime_error("could not listen on socket: " + socket_path.string());
+        }
+        std::cout << "serving on " << socket_path.string() << '\n';
+        ServerState state{};
+        auto cache_path = get_cache_path(socket_path);
+        load_builds(state, cache_path);
+        while (state.running) {
+            auto client = accept(server, nullptr, nullptr);
+            if (client < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            // A client that connects and then never finishes its request would otherwise hang the server for good
+            timeval timeout{request_timeout_seconds, 0};
+            setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+            nlohmann::json response;
+            try {
+                response = serve_request(state, nlohmann::json::parse(read_line(client, max_request_size)),
+                                         cache_path);
+            } catch (std::exception &e) {
+                response = {{"status", 1}, {"diagnostics", std::string{e.what()} + "\n"}};
+            }
+            write_all(client, response.dump() + "\n");
+            ::close(client);
+        }
+        ::close(server);
+        ::unlink(address.sun_path);
+        return 0;
+    }
+
+    nlohmann::json send_request(const fs::path &socket_path, const std::vector<std::string> &args) {
+        auto address = get_address(socket_path);
+        auto client = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (client < 0) throw std::runtime_error("could not create socket");
+        if (connect(client, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+            ::close(client);
+            throw std::runtime_error("could not connect to a server on: " + socket_path.string());
+        }
+        nlohmann::json request = {
+                {"cwd",  fs::current_path().string()},
+                {"args", args}
+        };
+        write_all(client, request.dump() + "\n");
+        std::string line;
+        try {
+            // Builds take as long as they take, so there is no timeout on this end
+            line = read_line(client, std::numeric_limits<std::size_t>::max());
+        } catch (...) {
+            ::close(client);
+            throw;
+        }
+        ::close(client);
+        return nlohmann::json::parse(line);
+    }
+
+    static int run_client(const fs::path &socket_path, const std::vector<std::string> &args) {
+        auto response = send_request(socket_path, args);
+        std::cout << response.value("diagnostics", "");
+        return response.value("status", 1);
+    }
+
+#endif
+
+    int serve(std::vector<std::string> args) {
+        auto program = get_parser("serve");
+        program.add_argument("--socket", "-s").help(
+                "The UNIX socket the server listens on").default_value(
+                "cheese.sock").nargs(1);
+        program.add_argument("--send").help(
+                "Sends the rest of the arguments (e.g. build main.chs -o main.o) to a running server instead of starting one").remaining();
+        program.parse_args(args);
+        process_common_arguments(program);
+        try {
+#ifndef WIN32
+            auto socket_path = fs::absolute(program.get("--socket"));
+            if (program.is_used("--send")) {
+                return run_client(socket_path, program.get<std::vector<std::string>>("--send"));
+            }
+            return run_server(socket_path);
+#else
+            throw std::runtime_error("the build server needs UNIX sockets, which aren't supported on this platform");
+#endif
+        } catch (std::exception &e) {
+            std::cout << e.what() << '\n';
+            return 1;
+        }
+    }
+}
@@ -6,6 +6,7 @@
 #include "tools/parse.h"
 #include "tools/lower.h"
 #include "tools/build.h"
+#include "tools/serve.h"
 #include "configuration.h"
 #include <iostream>
 #include "lexer/lexer.h"
@@ -24,23 +25,73 @@ namespace cheese::tools {
             {"parse",     parse},
             {"translate", translate},
             {"lower",     lower},
-            {"build",     build}
+            {"build",     build},
+            {"serve",     serve}
     };
 
-    argparse::ArgumentParser get_parser(std::string name) {
-        auto parser = argparse::ArgumentParser(name, version);
+    argparse::ArgumentParser get_parser(std::string name, argparse::default_arguments default_arguments) {
+        auto parser = argparse::ArgumentParser(name, version, default_arguments);
         parser.add_argument("--no-vterm")
                 .help("disables virtual terminal escapes for errors and the like")
                 .default_value(false)
                 .implicit_value(true)
                 .nargs(0);
+        parser.add_argument("--release")
+                .help("compiles in release mode, which drops debugging aids such as value names from the output")
+                .default_value(false)
+                .implicit_value(true)
+                .nargs(0);
+        parser.add_argument("--no-ssa")
+                .help("keeps every mutable local on the stack instead of in registers when lowering")
+                .default_value(false)
+                .implicit_value(true)
+                .nargs(0);
+        parser.add_argument("--bounds-checks")
+                .help("when indices into arrays and slices are checked at runtime: always, debug (only in debug builds), or never")
+                .default_value(std::string{"debug"})
+                .nargs(1);
         return parser;
     }
 
     void process_common_arguments(argparse::ArgumentParser &parser) {
         cheese::configuration::use_escape_sequences = !parser.get<bool>("--no-vterm");
+        cheese::configuration::release_mode = parser.get<bool>("--release") ? configuration::ReleaseMode::Release
+                                                                             : configuration::ReleaseMode::Debug;
+        cheese::configuration::ssa_lowering = !parser.get<bool>("--no-ssa");
+        if (auto bounds_checks = parser.get("--bounds-checks"); bounds_checks == "always") {
+            cheese::configuration::bounds_checks = configuration::BoundsChecks::Always;
+        } else if (bounds_checks == "never") {
+            cheese::configuration::bounds_checks = configuration::BoundsChecks::Never;
+        } else if (bounds_checks == "debug") {
+            cheese::configuration::bounds_checks = configuration::BoundsChecks::Debug;
+        } else {
+            throw std::runtime_error("unknown bounds check mode: " + bounds_checks);
+        }
         if (configuration::use_escape_sequences) {
             configuration::setup_escape_sequences();
         }
     }
-}
\ No newline at end of file
+
+    void add_machine_arguments(argparse::ArgumentParser &parser) {
+        parser.add_argument("--target")
+                .help("the target triple to generate code for")
+                .default_value(llvm::sys::getDefaultTargetTriple())
+                .nargs(1);
+        parser.add_argument("--target-cpu")
+                .help("the cpu to generate code for, or native for the cpu being compiled on")
+                .default_value(std::string{"generic"})
+                .nargs(1);
+        parser.add_argument("--target-features")
+                .help("the cpu features to enable or disable (e.g. +avx2,-avx512f), or native for every feature of the cpu being compiled on")
+                .default_value(std::string{})
+                .nargs(1);
+    }
+
+    curdle::Machine get_machine(argparse::ArgumentParser &parser) {
+        return curdle::Machine{
+                parser.get("--target"),
+                parser.get("--target-cpu"),
+                parser.get("--target-features")
+        };
+    }
+}
@@ -12,6 +12,7 @@
 #include "curdle/curdle.h"
 #include "project/Project.h"
 #include "project/Machine.h"
+#include "util/BinaryTree.h"
 #include <filesystem>
 
 namespace cheese::tools {
@@ -24,7 +25,11 @@ namespace cheese::tools {
                 "translated.bact").nargs(1);
         program.add_argument("--library", "-l").help(
                 "The library folders to test translation from").default_value<std::vector<fs::path>>({}).append();
+        program.add_argument("--format").help(
+                "text to print the translation, or binary to write it to the output file").default_value(
+                "text").nargs(1);
         program.add_argument("file").help("the file to parse");
+        add_machine_arguments(program);
         program.parse_args(args);
         try {
             auto file = program.get("file");
@@ -44,11 +49,22 @@ namespace cheese::tools {
                     parsed,
                     project::ProjectType::Application
             };
-            auto machine = cheese::project::Machine{};
+            auto machine = get_machine(program);
             auto gc = cheese::memory::garbage_collection::garbage_collector{64};
             auto ctx = gc.gcnew<cheese::project::GlobalContext>(project, gc, machine);
             auto node = curdle::curdle(ctx);
-            std::cout << node->get_textual_representation();
+            auto format = program.get("--format");
+            if (format == "text") {
+                node->write_textual_representation(std::cout, 0);
+            } else if (format == "binary") {
+                std::ofstream t2(out, std::ios::binary);
+                util::BinaryTreeWriter writer{t2};
+                node->write_json(writer);
+                writer.finish();
+                t2.close();
+            } else {
+                throw std::runtime_error("unknown output format: " + format);
+            }
             return 0;
         } catch (std::exception &e) {
             std::cout << e.what() << '\n';
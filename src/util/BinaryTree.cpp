@@ -0,0 +1,376 @@
+#include "util/BinaryTree.h"
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cheese::util {
+    static constexpr char binary_tree_magic[4] = {'C', 'H', 'B', 'T'};
+    static constexpr std::uint64_t header_size = 8;
+    static constexpr std::uint64_t slot_size = 16;
+    static constexpr std::uint64_t footer_size = slot_size + 16;
+
+    BinaryTreeWriter::BinaryTreeWriter(std::ostream &out) : out(out) {
+        out.write(binary_tree_magic, 4);
+        offset += 4;
+        write_u32(binary_tree_version);
+    }
+
+    void BinaryTreeWriter::begin_object() {
+        begin_block(BinaryTag::Object, no_index);
+    }
+
+    void BinaryTreeWriter::end_object() {
+        end_block();
+    }
+
+    void BinaryTreeWriter::begin_node(std::string_view kind) {
+        begin_block(BinaryTag::Node, intern(kind));
+    }
+
+    void BinaryTreeWriter::begin_array() {
+        begin_block(BinaryTag::Array, no_index);
+    }
+
+    void BinaryTreeWriter::end_array() {
+        end_block();
+    }
+
+    void BinaryTreeWriter::key(std::string_view name) {
+        pending_key = intern(name);
+    }
+
+    void BinaryTreeWriter::value(std::string_view v) {
+        add_slot(BinaryTag::String, intern(v));
+    }
+
+    void BinaryTreeWriter::value(bool v) {
+        add_slot(v ? BinaryTag::True : BinaryTag::False, 0);
+    }
+
+    void BinaryTreeWriter::value(std::int64_t v) {
+        add_slot(BinaryTag::Int, static_cast<std::uint64_t>(v));
+    }
+
+    void BinaryTreeWriter::value(std::uint64_t v) {
+        add_slot(BinaryTag::UInt, v);
+    }
+
+    void BinaryTreeWriter::value(double v) {
+        add_slot(BinaryTag::Double, std::bit_cast<std::uint64_t>(v));
+    }
+
+    void BinaryTreeWriter::null() {
+        add_slot(BinaryTag::Null, 0);
+    }
+
+    void BinaryTreeWriter::finish() {
+        auto table = offset;
+        write_u32(static_cast<std::uint32_t>(strings.size()));
+        write_u32(0);
+        auto string_offset = offset + 8 * strings.size();
+        for (auto &string: strings) {
+            write_u64(string_offset);
+            string_offset += 4 + string.size();
+        }
+        for (auto &string: strings) {
+            write_u32(static_cast<std::uint32_t>(string.size()));
+            out.write(string.data(), static_cast<std::streamsize>(string.size()));
+            offset += string.size();
+        }
+        write_slot(root);
+        write_u64(table);
+        write_u32(binary_tree_version);
+        out.write(binary_tree_magic, 4);
+        offset += 4;
+        out.flush();
+    }
+
+    std::uint32_t BinaryTreeWriter::intern(std::string_view string) {
+        auto [it, inserted] = string_indices.try_emplace(std::string{string},
+                                                          static_cast<std::uint32_t>(strings.size()));
+        if (inserted) strings.emplace_back(string);
+        return it->second;
+    }
+
+    void BinaryTreeWriter::add_slot(BinaryTag tag, std::uint64_t payload) {
+        BinarySlot slot{pending_key, tag, payload};
+        pending_key = no_index;
+        if (open_blocks.empty()) {
+            root = slot;
+        } else {
+            open_blocks.back().slots.push_back(slot);
+        }
+    }
+
+    void BinaryTreeWriter::begin_block(BinaryTag tag, std::uint32_t kind) {
+        open_blocks.push_back(OpenBlock{tag, pending_key, kind, {}});
+        pending_key = no_index;
+    }
+
+    void BinaryTreeWriter::end_block() {
+        auto block = std::move(open_blocks.back());
+        open_blocks.pop_back();
+        auto at = offset;
+        write_u32(static_cast<std::uint32_t>(block.slots.size()));
+        write_u32(block.kind);
+        for (auto &slot: block.slots) {
+            write_slot(slot);
+        }
+        pending_key = block.key;
+        add_slot(block.tag, at);
+    }
+
+    void BinaryTreeWriter::write_u32(std::uint32_t v) {
+        char bytes[4];
+        for (int i = 0; i < 4; i++) {
+            bytes[i] = static_cast<char>(v >> (i * 8));
+        }
+        out.write(bytes, 4);
+        offset += 4;
+    }
+
+    void BinaryTreeWriter::write_u64(std::uint64_t v) {
+        char bytes[8];
+        for (int i = 0; i < 8; i++) {
+            bytes[i] = static_cast<char>(v >> (i * 8));
+        }
+        out.write(bytes, 8);
+        offset += 8;
+    }
+
+    void BinaryTreeWriter::write_slot(const BinarySlot &slot) {
+        write_u32(slot.key);
+        write_u32(static_cast<std::uint32_t>(slot.tag));
+        write_u64(slot.payload);
+    }
+
+    BinaryTree BinaryTree::open(const std::filesystem::path &path) {
+#ifdef WIN32
+        std::ifstream file{path, std::ios::binary};
+        if (!file) throw std::runtime_error("could not open file: " + path.string());
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return BinaryTree{buffer.str()};
+#else
+        auto fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("could not open file: " + path.string());
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            throw std::runtime_error("could not read file: " + path.string());
+        }
+        auto size = static_cast<std::size_t>(st.st_size);
+        auto mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) throw std::runtime_error("could not map file: " + path.string());
+        std::shared_ptr<const char> data{static_cast<const char *>(mapped), [size](const char *p) {
+            munmap(const_cast<char *>(p), size);
+        }};
+        return BinaryTree{std::move(data), size};
+#endif
+    }
+
+    BinaryTree::BinaryTree(std::string buffer) : BinaryTree(nullptr, 0) {
+        auto held = std::make_shared<std::string>(std::move(buffer));
+        size = held->size();
+        data = std::shared_ptr<const char>{held, held->data()};
+        validate();
+    }
+
+    BinaryTree::BinaryTree(std::shared_ptr<const char> data, std::size_t size) : data(std::move(data)), size(size),
+                                                                                 string_table(0), string_count(0),
+                                                                                 strings_begin(0), strings_end(0),
+                                                                                 root_slot() {
+        if (this->data) validate();
+    }
+
+    void BinaryTree::validate() {
+        if (size < header_size + footer_size + 8 || std::memcmp(data.get(), binary_tree_magic, 4) != 0 ||
+            std::memcmp(data.get() + size - 4, binary_tree_magic, 4) != 0) {
+            throw std::runtime_error("not a binary tree");
+        }
+        auto version = read_u32(4);
+        if (version != binary_tree_version || read_u32(size - 8) != binary_tree_version) {
+            throw std::runtime_error("unsupported binary tree version: " + std::to_string(version));
+        }
+        auto footer = size - footer_size;
+        root_slot = read_slot(footer);
+        string_table = read_u64(footer + slot_size);
+        // Everything is compared as a remaining length, so that offsets near the top of the range can't wrap around
+        if (string_table < header_size || string_table > footer - 8) {
+            throw std::runtime_error("corrupt binary tree");
+        }
+        string_count = read_u32(string_table);
+        if (string_count > (footer - string_table - 8) / 8) {
+            throw std::runtime_error("corrupt binary tree");
+        }
+        strings_begin = string_table + 8 + 8 * static_cast<std::uint64_t>(string_count);
+        strings_end = footer;
+    }
+
+    BinaryTree::Value BinaryTree::root() const {
+        return Value{this, root_slot};
+    }
+
+    std::string_view BinaryTree::string(std::uint32_t index) const {
+        if (index >= string_count) throw std::runtime_error("corrupt binary tree");
+        auto at = read_u64(string_table + 8 + 8 * static_cast<std::uint64_t>(index));
+        if (at < strings_begin || at > strings_end - 4) throw std::runtime_error("corrupt binary tree");
+        auto length = read_u32(at);
+        if (length > strings_end - at - 4) throw std::runtime_error("corrupt binary tree");
+        return {data.get() + at + 4, length};
+    }
+
+    std::uint32_t BinaryTree::read_u32(std::uint64_t at) const {
+        if (size < 4 || at > size - 4) throw std::runtime_error("corrupt binary tree");
+        auto bytes = reinterpret_cast<const unsigned char *>(data.get() + at);
+        std::uint32_t v = 0;
+        for (int i = 0; i < 4; i++) {
+            v |= static_cast<std::uint32_t>(bytes[i]) << (i * 8);
+        }
+        return v;
+    }
+
+    std::uint64_t BinaryTree::read_u64(std::uint64_t at) const {
+        if (size < 8 || at > size - 8) throw std::runtime_error("corrupt binary tree");
+        auto bytes = reinterpret_cast<const unsigned char *>(data.get() + at);
+        std::uint64_t v = 0;
+        for (int i = 0; i < 8; i++) {
+            v |= static_cast<std::uint64_t>(bytes[i]) << (i * 8);
+        }
+        return v;
+    }
+
+    BinarySlot BinaryTree::read_slot(std::uint64_t at) const {
+        auto tag = read_u32(at + 4) & 0xFF;
+        if (tag > static_cast<std::uint32_t>(BinaryTag::Node)) throw std::runtime_error("corrupt binary tree");
+        return BinarySlot{read_u32(at), static_cast<BinaryTag>(tag), read_u64(at + 8)};
+    }
+
+    bool BinaryTree::Value::as_bool() const {
+        if (!is_bool()) throw std::runtime_error("binary tree value is not a bool");
+        return slot.tag == BinaryTag::True;
+    }
+
+    std::int64_t BinaryTree::Value::as_int() const {
+        if (!is_integer()) throw std::runtime_error("binary tree value is not an integer");
+        return static_cast<std::int64_t>(slot.payload);
+    }
+
+    std::uint64_t BinaryTree::Value::as_uint() const {
+        if (!is_integer()) throw std::runtime_error("binary tree value is not an integer");
+        return slot.payload;
+    }
+
+    double BinaryTree::Value::as_double() const {
+        switch (slot.tag) {
+            case BinaryTag::Double:
+                return std::bit_cast<double>(slot.payload);
+            case BinaryTag::Int:
+                return static_cast<double>(static_cast<std::int64_t>(slot.payload));
+            case BinaryTag::UInt:
+                return static_cast<double>(slot.payload);
+            default:
+                throw std::runtime_error("binary tree value is not a number");
+        }
+    }
+
+    std::string_view BinaryTree::Value::as_string() const {
+        if (!is_string()) throw std::runtime_error("binary tree value is not a string");
+        return tree->string(static_cast<std::uint32_t>(slot.payload));
+    }
+
+    std::string_view BinaryTree::Value::kind() const {
+        if (slot.tag == BinaryTag::String) return as_string();
+        if (slot.tag != BinaryTag::Node) return {};
+        return tree->string(tree->read_u32(block() + 4));
+    }
+
+    std::size_t BinaryTree::Value::size() const {
+        if (!is_array() && !is_object()) return 0;
+        return tree->read_u32(block());
+    }
+
+    BinaryTree::Value BinaryTree::Value::operator[](std::size_t index) const {
+        if (index >= size()) throw std::out_of_range("binary tree index out of range");
+        auto at = block();
+        // The slots of a block have to end before the string table does
+        if (index >= (tree->string_table - at - 8) / slot_size) throw std::runtime_error("corrupt binary tree");
+        auto child = tree->read_slot(at + 8 + index * slot_size);
+        // Blocks are written after the blocks of their children, holding to that is what keeps a walk from looping
+        if ((child.tag == BinaryTag::Array || child.tag == BinaryTag::Object || child.tag == BinaryTag::Node) &&
+            child.payload >= at) {
+            throw std::runtime_error("corrupt binary tree");
+        }
+        return Value{tree, child};
+    }
+
+    std::string_view BinaryTree::Value::key(std::size_t index) const {
+        if (!is_object()) throw std::runtime_error("binary tree value is not an object");
+        return tree->string((*this)[index].slot.key);
+    }
+
+    std::optional<BinaryTree::Value> BinaryTree::Value::get(std::string_view name) const {
+        if (!is_object()) return std::nullopt;
+        auto count = size();
+        for (std::size_t i = 0; i < count; i++) {
+            auto member = (*this)[i];
+            if (tree->string(member.slot.key) == name) return member;
+        }
+        return std::nullopt;
+    }
+
+    nlohmann::json BinaryTree::Value::to_json() const {
+        switch (slot.tag) {
+            case BinaryTag::Null:
+                return nullptr;
+            case BinaryTag::False:
+                return false;
+            case BinaryTag::True:
+                return true;
+            case BinaryTag::Int:
+                return as_int();
+            case BinaryTag::UInt:
+                return as_uint();
+            case BinaryTag::Double:
+                return as_double();
+            case BinaryTag::String:
+                return std::string{as_string()};
+            case BinaryTag::Array: {
+                auto result = nlohmann::json::array();
+                auto count = size();
+                for (std::size_t i = 0; i < count; i++) {
+                    result.push_back((*this)[i].to_json());
+                }
+                return result;
+            }
+            case BinaryTag::Object:
+            case BinaryTag::Node: {
+                auto result = nlohmann::json::object();
+                if (slot.tag == BinaryTag::Node) result["type"] = std::string{kind()};
+                auto count = size();
+                for (std::size_t i = 0; i < count; i++) {
+                    result[std::string{key(i)}] = (*this)[i].to_json();
+                }
+                return result;
+            }
+        }
+        return nullptr;
+    }
+
+    std::uint64_t BinaryTree::Value::block() const {
+        if (slot.payload < header_size || slot.payload > tree->string_table - 8) {
+            throw std::runtime_error("corrupt binary tree");
+        }
+        return slot.payload;
+    }
+}
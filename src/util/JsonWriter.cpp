@@ -0,0 +1,128 @@
+#include "util/JsonWriter.h"
+
+namespace cheese::util {
+    void JsonWriter::begin_object() {
+        begin_value();
+        out << '{';
+        written.push_back(false);
+    }
+
+    void JsonWriter::end_object() {
+        auto any = written.back();
+        written.pop_back();
+        if (any) new_line();
+        out << '}';
+    }
+
+    void JsonWriter::begin_array() {
+        begin_value();
+        out << '[';
+        written.push_back(false);
+    }
+
+    void JsonWriter::end_array() {
+        auto any = written.back();
+        written.pop_back();
+        if (any) new_line();
+        out << ']';
+    }
+
+    void JsonWriter::key(std::string_view name) {
+        begin_value();
+        write_string(name);
+        out << (indent >= 0 ? ": " : ":");
+        after_key = true;
+    }
+
+    void JsonWriter::value(std::string_view v) {
+        begin_value();
+        write_string(v);
+    }
+
+    void JsonWriter::value(bool v) {
+        begin_value();
+        out << (v ? "true" : "false");
+    }
+
+    void JsonWriter::value(std::int64_t v) {
+        begin_value();
+        out << v;
+    }
+
+    void JsonWriter::value(std::uint64_t v) {
+        begin_value();
+        out << v;
+    }
+
+    void JsonWriter::value(double v) {
+        // Floating point formatting is left to nlohmann so that it round trips the same way
+        value(nlohmann::json(v));
+    }
+
+    void JsonWriter::value(const nlohmann::json &v) {
+        begin_value();
+        out << v.dump();
+    }
+
+    void JsonWriter::null() {
+        begin_value();
+        out << "null";
+    }
+
+    void JsonWriter::begin_value() {
+        if (after_key) {
+            after_key = false;
+            return;
+        }
+        if (written.empty()) return;
+        if (written.back()) out << ',';
+        written.back() = true;
+        new_line();
+    }
+
+    void JsonWriter::new_line() {
+        if (indent < 0) return;
+        out << '\n';
+        for (size_t i = 0; i < written.size() * indent; i++) {
+            out << ' ';
+        }
+    }
+
+    void JsonWriter::write_string(std::string_view v) {
+        static const char *hex = "0123456789abcdef";
+        out << '"';
+        for (auto c: v) {
+            switch (c) {
+                case '"':
+                    out << "\\\"";
+                    break;
+                case '\\':
+                    out << "\\\\";
+                    break;
+                case '\b':
+                    out << "\\b";
+                    break;
+                case '\f':
+                    out << "\\f";
+                    break;
+                case '\n':
+                    out << "\\n";
+                    break;
+                case '\r':
+                    out << "\\r";
+                    break;
+                case '\t':
+                    out << "\\t";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        out << "\\u00" << hex[(c >> 4) & 0xF] << hex[c & 0xF];
+                    } else {
+                        out << c;
+                    }
+                    break;
+            }
+        }
+        out << '"';
+    }
+}
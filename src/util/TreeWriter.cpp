@@ -0,0 +1,44 @@
+#include "util/TreeWriter.h"
+
+namespace cheese::util {
+    void TreeWriter::value(const nlohmann::json &v) {
+        switch (v.type()) {
+            case nlohmann::json::value_t::null:
+                null();
+                break;
+            case nlohmann::json::value_t::object:
+                begin_object();
+                for (auto &kv: v.items()) {
+                    key(kv.key());
+                    value(kv.value());
+                }
+                end_object();
+                break;
+            case nlohmann::json::value_t::array:
+                begin_array();
+                for (auto &element: v) {
+                    value(element);
+                }
+                end_array();
+                break;
+            case nlohmann::json::value_t::string:
+                value(std::string_view{v.get_ref<const std::string &>()});
+                break;
+            case nlohmann::json::value_t::boolean:
+                value(v.get<bool>());
+                break;
+            case nlohmann::json::value_t::number_integer:
+                value(v.get<std::int64_t>());
+                break;
+            case nlohmann::json::value_t::number_unsigned:
+                value(v.get<std::uint64_t>());
+                break;
+            case nlohmann::json::value_t::number_float:
+                value(v.get<double>());
+                break;
+            default:
+                null();
+                break;
+        }
+    }
+}